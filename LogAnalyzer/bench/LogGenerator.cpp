@@ -0,0 +1,250 @@
+/*
+ * LogGenerator.cpp
+ * LogGenerator 类的实现
+ */
+
+#include "LogGenerator.h"
+#include <cstdio>
+#include <stdexcept>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        // 消息开头的短语，决定消息的模板
+        const char* const PHRASES[] = {
+            "user logged in from",
+            "request completed in",
+            "cache miss for key",
+            "connection reset by peer",
+            "query returned rows",
+            "retrying upstream call attempt",
+            "session expired for account",
+            "disk usage above threshold on volume",
+            "failed to acquire lock on resource",
+            "scheduled job finished with status",
+            "received heartbeat from node",
+            "configuration reloaded from"
+        };
+        constexpr size_t PHRASE_COUNT = sizeof(PHRASES) / sizeof(PHRASES[0]);
+
+        // 填充消息用的词
+        const char* const WORDS[] = {
+            "alpha", "bravo", "cluster", "delta", "edge", "frame", "gateway", "handler",
+            "index", "journal", "kernel", "lease", "mirror", "node", "offset", "partition",
+            "queue", "replica", "shard", "token", "upstream", "volume", "worker", "zone"
+        };
+        constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+        const char* const MONTHS[] = {
+            "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+        };
+
+        // 写入固定宽度的十进制数
+        void writeDigits(char* out, unsigned value, int width) {
+            for (int i = width - 1; i >= 0; --i) {
+                out[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        }
+
+        // 1970-01-01 起的天数转为公历日期（days-from-civil 的逆运算）
+        void civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day) {
+            days += 719468;
+            const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+            const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+            const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+            const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+            const unsigned shifted = (5 * dayOfYear + 2) / 153;
+            day = dayOfYear - (153 * shifted + 2) / 5 + 1;
+            month = shifted < 10 ? shifted + 3 : shifted - 9;
+            year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2 ? 1 : 0);
+        }
+
+    } // namespace
+
+    // 构造函数
+    LogGenerator::LogGenerator(const LogGeneratorOptions& options)
+        : options_(options), state_(options.seed), weightTotal_(0), millis_(0), lines_(0), levelCounts_{},
+          cachedSecond_(-1), dateTime_{}, syslogTime_{}, syslogLength_(0) {
+        for (unsigned weight : options.levelWeights) {
+            weightTotal_ += weight;
+        }
+        if (weightTotal_ == 0) {
+            throw std::invalid_argument("级别权重不能全为零");
+        }
+        if (options.minMessageLength == 0 || options.minMessageLength > options.maxMessageLength) {
+            throw std::invalid_argument("消息长度范围无效：最小长度必须为正数且不大于最大长度");
+        }
+        if (options.sourceCount == 0) {
+            throw std::invalid_argument("来源数量必须为正数");
+        }
+    }
+
+    // splitmix64
+    std::uint64_t LogGenerator::next() {
+        std::uint64_t value = (state_ += 0x9e3779b97f4a7c15ull);
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    // 乘法映射代替取模，偏差可以忽略且结果与平台无关
+    std::uint64_t LogGenerator::below(std::uint64_t bound) {
+        return static_cast<std::uint64_t>((static_cast<unsigned __int128>(next()) * bound) >> 64);
+    }
+
+    // 每秒只做一次日期换算
+    void LogGenerator::updateTime() {
+        const std::int64_t second = options_.startSeconds + millis_ / 1000;
+        if (second == cachedSecond_) {
+            return;
+        }
+        cachedSecond_ = second;
+
+        std::int64_t days = second >= 0 ? second / 86400 : (second - 86399) / 86400;
+        unsigned secondOfDay = static_cast<unsigned>(second - days * 86400);
+        std::int64_t year;
+        unsigned month, day;
+        civilFromDays(days, year, month, day);
+        unsigned hour = secondOfDay / 3600, minute = secondOfDay / 60 % 60, sec = secondOfDay % 60;
+
+        // YYYY-MM-DD HH:MM:SS
+        writeDigits(dateTime_, static_cast<unsigned>(year), 4);
+        dateTime_[4] = '-';
+        writeDigits(dateTime_ + 5, month, 2);
+        dateTime_[7] = '-';
+        writeDigits(dateTime_ + 8, day, 2);
+        dateTime_[10] = ' ';
+        writeDigits(dateTime_ + 11, hour, 2);
+        dateTime_[13] = ':';
+        writeDigits(dateTime_ + 14, minute, 2);
+        dateTime_[16] = ':';
+        writeDigits(dateTime_ + 17, sec, 2);
+
+        // Mon D HH:MM:SS（日不补零，与 \d{1,2} 前的单个空格一致）
+        syslogLength_ = static_cast<size_t>(std::snprintf(syslogTime_, sizeof(syslogTime_), "%s %u %.8s",
+                                                          MONTHS[month - 1], day, dateTime_ + 11));
+    }
+
+    // 短语 + 词和数字，截断到抽取的长度
+    void LogGenerator::appendMessage(std::string& out) {
+        const size_t length = options_.minMessageLength +
+                              below(options_.maxMessageLength - options_.minMessageLength + 1);
+        const size_t start = out.size();
+
+        // 平方偏斜：靠前的短语更常见
+        std::uint64_t pick = below(PHRASE_COUNT * PHRASE_COUNT);
+        size_t phrase = 0;
+        while ((phrase + 1) * (phrase + 1) <= pick) {
+            ++phrase;
+        }
+        out += PHRASES[PHRASE_COUNT - 1 - phrase];
+
+        char number[24];
+        while (out.size() - start < length) {
+            out += ' ';
+            if (below(4) == 0) {
+                out.append(number, static_cast<size_t>(std::snprintf(number, sizeof(number), "%llu",
+                    static_cast<unsigned long long>(below(100000)))));
+            } else {
+                out += WORDS[below(WORD_COUNT)];
+            }
+        }
+        out.resize(start + length);
+        if (out.back() == ' ') {
+            out.back() = '.';
+        }
+    }
+
+    // 追加一行日志
+    void LogGenerator::appendLine(std::string& out) {
+        updateTime();
+        const unsigned millis = static_cast<unsigned>(millis_ % 1000);
+        millis_ += options_.stepMillis;
+
+        // 按权重抽取级别
+        std::uint64_t roll = below(weightTotal_);
+        size_t level = 0;
+        while (roll >= options_.levelWeights[level]) {
+            roll -= options_.levelWeights[level];
+            ++level;
+        }
+        ++levelCounts_[level];
+        const std::string levelText = logLevelToString(static_cast<LogLevel>(level));
+
+        // 来源按平方偏斜选取，制造少数高频来源
+        char source[32];
+        std::uint64_t u = below(1u << 16);
+        size_t sourceIndex = static_cast<size_t>((u * u * options_.sourceCount) >> 32);
+        size_t sourceLength = static_cast<size_t>(std::snprintf(source, sizeof(source), "service-%zu", sourceIndex));
+
+        LogFormat format = options_.mixedFormats ? static_cast<LogFormat>(below(LOG_FORMAT_COUNT)) : options_.format;
+        char fraction[4];
+        writeDigits(fraction, millis, 3);
+        switch (format) {
+            case LogFormat::APP_BRACKETED:
+                // 2024-01-15 14:30:45 [INFO] [main] message
+                out.append(dateTime_, 19).append(" [").append(levelText).append("] [")
+                   .append(source, sourceLength).append("] ");
+                break;
+            case LogFormat::SYSLOG:
+                // Jan 15 14:30:45 INFO sshd: message
+                out.append(syslogTime_, syslogLength_).append(" ").append(levelText).append(" ")
+                   .append(source, sourceLength).append(": ");
+                break;
+            case LogFormat::JAVA_MILLIS:
+                // 2024-01-15 14:30:45,123 INFO [main] message
+                out.append(dateTime_, 19).append(",").append(fraction, 3).append(" ").append(levelText)
+                   .append(" [").append(source, sourceLength).append("] ");
+                break;
+            case LogFormat::SIMPLE_COLON:
+                // 2024-01-15 14:30:45 INFO: message
+                out.append(dateTime_, 19).append(" ").append(levelText).append(": ");
+                break;
+            case LogFormat::ISO8601:
+                // 2024-01-15T14:30:45.123Z [INFO] [main] message
+                out.append(dateTime_, 10).append("T").append(dateTime_ + 11, 8).append(".").append(fraction, 3)
+                   .append("Z [").append(levelText).append("] [").append(source, sourceLength).append("] ");
+                break;
+        }
+        appendMessage(out);
+        out += '\n';
+        ++lines_;
+    }
+
+    std::string LogGenerator::generate(size_t bytes) {
+        std::string out;
+        out.reserve(bytes + options_.maxMessageLength + 64);
+        while (out.size() < bytes) {
+            appendLine(out);
+        }
+        return out;
+    }
+
+    // 分块生成并写入，内存只占一个块
+    void LogGenerator::writeFile(const std::string& path, std::uint64_t bytes) {
+        constexpr size_t CHUNK_BYTES = 4 << 20;
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            throw std::runtime_error("无法创建文件: " + path);
+        }
+
+        std::string chunk;
+        chunk.reserve(CHUNK_BYTES + options_.maxMessageLength + 64);
+        std::uint64_t written = 0;
+        bool ok = true;
+        while (ok && written < bytes) {
+            chunk.clear();
+            while (chunk.size() < CHUNK_BYTES && written + chunk.size() < bytes) {
+                appendLine(chunk);
+            }
+            ok = std::fwrite(chunk.data(), 1, chunk.size(), file) == chunk.size();
+            written += chunk.size();
+        }
+        if (std::fclose(file) != 0 || !ok) {
+            throw std::runtime_error("写入文件失败: " + path);
+        }
+    }
+
+} // namespace LogAnalyzer
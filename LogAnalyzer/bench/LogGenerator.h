@@ -0,0 +1,110 @@
+/*
+ * LogGenerator.h
+ * 确定性的合成日志生成器（基准测试用）
+ */
+
+#pragma once
+
+#include "LogEntry.h"
+#include "LogFormats.h"
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    /**
+     * 生成参数
+     */
+    struct LogGeneratorOptions {
+        LogFormat format = LogFormat::APP_BRACKETED;
+        bool mixedFormats = false;                   // 每行随机选择一种内置格式
+        std::uint64_t seed = 1;
+        std::array<unsigned, LOG_LEVEL_COUNT> levelWeights = {{20, 60, 12, 7, 1}};  // DEBUG..FATAL 的权重
+        size_t minMessageLength = 24;                // 消息长度范围（字节，闭区间）
+        size_t maxMessageLength = 120;
+        size_t sourceCount = 32;                     // 来源数量，按偏斜分布选取
+        std::int64_t startSeconds = 1700000000;      // 第一行的时间（作为本地时间书写）
+        unsigned stepMillis = 1;                     // 相邻两行的时间间隔（毫秒）
+    };
+
+    /**
+     * 合成日志生成器
+     * 按 LogFormats.h 中五种内置格式逐行生成日志，级别按权重抽取，消息由词表中的词和数字拼接到
+     * 指定长度，因此模板挖掘和近似统计也有可统计的结构。
+     * 随机数使用自带的 splitmix64 而不是 std::uniform_int_distribution（后者的结果随标准库实现而不同），
+     * 同样的参数在任何平台上都生成逐字节相同的输出。
+     * SYSLOG 格式中解析器把主机名位置的词当作级别，生成时在该位置写入级别，使级别分布对所有格式一致。
+     */
+    class LogGenerator {
+    private:
+        LogGeneratorOptions options_;
+        std::uint64_t state_;
+        std::uint64_t weightTotal_;
+        std::int64_t millis_;                        // 当前行相对 startSeconds 的毫秒数
+        std::uint64_t lines_;
+        std::array<std::uint64_t, LOG_LEVEL_COUNT> levelCounts_;
+
+        // 当前秒的日期时间文本缓存："YYYY-MM-DD HH:MM:SS" 与 "Mon D HH:MM:SS"
+        std::int64_t cachedSecond_;
+        char dateTime_[20];
+        char syslogTime_[16];
+        size_t syslogLength_;
+
+        /**
+         * 下一个 64 位随机数
+         */
+        std::uint64_t next();
+
+        /**
+         * [0, bound) 内的随机数
+         */
+        std::uint64_t below(std::uint64_t bound);
+
+        /**
+         * 更新当前秒的日期时间文本
+         */
+        void updateTime();
+
+        /**
+         * 追加消息内容
+         */
+        void appendMessage(std::string& out);
+
+    public:
+        /**
+         * 构造函数
+         * @param options 生成参数
+         * @throws std::invalid_argument 如果参数无效（权重全为零、长度范围颠倒、来源数为零）
+         */
+        explicit LogGenerator(const LogGeneratorOptions& options = LogGeneratorOptions());
+
+        /**
+         * 追加一行日志（含换行符）
+         * @param out 输出缓冲区
+         */
+        void appendLine(std::string& out);
+
+        /**
+         * 生成至少 bytes 字节的完整日志行
+         * @param bytes 目标字节数
+         * @return 日志文本
+         */
+        std::string generate(size_t bytes);
+
+        /**
+         * 生成日志文件
+         * @param path 文件路径
+         * @param bytes 目标字节数（按整行向上取整）
+         * @throws std::runtime_error 如果写入失败
+         */
+        void writeFile(const std::string& path, std::uint64_t bytes);
+
+        // 访问器
+        const LogGeneratorOptions& options() const { return options_; }
+        std::uint64_t lines() const { return lines_; }
+        std::uint64_t levelCount(LogLevel level) const { return levelCounts_[static_cast<size_t>(level)]; }
+    };
+
+} // namespace LogAnalyzer
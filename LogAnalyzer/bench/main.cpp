@@ -0,0 +1,479 @@
+/*
+ * main.cpp
+ * loganalyzer_bench：解析器的可复现基准测试
+ *
+ * 输入全部由 LogGenerator 按固定种子生成，同样的参数每次得到逐字节相同的数据。
+ * 微基准反复处理一组预先生成的行，直到累计时间达到 --min-time；
+ * 端到端基准对生成的大文件（默认 1 GB，缓存在 --data-dir 中复用）调用 parseFiles。
+ */
+
+#include "LogGenerator.h"
+#include "LogEntry.h"
+#include "LogFormats.h"
+#include "LogParser.h"
+#include "StringPool.h"
+#include "TimestampParser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // 防止编译器删掉结果未被使用的计算
+    volatile std::uint64_t benchmarkSink = 0;
+
+    /**
+     * 一轮处理的数据量
+     */
+    struct Volume {
+        std::uint64_t items;
+        std::uint64_t bytes;
+    };
+
+    /**
+     * 基准测试参数
+     */
+    struct BenchOptions {
+        std::string filter;                 // 只运行名称包含该子串的基准
+        double minSeconds = 0.5;            // 每个微基准的最少运行时间
+        size_t lines = 1 << 16;             // 微基准的数据行数
+        std::uint64_t fileMegabytes = 1024; // 端到端基准的文件大小
+        std::string dataDir;                // 端到端基准的文件目录
+        std::vector<unsigned> threadCounts; // 端到端基准的线程数
+        unsigned repeat = 1;                // 端到端基准的重复次数
+        LogGeneratorOptions generator;
+    };
+
+    /**
+     * 打印表头（数值列在前，名称在后，避免中文宽度影响对齐）
+     */
+    void printHeader() {
+        std::cout << std::right << std::setw(10) << "轮数" << std::setw(12) << "ns/条"
+                  << std::setw(14) << "条/秒" << std::setw(11) << "MB/秒" << "  基准\n";
+    }
+
+    /**
+     * 打印一行结果
+     */
+    void printResult(const std::string& name, std::uint64_t passes, std::uint64_t nanos, const Volume& total) {
+        double seconds = static_cast<double>(nanos) / 1e9;
+        std::cout << std::right << std::fixed
+                  << std::setw(8) << passes
+                  << std::setw(11) << std::setprecision(1)
+                  << (total.items > 0 ? static_cast<double>(nanos) / static_cast<double>(total.items) : 0.0)
+                  << std::setw(12) << std::setprecision(0)
+                  << (seconds > 0 ? static_cast<double>(total.items) / seconds : 0.0)
+                  << std::setw(10) << std::setprecision(1)
+                  << (seconds > 0 ? static_cast<double>(total.bytes) / seconds / (1024.0 * 1024.0) : 0.0)
+                  << "  " << name << std::endl;
+    }
+
+    /**
+     * 运行一个微基准：先预热一轮，再重复到累计时间达到下限
+     * @param pass 处理一轮数据并返回处理量
+     */
+    void runBenchmark(const BenchOptions& options, const std::string& name, const std::function<Volume()>& pass) {
+        if (name.find(options.filter) == std::string::npos) {
+            return;
+        }
+        pass();
+
+        Volume total{0, 0};
+        std::uint64_t passes = 0;
+        std::uint64_t nanos = 0;
+        const auto limit = static_cast<std::uint64_t>(options.minSeconds * 1e9);
+        do {
+            auto start = Clock::now();
+            Volume volume = pass();
+            nanos += static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+            total.items += volume.items;
+            total.bytes += volume.bytes;
+            ++passes;
+        } while (nanos < limit);
+        printResult(name, passes, nanos, total);
+    }
+
+    /**
+     * 生成指定格式的一组日志行（行视图指向 text）
+     */
+    std::vector<std::string_view> generateLines(const BenchOptions& options, bool mixed, LogFormat format,
+                                                std::string& text) {
+        LogGeneratorOptions generatorOptions = options.generator;
+        generatorOptions.mixedFormats = mixed;
+        generatorOptions.format = format;
+        LogGenerator generator(generatorOptions);
+        text.clear();
+        for (size_t i = 0; i < options.lines; ++i) {
+            generator.appendLine(text);
+        }
+
+        std::vector<std::string_view> lines;
+        lines.reserve(options.lines);
+        std::string_view rest(text);
+        while (!rest.empty()) {
+            size_t newline = rest.find('\n');
+            lines.push_back(rest.substr(0, newline));
+            rest.remove_prefix(newline + 1);
+        }
+        return lines;
+    }
+
+    std::uint64_t totalBytes(const std::vector<std::string_view>& lines) {
+        std::uint64_t bytes = 0;
+        for (std::string_view line : lines) {
+            bytes += line.size() + 1;
+        }
+        return bytes;
+    }
+
+    /**
+     * 格式在基准名称中的简称
+     */
+    const char* formatKey(LogFormat format) {
+        static const char* const keys[LOG_FORMAT_COUNT] = {"app", "syslog", "java", "simple", "iso8601"};
+        return keys[static_cast<size_t>(format)];
+    }
+
+    /**
+     * scanLogLine / parseLine / parseTimestamp：每种格式一组，外加混合格式的 parseLine
+     */
+    void runLineBenchmarks(const BenchOptions& options) {
+        std::string text;
+        for (size_t f = 0; f <= LOG_FORMAT_COUNT; ++f) {
+            const bool mixed = f == LOG_FORMAT_COUNT;
+            const LogFormat format = mixed ? LogFormat::APP_BRACKETED : static_cast<LogFormat>(f);
+            const std::string key = mixed ? "mixed" : formatKey(format);
+            const auto lines = generateLines(options, mixed, format, text);
+            const std::uint64_t bytes = totalBytes(lines);
+
+            if (!mixed) {
+                runBenchmark(options, "scanLogLine/" + key, [&]() {
+                    LogFields fields;
+                    std::uint64_t matched = 0;
+                    for (std::string_view line : lines) {
+                        matched += scanLogLine(format, line, fields);
+                    }
+                    benchmarkSink = benchmarkSink + matched;
+                    return Volume{lines.size(), bytes};
+                });
+            }
+
+            // 消息写入独立的内存池，每轮结束后重置，内存不随轮数增长
+            LogParser parser;
+            MessageArena arena;
+            runBenchmark(options, "parseLine/" + key, [&]() {
+                MessageArena::Scope scope(arena);
+                LogEntry entry;
+                std::uint64_t parsed = 0;
+                for (std::string_view line : lines) {
+                    parsed += parser.parseLine(line, entry);
+                }
+                arena.reset();
+                benchmarkSink = benchmarkSink + parsed;
+                return Volume{lines.size(), bytes};
+            });
+            if (parser.getErrorLines() > 0) {
+                std::cerr << "警告: parseLine/" << key << " 有 " << parser.getErrorLines() << " 行未能解析\n";
+            }
+
+            // LogParser::parseTimestamp 是对 TimestampParser::parse 的薄封装，这里直接测后者
+            if (!mixed) {
+                std::vector<std::string_view> timestamps;
+                std::uint64_t timestampBytes = 0;
+                LogFields fields;
+                for (std::string_view line : lines) {
+                    if (scanLogLine(format, line, fields)) {
+                        timestamps.push_back(fields.timestamp);
+                        timestampBytes += fields.timestamp.size();
+                    }
+                }
+                TimestampParser timestampParser;
+                runBenchmark(options, "parseTimestamp/" + key, [&]() {
+                    TimestampParser::TimePoint point;
+                    std::uint64_t sum = 0;
+                    for (std::string_view timestamp : timestamps) {
+                        timestampParser.parse(timestamp, point);
+                        sum += static_cast<std::uint64_t>(point.time_since_epoch().count());
+                    }
+                    benchmarkSink = benchmarkSink + sum;
+                    return Volume{timestamps.size(), timestampBytes};
+                });
+            }
+        }
+    }
+
+    /**
+     * stringToLogLevel：按生成器的级别分布取级别文本
+     */
+    void runLevelBenchmark(const BenchOptions& options) {
+        std::string text;
+        const auto lines = generateLines(options, false, LogFormat::SIMPLE_COLON, text);
+        std::vector<std::string_view> levels;
+        std::uint64_t bytes = 0;
+        LogFields fields;
+        for (std::string_view line : lines) {
+            if (scanLogLine(LogFormat::SIMPLE_COLON, line, fields)) {
+                levels.push_back(fields.level);
+                bytes += fields.level.size();
+            }
+        }
+        runBenchmark(options, "stringToLogLevel", [&]() {
+            std::uint64_t sum = 0;
+            for (std::string_view level : levels) {
+                sum += static_cast<std::uint64_t>(stringToLogLevel(level));
+            }
+            benchmarkSink = benchmarkSink + sum;
+            return Volume{levels.size(), bytes};
+        });
+    }
+
+    /**
+     * 生成参数的摘要（FNV-1a），用于区分缓存的数据文件
+     */
+    std::uint64_t optionsDigest(const LogGeneratorOptions& options) {
+        std::ostringstream oss;
+        oss << static_cast<int>(options.format) << ',' << options.mixedFormats << ',' << options.seed << ','
+            << options.minMessageLength << ',' << options.maxMessageLength << ',' << options.sourceCount << ','
+            << options.startSeconds << ',' << options.stepMillis;
+        for (unsigned weight : options.levelWeights) {
+            oss << ',' << weight;
+        }
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (char c : oss.str()) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    /**
+     * parseFiles 端到端：文件不存在时生成，之后复用
+     */
+    void runFileBenchmarks(const BenchOptions& options) {
+        const std::string prefix = "parseFiles/" + std::to_string(options.fileMegabytes) + "MB/threads:";
+        auto selected = [&](unsigned threads) {
+            return (prefix + std::to_string(threads)).find(options.filter) != std::string::npos;
+        };
+        if (std::none_of(options.threadCounts.begin(), options.threadCounts.end(), selected)) {
+            return;
+        }
+
+        char digest[17];
+        std::snprintf(digest, sizeof(digest), "%016llx",
+                      static_cast<unsigned long long>(optionsDigest(options.generator)));
+        const std::filesystem::path path = std::filesystem::path(options.dataDir) /
+            ("loganalyzer_bench_" + std::to_string(options.fileMegabytes) + "mb_" + digest + ".log");
+        const std::uint64_t bytes = options.fileMegabytes << 20;
+
+        std::error_code error;
+        if (!std::filesystem::exists(path, error) || std::filesystem::file_size(path, error) < bytes) {
+            std::cerr << "生成 " << path.string() << " ...\n";
+            std::filesystem::create_directories(options.dataDir, error);
+            LogGenerator generator(options.generator);
+            generator.writeFile(path.string(), bytes);
+        }
+        const std::uint64_t fileBytes = std::filesystem::file_size(path);
+
+        // 每次运行都计入输出条目数；消息写入独立的内存池，条目和内存池在下一次运行前释放、重置
+        MessageArena arena;
+        for (unsigned threads : options.threadCounts) {
+            if (!selected(threads)) {
+                continue;
+            }
+            std::uint64_t nanos = 0;
+            Volume total{0, 0};
+            for (unsigned i = 0; i < options.repeat; ++i) {
+                {
+                    MessageArena::Scope scope(arena);
+                    LogParser parser;
+                    parser.setThreadCount(threads);
+                    auto start = Clock::now();
+                    std::vector<LogEntry> entries = parser.parseFiles({path.string()});
+                    nanos += static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+                    total.items += entries.size();
+                    total.bytes += fileBytes;
+                    if (parser.getErrorLines() > 0) {
+                        std::cerr << "警告: " << parser.getErrorLines() << " 行未能解析\n";
+                    }
+                }
+                arena.reset();
+            }
+            printResult(prefix + std::to_string(threads), options.repeat, nanos, total);
+        }
+    }
+
+    /**
+     * 解析格式参数：0-4、格式简称或 mixed
+     */
+    bool parseFormatArgument(const std::string& text, LogGeneratorOptions& options) {
+        if (text == "mixed") {
+            options.mixedFormats = true;
+            return true;
+        }
+        for (size_t i = 0; i < LOG_FORMAT_COUNT; ++i) {
+            if (text == formatKey(static_cast<LogFormat>(i)) || text == std::to_string(i)) {
+                options.format = static_cast<LogFormat>(i);
+                options.mixedFormats = false;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * 解析级别权重参数：逗号分隔的五个非负整数（DEBUG,INFO,WARN,ERROR,FATAL）
+     */
+    bool parseLevelWeights(const std::string& text, LogGeneratorOptions& options) {
+        std::istringstream iss(text);
+        std::string part;
+        size_t count = 0;
+        while (std::getline(iss, part, ',')) {
+            if (count == LOG_LEVEL_COUNT || part.empty() ||
+                part.find_first_not_of("0123456789") != std::string::npos) {
+                return false;
+            }
+            options.levelWeights[count++] = static_cast<unsigned>(std::stoul(part));
+        }
+        return count == LOG_LEVEL_COUNT;
+    }
+
+    void showHelp(const char* programName) {
+        std::cout << "用法: " << programName << " [选项]\n\n"
+                  << "选项:\n"
+                  << "  -h, --help              显示此帮助信息\n"
+                  << "      --filter <子串>     只运行名称包含该子串的基准\n"
+                  << "      --min-time <秒>     每个微基准的最少运行时间 (默认: 0.5)\n"
+                  << "      --lines <N>         微基准的数据行数 (默认: 65536)\n"
+                  << "      --size-mb <N>       parseFiles 基准的文件大小 (默认: 1024)\n"
+                  << "      --data-dir <目录>   parseFiles 基准的文件目录 (默认: 系统临时目录)\n"
+                  << "      --threads <N,...>   parseFiles 基准的线程数 (默认: 1 和 CPU 核心数)\n"
+                  << "      --repeat <N>        parseFiles 基准的重复次数 (默认: 1)\n"
+                  << "      --generate <文件>   只生成一个 --size-mb 大小的日志文件后退出\n\n"
+                  << "生成参数:\n"
+                  << "      --seed <N>          随机种子 (默认: 1)\n"
+                  << "      --format <格式>     app, syslog, java, simple, iso8601 或 mixed (默认: mixed)；\n"
+                  << "                          只影响 parseFiles 基准和 --generate\n"
+                  << "      --levels <权重>     DEBUG,INFO,WARN,ERROR,FATAL 的权重 (默认: 20,60,12,7,1)\n"
+                  << "      --min-length <N>    最短消息字节数 (默认: 24)\n"
+                  << "      --max-length <N>    最长消息字节数 (默认: 120)\n"
+                  << "      --sources <N>       来源数量 (默认: 32)\n\n"
+                  << "示例:\n"
+                  << "  " << programName << " --filter parseLine --min-time 1\n"
+                  << "  " << programName << " --filter parseFiles --size-mb 256 --threads 1,4\n"
+                  << "  " << programName << " --generate sample.log --size-mb 64 --format java --levels 0,50,30,15,5\n";
+    }
+
+} // namespace
+
+/**
+ * 主函数
+ */
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    options.generator.mixedFormats = true;
+    std::string generateFile;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " 需要一个参数");
+                }
+                return argv[++i];
+            };
+
+            if (arg == "-h" || arg == "--help") {
+                showHelp(argv[0]);
+                return 0;
+            } else if (arg == "--filter") {
+                options.filter = value();
+            } else if (arg == "--min-time") {
+                options.minSeconds = std::stod(value());
+            } else if (arg == "--lines") {
+                options.lines = std::stoul(value());
+            } else if (arg == "--size-mb") {
+                options.fileMegabytes = std::stoull(value());
+            } else if (arg == "--data-dir") {
+                options.dataDir = value();
+            } else if (arg == "--threads") {
+                std::istringstream iss(value());
+                std::string part;
+                while (std::getline(iss, part, ',')) {
+                    unsigned threads = static_cast<unsigned>(std::stoul(part));
+                    if (threads == 0) {
+                        throw std::invalid_argument("--threads 必须为正数");
+                    }
+                    options.threadCounts.push_back(threads);
+                }
+            } else if (arg == "--repeat") {
+                options.repeat = static_cast<unsigned>(std::stoul(value()));
+            } else if (arg == "--generate") {
+                generateFile = value();
+            } else if (arg == "--seed") {
+                options.generator.seed = std::stoull(value());
+            } else if (arg == "--format") {
+                if (!parseFormatArgument(value(), options.generator)) {
+                    throw std::invalid_argument("未知的格式: " + std::string(argv[i]));
+                }
+            } else if (arg == "--levels") {
+                if (!parseLevelWeights(value(), options.generator)) {
+                    throw std::invalid_argument("--levels 需要五个逗号分隔的非负整数");
+                }
+            } else if (arg == "--min-length") {
+                options.generator.minMessageLength = std::stoul(value());
+            } else if (arg == "--max-length") {
+                options.generator.maxMessageLength = std::stoul(value());
+            } else if (arg == "--sources") {
+                options.generator.sourceCount = std::stoul(value());
+            } else {
+                throw std::invalid_argument("未知选项: " + arg);
+            }
+        }
+        if (options.lines == 0 || options.repeat == 0 || options.fileMegabytes == 0 || !(options.minSeconds > 0)) {
+            throw std::invalid_argument("--lines、--repeat、--size-mb 和 --min-time 必须为正数");
+        }
+
+        if (!generateFile.empty()) {
+            LogGenerator generator(options.generator);
+            generator.writeFile(generateFile, options.fileMegabytes << 20);
+            std::cout << "已生成 " << generator.lines() << " 行: " << generateFile << "\n";
+            return 0;
+        }
+
+        if (options.dataDir.empty()) {
+            options.dataDir = std::filesystem::temp_directory_path().string();
+        }
+        if (options.threadCounts.empty()) {
+            options.threadCounts.push_back(1);
+            unsigned hardware = std::thread::hardware_concurrency();
+            if (hardware > 1) {
+                options.threadCounts.push_back(hardware);
+            }
+        }
+
+        printHeader();
+        runLineBenchmarks(options);
+        runLevelBenchmark(options);
+        runFileBenchmarks(options);
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ * AllocationCounter.h
+ * 进程内堆分配计数
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace LogAnalyzer {
+
+    /**
+     * 堆分配计数器
+     * 主程序替换了全局 operator new / delete（含对齐形式），每次分配累加一次计数，
+     * 用于衡量解析等阶段每百万行的分配次数。计数使用宽松原子操作，开销很小。
+     * 实现文件只编进 loganalyzer 可执行文件，对象库 loganalyzer_core 及基准测试不带这一替换。
+     */
+    class AllocationCounter {
+    public:
+        /**
+         * 获取进程启动以来的分配次数
+         */
+        static std::uint64_t count();
+
+        /**
+         * 获取进程启动以来分配的字节数
+         */
+        static std::uint64_t bytes();
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,75 @@
+/*
+ * CompressedInput.h
+ * 压缩日志文件的识别与解压（gzip / zstd / lz4）
+ */
+
+#pragma once
+
+#include <string_view>
+#include <functional>
+
+namespace LogAnalyzer {
+
+    /**
+     * 压缩格式
+     */
+    enum class Compression {
+        NONE,
+        GZIP,
+        ZSTD,
+        LZ4
+    };
+
+    /**
+     * 压缩输入
+     * 按文件头的魔数识别压缩格式，把解压结果分块交给回调，不落临时文件。
+     * 多成员 gzip 和多帧 zstd 的各成员/帧相互独立，由工作线程并行解压，按原顺序交付
+     * （gzip 的当前成员在调用线程上边解压边交付，只有推测解压的后续成员有上限地缓冲）；
+     * 单成员/单帧和 lz4 输入在调用线程上边解压边交付。
+     * 只处理映射到内存的文件；标准输入不做识别，按普通文本解析。
+     * 各格式是否可用取决于构建时是否找到对应的库（LOGANALYZER_HAVE_ZLIB / _ZSTD / _LZ4）。
+     */
+    class CompressedInput {
+    public:
+        /**
+         * 数据块回调，参数为一段解压后的数据，仅在回调期间有效
+         */
+        using BlockCallback = std::function<void(std::string_view)>;
+
+        /**
+         * 根据开头的魔数识别压缩格式
+         * @param data 文件内容
+         * @return 压缩格式，普通文本返回 Compression::NONE
+         */
+        static Compression detect(std::string_view data);
+
+        /**
+         * 判断数据是否为压缩格式
+         * @param data 文件内容
+         */
+        static bool isCompressed(std::string_view data) { return detect(data) != Compression::NONE; }
+
+        /**
+         * 当前构建是否支持该压缩格式
+         * @param compression 压缩格式
+         */
+        static bool isSupported(Compression compression);
+
+        /**
+         * 获取压缩格式名称
+         * @param compression 压缩格式
+         * @return "gzip"、"zstd"、"lz4" 或 "none"
+         */
+        static const char* name(Compression compression);
+
+        /**
+         * 解压整个文件，按顺序把解压结果分块交给回调（在调用线程上调用）
+         * @param data 压缩文件内容
+         * @param threads 并行解压使用的线程数
+         * @param callback 数据块回调
+         * @throws std::runtime_error 如果格式不受支持或数据损坏、不完整
+         */
+        static void decompress(std::string_view data, unsigned threads, const BlockCallback& callback);
+    };
+
+} // namespace LogAnalyzer
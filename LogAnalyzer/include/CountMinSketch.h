@@ -0,0 +1,87 @@
+/*
+ * CountMinSketch.h
+ * 固定内存的频次估计
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    /**
+     * splitmix64 终结函数：把 64 位哈希的各位充分打散，也可由同一个哈希派生出独立的哈希
+     * （Count-Min 各行的列号和 LogSketches 的各项哈希共用）
+     * @param value 输入值
+     * @return 打散后的值
+     */
+    inline std::uint64_t mixHash(std::uint64_t value) {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ull;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebull;
+        value ^= value >> 31;
+        return value;
+    }
+
+    /**
+     * Count-Min 频次估计
+     * depth 行、每行 width 个计数器；每个值在每行落到一个计数器上，估计值取各行的最小值。
+     * 估计值不会低于真实频次；以 1 - delta 的概率，高出的部分不超过 epsilon × 总数。
+     * 其中 width = ceil(e / epsilon)，depth = ceil(ln(1 / delta))。
+     * 两个尺寸相同的草图逐个计数器相加即可合并。
+     */
+    class CountMinSketch {
+    private:
+        size_t width_;
+        size_t depth_;
+        double epsilon_;
+        std::vector<std::uint64_t> counters_;   // depth 行 × width 列
+        std::uint64_t total_;
+
+        /**
+         * 第 row 行上的列号（由一个 64 位哈希派生出各行的独立哈希）
+         */
+        size_t column(std::uint64_t hash, size_t row) const;
+
+    public:
+        /**
+         * 构造函数
+         * @param epsilon 误差上限占总数的比例
+         * @param delta 超出误差上限的概率
+         * @throws std::invalid_argument 如果参数不在 (0, 1) 内
+         */
+        explicit CountMinSketch(double epsilon = 0.001, double delta = 0.01);
+
+        /**
+         * 计入一个值
+         * @param hash 值的 64 位哈希
+         * @param count 次数
+         */
+        void add(std::uint64_t hash, std::uint64_t count = 1);
+
+        /**
+         * 估计一个值的频次
+         * @param hash 值的 64 位哈希
+         * @return 估计值（不低于真实频次）
+         */
+        std::uint64_t estimate(std::uint64_t hash) const;
+
+        /**
+         * 合并另一个草图
+         * @param other 另一个草图
+         * @throws std::invalid_argument 如果尺寸不同
+         */
+        void merge(const CountMinSketch& other);
+
+        // 访问器
+        size_t width() const { return width_; }
+        size_t depth() const { return depth_; }
+        double epsilon() const { return epsilon_; }
+        std::uint64_t total() const { return total_; }
+        size_t memoryBytes() const { return counters_.size() * sizeof(std::uint64_t); }
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,115 @@
+/*
+ * FileSignature.h
+ * 日志文件身份签名，用于校验旁路索引文件是否仍然有效
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+
+namespace LogAnalyzer {
+
+    class MappedFile;
+
+    /**
+     * 文件签名
+     * 记录文件大小、修改时间、inode、开头最多 4 KiB 内容的哈希，以及建立索引时解析器的
+     * 自定义模式哈希（模式不同时同一行的解析结果不同，索引不能沿用）。
+     *   - 签名完全一致：文件未变化；
+     *   - 旧签名是新文件的前缀（模式相同、同一 inode、开头内容相同、没有变短）：文件只在末尾追加；
+     *   - 其他情况：文件被替换、截断或换了模式。
+     */
+    struct FileSignature {
+        std::uint64_t size = 0;
+        std::int64_t mtime = 0;
+        std::uint64_t inode = 0;
+        std::uint64_t prefixHash = 0;
+        std::uint64_t parserHash = 0;
+
+        /**
+         * 计算已映射文件的签名
+         * @param filename 文件名
+         * @param mapped 映射了整个文件的 MappedFile
+         * @param parserHash 解析器的自定义模式哈希（LogParser::getPatternHash）
+         * @return 文件签名
+         * @throws std::runtime_error 如果无法获取文件信息
+         */
+        static FileSignature capture(const std::string& filename, const MappedFile& mapped,
+                                     std::uint64_t parserHash);
+
+        /**
+         * 判断文件是否未发生变化
+         * @param current 当前签名
+         */
+        bool matches(const FileSignature& current) const;
+
+        /**
+         * 判断记录的文件内容是否是当前文件的前缀（只追加）
+         * @param current 当前签名
+         * @param mapped 映射了当前文件的 MappedFile
+         */
+        bool isPrefixOf(const FileSignature& current, const MappedFile& mapped) const;
+
+        /**
+         * 以本机字节序写入 / 读取
+         */
+        void write(std::ostream& out) const;
+        bool read(std::istream& in);
+    };
+
+    // FNV-1a 64 位哈希的初始值
+    constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+    /**
+     * FNV-1a 64 位哈希，可从上一次的结果继续累加
+     * @param data 数据
+     * @param hash 初始值
+     */
+    inline std::uint64_t hashBytes(std::string_view data, std::uint64_t hash = FNV_OFFSET_BASIS) {
+        for (unsigned char c : data) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    /**
+     * 以本机字节序写入一个定长值
+     */
+    template <typename T>
+    inline void writeBinary(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    /**
+     * 输入流中从当前位置到末尾剩余的字节数，用于在按文件中记录的数量分配内存前做校验
+     * @return 剩余字节数；流不支持定位时返回 0
+     */
+    inline std::uint64_t remainingBytes(std::istream& in) {
+        const std::istream::pos_type current = in.tellg();
+        if (current == std::istream::pos_type(-1) || !in.seekg(0, std::ios::end)) {
+            in.clear();
+            return 0;
+        }
+        const std::istream::pos_type end = in.tellg();
+        in.seekg(current);
+        if (end == std::istream::pos_type(-1) || end < current) {
+            return 0;
+        }
+        return static_cast<std::uint64_t>(end - current);
+    }
+
+    /**
+     * 以本机字节序读取一个定长值
+     * @return 读取是否成功
+     */
+    template <typename T>
+    inline bool readBinary(std::istream& in, T& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,95 @@
+/*
+ * FilterStage.h
+ * 流水线中可组合的过滤阶段
+ */
+
+#pragma once
+
+#include "LogEntry.h"
+#include "KeywordIndex.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace LogAnalyzer {
+
+    // 日志条目过滤谓词
+    using EntryFilter = std::function<bool(const LogEntry&)>;
+
+    // 过滤阶段的种类，按单条判断的代价从低到高排列（自定义谓词的代价未知，排在最后）
+    enum class FilterKind {
+        LEVEL = 0,        // 级别等于指定级别
+        TIME_RANGE = 1,   // 时间戳在 [after, before) 内
+        KEYWORD = 2,      // 消息满足关键词查询
+        CUSTOM = 3        // 调用方提供的谓词
+    };
+
+    /**
+     * 过滤阶段
+     * 每个阶段是一个条件，由静态工厂函数创建；LogPipeline 把多个阶段融合为一次遍历。
+     * 阶段是值类型，可以拷贝（关键词查询在各副本间共享，自定义谓词随之拷贝）。
+     */
+    class FilterStage {
+    public:
+        using TimePoint = std::chrono::system_clock::time_point;
+
+    private:
+        FilterKind kind_;
+        LogLevel level_;
+        TimePoint after_;
+        TimePoint before_;
+        std::shared_ptr<const KeywordQuery> query_;
+        EntryFilter predicate_;
+
+        explicit FilterStage(FilterKind kind);
+
+    public:
+        /**
+         * 只保留指定级别的日志
+         * @param level 日志级别
+         */
+        static FilterStage level(LogLevel level);
+
+        /**
+         * 只保留时间戳在 [after, before) 内的日志
+         * @param after 起始时间（含）
+         * @param before 结束时间（不含）
+         */
+        static FilterStage timeRange(const TimePoint& after, const TimePoint& before);
+
+        /**
+         * 只保留消息满足关键词查询的日志
+         * @param query 关键词查询
+         */
+        static FilterStage keyword(KeywordQuery query);
+
+        /**
+         * 只保留满足自定义谓词的日志（排在内置阶段之后，只对通过内置阶段的条目调用）
+         * @param predicate 过滤谓词，可能在多个线程上被调用时需要自行保证线程安全
+         * @throws std::invalid_argument 如果谓词为空
+         */
+        static FilterStage custom(EntryFilter predicate);
+
+        /**
+         * 判断一条日志是否满足条件
+         * @param entry 日志条目
+         */
+        bool matches(const LogEntry& entry) const {
+            switch (kind_) {
+                case FilterKind::LEVEL:
+                    return entry.getLevel() == level_;
+                case FilterKind::TIME_RANGE:
+                    return entry.getTimestamp() >= after_ && entry.getTimestamp() < before_;
+                case FilterKind::KEYWORD:
+                    return query_->matches(entry.getMessage());
+                case FilterKind::CUSTOM:
+                    return predicate_(entry);
+            }
+            return true;
+        }
+
+        // 访问器
+        FilterKind kind() const { return kind_; }
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,75 @@
+/*
+ * HyperLogLog.h
+ * 固定内存的基数（不同值个数）估计
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    /**
+     * HyperLogLog 基数估计
+     * 2^precision 个 6 位寄存器（按字节保存），内存与输入规模无关；
+     * 相对标准误差约为 1.04 / sqrt(2^precision)，精度 14 时约 0.81%，占用 16 KB。
+     * 输入是调用方算好的 64 位哈希值，哈希必须分布均匀。
+     * 两个精度相同的估计器按寄存器取最大值即可合并，结果与顺序计入全部数据相同。
+     */
+    class HyperLogLog {
+    private:
+        unsigned precision_;
+        std::vector<std::uint8_t> registers_;
+
+    public:
+        static constexpr unsigned MIN_PRECISION = 4;
+        static constexpr unsigned MAX_PRECISION = 18;
+
+        /**
+         * 构造函数
+         * @param precision 精度（寄存器数为 2^precision）
+         * @throws std::invalid_argument 如果精度不在 [MIN_PRECISION, MAX_PRECISION] 内
+         */
+        explicit HyperLogLog(unsigned precision = 14);
+
+        /**
+         * 计入一个值
+         * @param hash 值的 64 位哈希
+         */
+        void add(std::uint64_t hash) {
+            size_t index = static_cast<size_t>(hash >> (64 - precision_));
+            std::uint64_t rest = hash << precision_;
+            std::uint8_t rank = rest == 0 ? static_cast<std::uint8_t>(64 - precision_ + 1)
+                                          : static_cast<std::uint8_t>(__builtin_clzll(rest) + 1);
+            if (rank > registers_[index]) {
+                registers_[index] = rank;
+            }
+        }
+
+        /**
+         * 合并另一个估计器
+         * @param other 另一个估计器
+         * @throws std::invalid_argument 如果精度不同
+         */
+        void merge(const HyperLogLog& other);
+
+        /**
+         * 估计不同值的个数（小基数时使用线性计数修正）
+         * @return 估计值
+         */
+        double estimate() const;
+
+        /**
+         * 清空
+         */
+        void clear();
+
+        // 访问器
+        unsigned precision() const { return precision_; }
+        double relativeError() const;
+        size_t memoryBytes() const { return registers_.size(); }
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,185 @@
+/*
+ * KeywordIndex.h
+ * 关键词倒排索引与关键词查询
+ */
+
+#pragma once
+
+#include "FileSignature.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace LogAnalyzer {
+
+    class LogParser;
+
+    /**
+     * 关键词查询
+     * 查询字符串按空白切分为若干组，各组之间为 AND；
+     * 组内用 '|' 分隔的关键词之间为 OR。例如 "database timeout|refused"
+     * 匹配同时包含 database 以及 timeout 或 refused 的日志。
+     * 关键词按整词匹配，不区分大小写。
+     */
+    class KeywordQuery {
+    private:
+        std::vector<std::vector<std::string>> groups_;
+
+    public:
+        /**
+         * 解析查询字符串
+         * @param query 查询字符串
+         */
+        explicit KeywordQuery(const std::string& query);
+
+        /**
+         * 判断一条消息是否满足查询
+         * @param message 日志消息
+         */
+        bool matches(std::string_view message) const;
+
+        // 访问器
+        const std::vector<std::vector<std::string>>& getGroups() const { return groups_; }
+        bool empty() const { return groups_.empty(); }
+    };
+
+    /**
+     * 关键词倒排索引
+     * 对每条成功解析的日志消息分词（字母、数字、下划线及非 ASCII 字节组成的词，转为小写），
+     * 为每个词记录包含它的日志行在文件中的起始偏移。
+     * 偏移单调递增，倒排表以差值 + 变长整数（varint）编码压缩保存。
+     * 索引持久化在 "<日志文件>.kidx" 中，校验与增量扩展规则与 TimeIndex 相同。
+     */
+    class KeywordIndex {
+    public:
+        /**
+         * 差值 varint 编码的倒排表
+         */
+        struct PostingList {
+            std::vector<std::uint8_t> bytes;
+            std::uint64_t last = 0;   // 最后一个偏移，用于计算下一个差值
+            std::uint64_t count = 0;
+
+            /**
+             * 追加一个偏移（必须不小于上一个偏移，重复的偏移被忽略）
+             */
+            void append(std::uint64_t offset);
+
+            /**
+             * 解码为偏移列表
+             * @return 偏移列表；编码损坏时为空
+             */
+            std::vector<std::uint64_t> decode() const;
+
+            /**
+             * 解码并校验：varint 不超过 64 位、偏移严格递增、条目数和最后一个偏移与 count、last 一致
+             * @param offsets 输出的偏移列表
+             * @return 编码是否完好
+             */
+            bool decode(std::vector<std::uint64_t>& offsets) const;
+        };
+
+    private:
+        std::string filename_;
+        std::unordered_map<std::string, PostingList> postings_;
+        std::uint64_t indexedBytes_;   // 已索引到的位置（最后一个完整行之后）
+        FileSignature signature_;      // 建立索引时的文件签名
+
+        /**
+         * 扫描 [from, to) 区间内的完整行并加入倒排表
+         * @param data 文件内容
+         * @param from 起始偏移（行首）
+         * @param to 结束偏移
+         * @param parser 用于解析日志行的解析器
+         */
+        void scan(const char* data, std::uint64_t from, std::uint64_t to, LogParser& parser);
+
+        /**
+         * 从磁盘读取索引，不抛出异常
+         * @return 读取是否成功；索引不存在、损坏或截断时返回 false
+         */
+        bool load();
+
+        /**
+         * 读取指定的索引文件
+         * @param path 索引文件路径
+         * @return 读取是否成功
+         */
+        bool loadFrom(const std::string& path);
+
+    public:
+        /**
+         * 构造函数
+         * @param filename 日志文件名
+         */
+        explicit KeywordIndex(const std::string& filename);
+
+        /**
+         * 加载索引，必要时增量扩展或重建，并写回磁盘
+         * @param filename 日志文件名
+         * @param parser 用于解析日志行的解析器
+         * @return 与文件当前内容一致的索引
+         * @throws std::runtime_error 如果日志文件无法映射
+         */
+        static KeywordIndex loadOrBuild(const std::string& filename, LogParser& parser);
+
+        /**
+         * 索引文件路径
+         * @param filename 日志文件名
+         * @return 索引文件名
+         */
+        static std::string indexPath(const std::string& filename);
+
+        /**
+         * 写入磁盘（先写临时文件再重命名）
+         * @return 写入是否成功
+         */
+        bool save() const;
+
+        /**
+         * 查询满足条件的日志行：组内合并倒排表，组间从最短的倒排表开始求交集
+         * @param query 关键词查询
+         * @return 候选日志行的起始偏移（递增）
+         */
+        std::vector<std::uint64_t> lookup(const KeywordQuery& query) const;
+
+        /**
+         * 对文本分词，每个词（已转为小写）调用一次回调
+         * @param text 文本
+         * @param callback 回调，参数为 std::string_view
+         * @param buffer 保存小写词的缓冲区
+         */
+        template <typename Callback>
+        static void forEachToken(std::string_view text, std::string& buffer, Callback&& callback) {
+            size_t i = 0;
+            while (i < text.size()) {
+                while (i < text.size() && !isTokenByte(static_cast<unsigned char>(text[i]))) {
+                    ++i;
+                }
+                buffer.clear();
+                while (i < text.size() && isTokenByte(static_cast<unsigned char>(text[i]))) {
+                    unsigned char c = static_cast<unsigned char>(text[i++]);
+                    buffer.push_back(static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c));
+                }
+                if (!buffer.empty()) {
+                    callback(std::string_view(buffer));
+                }
+            }
+        }
+
+        /**
+         * 判断字节是否属于词的一部分
+         */
+        static bool isTokenByte(unsigned char c) {
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+                   (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+        }
+
+        // 访问器
+        size_t termCount() const { return postings_.size(); }
+        std::uint64_t indexedBytes() const { return indexedBytes_; }
+    };
+
+} // namespace LogAnalyzer
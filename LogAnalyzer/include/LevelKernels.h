@@ -0,0 +1,49 @@
+/*
+ * LevelKernels.h
+ * 级别列上的 SIMD 统计与过滤内核
+ */
+
+#pragma once
+
+#include "LogEntry.h"
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    /**
+     * 统计级别直方图
+     * 运行时按 CPU 能力选择 AVX2 / SSE2 / 标量实现；
+     * 可通过环境变量 LOGANALYZER_SIMD=avx2|sse2|scalar 强制指定。
+     * @param levels 打包的级别列（每行一个字节）
+     * @param count 行数
+     * @return 按 LogLevel 数值索引的计数，超出范围的值不计入
+     */
+    std::array<size_t, LOG_LEVEL_COUNT> levelHistogram(const std::uint8_t* levels, size_t count);
+
+    /**
+     * 生成级别选择位图
+     * @param levels 打包的级别列
+     * @param count 行数
+     * @param level 目标级别
+     * @return 位图，第 i 位表示第 i 行是否等于目标级别，共 (count + 63) / 64 个字
+     */
+    std::vector<std::uint64_t> levelSelectBitmap(const std::uint8_t* levels, size_t count, LogLevel level);
+
+    /**
+     * 将选择位图展开为行号列表
+     * @param bitmap 选择位图
+     * @param count 行数
+     * @return 升序行号列表
+     */
+    std::vector<size_t> bitmapToIndices(const std::vector<std::uint64_t>& bitmap, size_t count);
+
+    /**
+     * 获取当前使用的内核名称
+     * @return "avx2"、"sse2" 或 "scalar"
+     */
+    const char* levelKernelName();
+
+} // namespace LogAnalyzer
@@ -0,0 +1,168 @@
+/*
+ * LogAggregator.h
+ * 按 时间桶 × 级别 × 来源 分组的聚合引擎
+ */
+
+#pragma once
+
+#include "LogEntry.h"
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    class LogStore;
+
+    /**
+     * 日志聚合器
+     * 一次扫描即可按 (时间桶, 级别, 来源) 分组计数（哈希聚合），
+     * 在此基础上给出时间线、按来源的 Top-N 与突增检测。
+     * 聚合结果可以合并：每个线程聚合一段数据，最后 merge 到一起，与顺序聚合的结果相同。
+     */
+    class LogAggregator {
+    public:
+        using TimePoint = std::chrono::system_clock::time_point;
+
+        /**
+         * 分组键
+         */
+        struct Key {
+            std::int64_t bucket;     // 时间桶编号（纪元以来的桶数，向下取整）
+            std::uint32_t sourceId;  // SourceTable 编号
+            std::uint8_t level;      // LogLevel 的数值
+
+            bool operator==(const Key& other) const {
+                return bucket == other.bucket && sourceId == other.sourceId && level == other.level;
+            }
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const;
+        };
+
+        /**
+         * 时间线上的一个桶：各级别的条目数
+         */
+        struct TimelineBucket {
+            std::int64_t bucket;
+            std::array<std::uint64_t, LOG_LEVEL_COUNT> counts;
+        };
+
+        /**
+         * 突增：某个桶的计数明显高于它之前若干个桶
+         */
+        struct Spike {
+            std::int64_t bucket;
+            std::uint64_t count;
+            double baseline;   // 之前窗口内的平均值
+            double score;      // 超出基线的标准差倍数
+        };
+
+        // 突增检测的默认基线窗口（桶数）与阈值（标准差倍数）
+        static constexpr size_t DEFAULT_SPIKE_WINDOW = 30;
+        static constexpr double DEFAULT_SPIKE_THRESHOLD = 3.0;
+
+    private:
+        std::int64_t bucketNanos_;
+        std::unordered_map<Key, std::uint64_t, KeyHash> counts_;
+        std::uint64_t total_;
+
+        /**
+         * 计算时间桶编号
+         */
+        std::int64_t bucketOf(std::int64_t timestampNanos) const;
+
+    public:
+        /**
+         * 构造函数
+         * @param bucketWidth 时间桶宽度，至少 1 秒
+         */
+        explicit LogAggregator(std::chrono::seconds bucketWidth = std::chrono::seconds(60));
+
+        /**
+         * 计入一条日志
+         * @param timestampNanos 纪元以来的纳秒数
+         * @param level 日志级别
+         * @param sourceId 来源编号
+         */
+        void add(std::int64_t timestampNanos, LogLevel level, std::uint32_t sourceId);
+
+        /**
+         * 计入一条日志
+         * @param entry 日志条目
+         */
+        void add(const LogEntry& entry);
+
+        /**
+         * 计入存储中 [begin, end) 行（只扫描时间戳、级别和来源列）
+         * @param store 列式存储
+         * @param begin 起始行
+         * @param end 结束行（不含）
+         */
+        void addRange(const LogStore& store, size_t begin, size_t end);
+
+        /**
+         * 计入一批日志（流水线的聚合阶段）
+         * @param entries 日志条目
+         */
+        void addBatch(const std::vector<LogEntry>& entries);
+
+        /**
+         * 合并另一个聚合器的结果（桶宽度必须相同）
+         * @param other 另一个聚合器
+         * @throws std::invalid_argument 如果桶宽度不同
+         */
+        void merge(const LogAggregator& other);
+
+        /**
+         * 并行聚合整个存储：按行切分给多个线程，各自聚合后合并
+         * @param store 列式存储
+         * @param bucketWidth 时间桶宽度
+         * @param threads 线程数
+         * @return 聚合结果
+         */
+        static LogAggregator aggregate(const LogStore& store, std::chrono::seconds bucketWidth, unsigned threads);
+
+        /**
+         * 时间线：每个非空桶各级别的条目数
+         * @return 按桶递增排列
+         */
+        std::vector<TimelineBucket> timeline() const;
+
+        /**
+         * 级别不低于 minLevel 的条目数最多的 N 个来源
+         * @param minLevel 最低级别
+         * @param count N
+         * @return (来源编号, 条目数)，按条目数递减，相同时按来源编号递增
+         */
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> topSources(LogLevel minLevel, size_t count) const;
+
+        /**
+         * 突增检测：对级别不低于 minLevel 的每桶计数，与之前 window 个桶的均值和标准差比较，
+         * 超出 threshold 倍标准差（至少按泊松噪声 sqrt(均值) 计）的桶视为突增
+         * @param minLevel 最低级别
+         * @param window 基线窗口的桶数
+         * @param threshold 标准差倍数
+         * @return 按桶递增排列的突增
+         */
+        std::vector<Spike> findSpikes(LogLevel minLevel, size_t window, double threshold) const;
+
+        /**
+         * 时间桶的起始时间
+         * @param bucket 时间桶编号
+         */
+        TimePoint bucketStart(std::int64_t bucket) const;
+
+        // 访问器
+        std::chrono::seconds bucketWidth() const;
+        std::uint64_t total() const { return total_; }
+        size_t groupCount() const { return counts_.size(); }
+        const std::unordered_map<Key, std::uint64_t, KeyHash>& groups() const { return counts_; }
+    };
+
+} // namespace LogAnalyzer
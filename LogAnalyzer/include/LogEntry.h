@@ -6,13 +6,15 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <iostream>
+#include <cstdint>
 
 namespace LogAnalyzer {
 
-    // 日志级别枚举
-    enum class LogLevel {
+    // 日志级别枚举（单字节存储）
+    enum class LogLevel : std::uint8_t {
         DEBUG = 0,
         INFO = 1,
         WARN = 2,
@@ -20,33 +22,61 @@ namespace LogAnalyzer {
         FATAL = 4
     };
 
-    // 日志条目类
+    // 日志级别数量
+    constexpr size_t LOG_LEVEL_COUNT = 5;
+
+    /**
+     * 日志条目类（紧凑表示，32 字节，无自有堆内存）
+     * 来源保存为 SourceTable 中的编号；消息保存为指向 MessageArena
+     * （或其他生命周期更长的缓冲区）的指针和长度，拷贝条目不会拷贝消息。
+     *
+     * 消息的存储归构造时的当前内存池所有，而不是条目本身：
+     * 构造函数和 setMessage 写入 MessageArena::current()。在 MessageArena::Scope 之外，
+     * 这是线程默认内存池，只在线程退出时释放，反复构造条目的长期运行代码会让它无限增长。
+     * 批量或长期运行的调用方应在自己的内存池作用域内创建条目，并在条目不再使用后
+     * 销毁或 reset() 该内存池；条目不能比写入消息的内存池活得更久。
+     */
     class LogEntry {
     private:
         std::chrono::system_clock::time_point timestamp_;
+        const char* message_;
+        std::uint32_t messageLength_;
+        std::uint32_t sourceId_;
         LogLevel level_;
-        std::string source_;
-        std::string message_;
 
     public:
-        // 构造函数
-        LogEntry() = default;
+        // 构造函数：消息拷贝到当前线程的 MessageArena（见类说明中的生命周期），来源登记到 SourceTable
+        LogEntry();
         LogEntry(const std::chrono::system_clock::time_point& timestamp,
                 LogLevel level, 
-                const std::string& source, 
-                const std::string& message);
+                std::string_view source, 
+                std::string_view message);
+
+        /**
+         * 由已驻留的字段直接构造，不拷贝消息
+         * @param timestamp 时间戳
+         * @param level 日志级别
+         * @param sourceId SourceTable 中的来源编号
+         * @param message 生命周期不短于条目的消息内容
+         * @return 日志条目
+         */
+        static LogEntry fromStored(const std::chrono::system_clock::time_point& timestamp,
+                                   LogLevel level,
+                                   std::uint32_t sourceId,
+                                   std::string_view message);
 
         // 访问器
         const std::chrono::system_clock::time_point& getTimestamp() const;
         LogLevel getLevel() const;
         const std::string& getSource() const;
-        const std::string& getMessage() const;
+        std::uint32_t getSourceId() const { return sourceId_; }
+        std::string_view getMessage() const;
 
         // 修改器
         void setTimestamp(const std::chrono::system_clock::time_point& timestamp);
         void setLevel(LogLevel level);
-        void setSource(const std::string& source);
-        void setMessage(const std::string& message);
+        void setSource(std::string_view source);
+        void setMessage(std::string_view message);
 
         // 工具方法
         std::string getLevelString() const;
@@ -60,7 +90,8 @@ namespace LogAnalyzer {
 
     // 日志级别转换函数
     std::string logLevelToString(LogLevel level);
-    LogLevel stringToLogLevel(const std::string& levelStr);
+    std::string_view logLevelName(LogLevel level);  // 与 logLevelToString 相同，返回静态字符串，不分配内存
+    LogLevel stringToLogLevel(std::string_view levelStr);
 
     // 输出流操作符
     std::ostream& operator<<(std::ostream& os, const LogEntry& entry);
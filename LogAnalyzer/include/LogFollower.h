@@ -0,0 +1,116 @@
+/*
+ * LogFollower.h
+ * 跟踪持续增长的日志文件（类似 tail -F）
+ */
+
+#pragma once
+
+#include "LogParser.h"
+#include "StringPool.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace LogAnalyzer {
+
+    /**
+     * 日志跟踪器类
+     * 从文件当前末尾开始读取新追加的内容，逐行解析后交给回调输出。
+     * Linux 上使用 inotify 等待文件变化，其他平台定时轮询。
+     * 能识别日志轮转（文件被移走、删除或重新创建）和截断（copytruncate），
+     * 轮转后按原文件名重新打开并从头读取。
+     * 内存占用只与单次读取的数据量有关，与文件总大小无关。
+     */
+    class LogFollower {
+    private:
+        // 被跟踪的单个文件
+        struct FollowedFile {
+            std::string filename;
+            int fd = -1;
+            dev_t device = 0;
+            ino_t inode = 0;
+            off_t offset = 0;
+            std::string pending;   // 尚未遇到换行符的半行
+            int watch = -1;        // 文件的 inotify 监视描述符
+            int dirWatch = -1;     // 所在目录的 inotify 监视描述符
+        };
+
+        LogParser& parser_;
+        std::vector<FollowedFile> files_;
+        int inotifyFd_;
+        std::string readBuffer_;   // 每次 pread 的缓冲区，所有文件、所有轮询共用
+        MessageArena scratch_;     // 新行消息的临时内存池，每批回调处理完即重置
+
+        /**
+         * 打开文件并记录其身份（设备号和 inode）
+         * @param file 被跟踪的文件
+         * @param fromEnd 是否从文件末尾开始
+         * @return 是否打开成功
+         */
+        bool openFile(FollowedFile& file, bool fromEnd);
+
+        /**
+         * 注册 inotify 监视
+         * @param file 被跟踪的文件
+         */
+        void addWatches(FollowedFile& file);
+
+        /**
+         * 读取文件新增的内容并解析完整的行
+         * @param file 被跟踪的文件
+         * @param callback 日志回调
+         */
+        void drain(FollowedFile& file, const EntryCallback& callback);
+
+        /**
+         * 检查文件是否被轮转或截断，必要时重新打开
+         * @param file 被跟踪的文件
+         * @param callback 日志回调（轮转前先读完旧文件剩余内容）
+         */
+        void checkRotation(FollowedFile& file, const EntryCallback& callback);
+
+        /**
+         * 等待任意文件发生变化或超时
+         * @param timeoutMs 超时时间（毫秒）
+         */
+        void waitForChange(int timeoutMs);
+
+    public:
+        /**
+         * 构造函数
+         * @param parser 用于解析新行的解析器（统计信息累计在其中）
+         */
+        explicit LogFollower(LogParser& parser);
+
+        /**
+         * 禁用拷贝
+         */
+        LogFollower(const LogFollower&) = delete;
+        LogFollower& operator=(const LogFollower&) = delete;
+
+        /**
+         * 析构函数，关闭文件和 inotify 描述符
+         */
+        ~LogFollower();
+
+        /**
+         * 添加要跟踪的文件
+         * @param filename 日志文件名
+         * @return 是否添加成功
+         */
+        bool addFile(const std::string& filename);
+
+        /**
+         * 持续跟踪直到 stop 被置为 true
+         * @param callback 每条新解析的日志调用一次
+         * @param stop 停止标志（可在信号处理函数中设置）
+         * @param onBatch 非空时每轮读完所有文件的新内容、开始等待变化之前调用一次（用于刷新输出）
+         */
+        void run(const EntryCallback& callback, const std::atomic<bool>& stop,
+                 const std::function<void()>& onBatch = nullptr);
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,53 @@
+/*
+ * LogFormats.h
+ * 内置日志格式的手写字节扫描器
+ */
+
+#pragma once
+
+#include <string_view>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    // 内置日志格式，顺序即匹配优先级
+    enum class LogFormat {
+        APP_BRACKETED = 0,  // 2024-01-15 14:30:45 [INFO] [main] message
+        SYSLOG = 1,         // Jan 15 14:30:45 host sshd: message
+        JAVA_MILLIS = 2,    // 2024-01-15 14:30:45,123 INFO [main] message
+        SIMPLE_COLON = 3,   // 2024-01-15 14:30:45 INFO: message
+        ISO8601 = 4         // 2024-01-15T14:30:45.123Z [INFO] [main] message
+    };
+
+    // 内置格式数量
+    constexpr size_t LOG_FORMAT_COUNT = 5;
+
+    /**
+     * 扫描结果：各字段直接指向原始行
+     */
+    struct LogFields {
+        std::string_view timestamp;
+        std::string_view level;
+        std::string_view source;
+        std::string_view message;
+        bool hasSource = false;  // SIMPLE_COLON 没有来源字段
+    };
+
+    /**
+     * 按指定格式扫描一行日志
+     * 匹配语义与原先的 std::regex_match 模式逐字节一致（包括 \s、\w 与 . 的字符集）
+     * @param format 日志格式
+     * @param line 日志行内容
+     * @param fields 输出的字段视图
+     * @return 整行是否匹配该格式
+     */
+    bool scanLogLine(LogFormat format, std::string_view line, LogFields& fields);
+
+    /**
+     * 获取格式名称
+     * @param format 日志格式
+     * @return 格式名称字符串
+     */
+    const char* logFormatName(LogFormat format);
+
+} // namespace LogAnalyzer
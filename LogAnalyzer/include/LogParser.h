@@ -6,46 +6,173 @@
 #pragma once
 
 #include "LogEntry.h"
+#include "LogFormats.h"
+#include "FilterStage.h"
+#include "TimestampParser.h"
+#include "KeywordIndex.h"
+#include "MultiPatternMatcher.h"
+#include "LogSketches.h"
+#include "TemplateMiner.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include <regex>
 #include <fstream>
 #include <memory>
+#include <functional>
+#include <array>
+#include <utility>
+#include <cstdint>
 
 namespace LogAnalyzer {
 
+    class ParseSampler;
+
+    // 逐条处理解析结果的回调
+    using EntryCallback = std::function<void(const LogEntry&)>;
+    
+    // 逐批处理解析结果的回调：批次中的条目只在回调期间有效，回调可以就地修改批次
+    using BatchCallback = std::function<void(std::vector<LogEntry>& batch)>;
+    
+    // 解析字段投影：按位组合，只解码查询需要的字段（级别总是解码）。
+    // 未解码的时间戳为纪元零点，来源为空，消息为空串
+    enum ParseField : unsigned {
+        FIELD_LEVEL = 0,
+        FIELD_TIMESTAMP = 1u << 0,
+        FIELD_SOURCE = 1u << 1,
+        FIELD_MESSAGE = 1u << 2,
+        FIELD_ALL = FIELD_TIMESTAMP | FIELD_SOURCE | FIELD_MESSAGE
+    };
+
     /**
      * 日志解析器类
      * 负责解析各种格式的日志文件
      */
     class LogParser {
     private:
-        // 预定义的日志格式正则表达式
-        static const std::vector<std::regex> LOG_PATTERNS;
-        
-        // 自定义的日志格式模式
+        // 自定义的日志格式模式（内置格式使用 LogFormats 中的手写扫描器）
         std::vector<std::regex> customPatterns_;
+        std::uint64_t patternHash_;   // 自定义模式按添加顺序的哈希，没有自定义模式时为 0
         
         // 解析统计信息
         size_t totalLines_;
         size_t parsedLines_;
         size_t errorLines_;
         
+        // 按格式统计的匹配行数（自定义模式合计为一项）
+        std::array<size_t, LOG_FORMAT_COUNT> formatMatches_;
+        size_t customMatches_;
+        
+        // 内置格式的尝试顺序：按本解析器（即本输入流）中的命中次数自适应调整。
+        // 内置格式两两互斥，调整顺序不改变解析结果；同一格式的文件稳定后每行只需尝试一次
+        std::array<std::uint8_t, LOG_FORMAT_COUNT> formatOrder_;
+        
+        // 单个文件并行解析时使用的线程数（1 表示单线程）
+        unsigned threadCount_;
+        
+        // 需要解码的字段（ParseField 的按位组合）
+        unsigned fieldMask_;
+        
+        // 近似统计草图（未启用时为空），每条成功解析的日志都会计入
+        std::unique_ptr<LogSketches> sketches_;
+        
+        // 消息模板挖掘（未启用时为空），每条成功解析的日志的消息都会计入
+        std::unique_ptr<TemplateMiner> templateMiner_;
+        
+        // 近似统计和模板挖掘只计入满足该条件的日志（为空时全部计入）
+        EntryFilter observeFilter_;
+        
+        // 启用性能统计时，当前解析循环的抽样计时器（不在循环中时为空）
+        ParseSampler* sampler_;
+        
+        // 时间戳解析器（带秒级缓存，解析时会更新）
+        mutable TimestampParser timestampParser_;
+        
         /**
          * 尝试用给定的正则表达式解析日志行
          * @param line 日志行内容
          * @param pattern 正则表达式模式
-         * @return 解析成功的 LogEntry 智能指针，失败返回 nullptr
+         * @param entry 解析成功时写入的日志条目
+         * @return 解析是否成功
+         */
+        bool tryParseWithPattern(std::string_view line, const std::regex& pattern, LogEntry& entry) const;
+        
+        /**
+         * 尝试用内置格式扫描器解析日志行
+         * @param line 日志行内容
+         * @param format 内置日志格式
+         * @param entry 解析成功时写入的日志条目
+         * @return 解析是否成功
+         */
+        bool tryParseWithFormat(std::string_view line, LogFormat format, LogEntry& entry) const;
+        
+        /**
+         * 把成功解析且满足观察条件的日志计入已启用的近似统计和模板挖掘
+         * @param entry 日志条目
+         */
+        void observeEntry(const LogEntry& entry) {
+            if (!sketches_ && !templateMiner_) {
+                return;
+            }
+            if (observeFilter_ && !observeFilter_(entry)) {
+                return;
+            }
+            if (sketches_) {
+                sketches_->add(entry);
+            }
+            if (templateMiner_) {
+                templateMiner_->add(entry.getMessage());
+            }
+        }
+        
+        /**
+         * 由已切分好的字段构造日志条目
+         * @param timestampStr 时间戳字段
+         * @param levelStr 级别字段
+         * @param sourceStr 来源字段
+         * @param messageStr 消息字段
+         * @param entry 构造成功时写入的日志条目
+         * @return 构造是否成功
+         */
+        bool makeEntry(std::string_view timestampStr,
+                       std::string_view levelStr,
+                       std::string_view sourceStr,
+                       std::string_view messageStr,
+                       LogEntry& entry) const;
+        
+        /**
+         * 将缓冲区切分为按换行对齐的区间并在多个线程上并行解析
+         * @param buffer 日志内容
+         * @param threads 线程数
+         * @return 按原始顺序拼接的日志条目
+         */
+        std::vector<LogEntry> parseBufferParallel(std::string_view buffer, unsigned threads);
+        
+        /**
+         * 解压压缩文件，按顺序把解压结果以完整行为单位交给回调
+         * 跨越解压块边界的行先拼接再交付；只有最后一段可能不以换行符结尾
+         * @param data 压缩文件内容
+         * @param onLines 回调，参数为若干完整的行，仅在回调期间有效
+         * @throws std::runtime_error 如果格式不受支持或数据损坏
          */
-        std::unique_ptr<LogEntry> tryParseWithPattern(const std::string& line, 
-                                                     const std::regex& pattern) const;
+        void forEachDecompressedLines(std::string_view data, const std::function<void(std::string_view)>& onLines);
         
         /**
-         * 解析时间戳字符串
+         * 逐条解析整个日志文件（parseFile 与 parseFileBatches 的共同部分，不管理消息内存）
+         * @param filename 日志文件名，"-" 表示标准输入
+         * @param callback 每条解析成功的日志调用一次
+         * @param onWindow 非空时映射文件的每个整行窗口交给它解析，不再逐条调用 callback
+         * @throws std::runtime_error 如果文件无法打开或压缩数据无法解压
+         */
+        void scanFile(const std::string& filename, const EntryCallback& callback,
+                      const std::function<void(std::string_view)>& onWindow = {});
+        
+        /**
+         * 解析时间戳字符串（保留毫秒），无法识别时返回当前时间
          * @param timestampStr 时间戳字符串
          * @return 转换后的时间点
          */
-        std::chrono::system_clock::time_point parseTimestamp(const std::string& timestampStr) const;
+        std::chrono::system_clock::time_point parseTimestamp(std::string_view timestampStr) const;
 
     public:
         /**
@@ -78,24 +205,69 @@ namespace LogAnalyzer {
         bool addCustomPattern(const std::string& pattern);
         
         /**
-         * 解析单行日志
+         * 获取自定义模式的哈希（按添加顺序），写入旁路索引的签名
+         * @return 哈希值，没有自定义模式时为 0
+         */
+        std::uint64_t getPatternHash() const { return patternHash_; }
+        
+        /**
+         * 解析单行日志，结果直接写入调用方提供的条目，不做堆分配
+         * （消息写入当前线程的 MessageArena，可用 MessageArena::Scope 指定按批重置的内存池）
+         * @param line 日志行内容（可以直接指向映射文件中的字节）
+         * @param entry 解析成功时写入的日志条目
+         * @return 解析是否成功
+         */
+        bool parseLine(std::string_view line, LogEntry& entry);
+        
+        /**
+         * 解析单行日志（便捷版本，每次调用分配一个 LogEntry）
+         * 消息同样写入当前内存池；逐行反复调用的代码应改用上面的版本，
+         * 并在按批重置的 MessageArena::Scope 内解析，否则消息留在线程默认内存池中不会释放
          * @param line 日志行内容
          * @return 解析成功的 LogEntry 智能指针，失败返回 nullptr
          */
-        std::unique_ptr<LogEntry> parseLine(const std::string& line);
+        std::unique_ptr<LogEntry> parseLine(std::string_view line);
         
         /**
          * 解析整个日志文件
+         * 普通文件通过 mmap 零拷贝读取，管道等无法映射的输入回退到流式读取；
+         * gzip/zstd/lz4 压缩文件按文件头识别，边解压边解析；
+         * 文件名为 "-" 时读取标准输入
          * @param filename 日志文件名
          * @return 包含所有解析成功的日志条目的向量
-         * @throws std::runtime_error 如果文件无法打开
+         * @throws std::runtime_error 如果文件无法打开或压缩数据无法解压
          */
         std::vector<LogEntry> parseFile(const std::string& filename);
         
+        /**
+         * 逐条解析整个日志文件，结果交给回调处理而不保存
+         * 输入的识别与 parseFile 相同。消息写入按块重置的临时内存池，普通文件按窗口扫描并
+         * 丢弃已读过的映射页，内存占用与文件大小无关；条目只在回调期间有效
+         * @param filename 日志文件名
+         * @param callback 每条解析成功的日志调用一次
+         * @throws std::runtime_error 如果文件无法打开或压缩数据无法解压
+         */
+        void parseFile(const std::string& filename, const EntryCallback& callback);
+        
+        /**
+         * 按固定大小的批次解析整个日志文件
+         * 输入的识别和内存占用与逐条的 parseFile 相同；临时内存池只在批次交付之后重置，
+         * 批次中的消息在回调期间一直有效。批次向量在各批之间复用，不重新分配。
+         * 线程数大于 1 时映射文件的每个窗口分块并行解析，窗口内的条目全部交付后才重置内存池
+         * @param filename 日志文件名
+         * @param batchSize 每批的条目数（文件或并行解析的窗口的最后一批可能更少）
+         * @param callback 每批调用一次
+         * @throws std::invalid_argument 如果批次大小为零
+         * @throws std::runtime_error 如果文件无法打开或压缩数据无法解压（尚未交付的条目被丢弃）
+         */
+        void parseFileBatches(const std::string& filename, size_t batchSize, const BatchCallback& callback);
+        
         /**
          * 解析多个日志文件
+         * 线程数大于 1 时各文件并发解析；每个文件的结果先保证有序（通常已按时间排列），
+         * 再通过 k 路堆归并合并，避免对全部条目做一次全局排序
          * @param filenames 日志文件名列表
-         * @return 包含所有解析成功的日志条目的向量
+         * @return 按时间戳排序的全部日志条目（时间相同时保持文件顺序）
          */
         std::vector<LogEntry> parseFiles(const std::vector<std::string>& filenames);
         
@@ -106,10 +278,211 @@ namespace LogAnalyzer {
          */
         std::vector<LogEntry> parseStream(std::istream& input);
         
+        /**
+         * 解析内存中的日志内容（按 '\n' 切分行，不拷贝行数据）
+         * @param buffer 日志内容
+         * @return 包含所有解析成功的日志条目的向量
+         */
+        std::vector<LogEntry> parseBuffer(std::string_view buffer);
+        
+        /**
+         * 解析内存中的日志内容并追加到调用方提供的批次中（单线程）
+         * 调用方可以复用同一个批次（clear 后保留容量），与按批重置的 MessageArena 配合时
+         * 稳定状态下每行没有堆分配
+         * @param buffer 日志内容
+         * @param batch 追加结果的批次
+         * @return 本次追加的条目数
+         */
+        size_t parseBuffer(std::string_view buffer, std::vector<LogEntry>& batch);
+        
+        /**
+         * 逐条解析输入流，结果交给回调处理而不保存
+         * @param input 输入流引用
+         * @param callback 每条解析成功的日志调用一次
+         */
+        void parseStream(std::istream& input, const EntryCallback& callback);
+        
+        /**
+         * 逐条解析内存中的日志内容，结果交给回调处理而不保存
+         * @param buffer 日志内容
+         * @param callback 每条解析成功的日志调用一次
+         */
+        void parseBuffer(std::string_view buffer, const EntryCallback& callback);
+        
+        /**
+         * 只解析文件末尾的 N 条日志
+         * 普通文件从文件末尾反向逐行扫描，取够 N 条即停止；
+         * 无法映射的输入顺序读取并用 N 条的环形缓冲区保留最后的结果。
+         * 内存占用与 N 成正比，与文件大小无关
+         * @param filename 日志文件名
+         * @param count 需要的条数
+         * @param filter 过滤谓词，为空时保留所有条目
+         * @return 按文件顺序排列的最后 N 条日志
+         * @throws std::runtime_error 如果文件无法打开
+         */
+        std::vector<LogEntry> parseTail(const std::string& filename, size_t count,
+                                        const EntryFilter& filter = EntryFilter());
+        
+        /**
+         * 取多个文件合并后按时间排序的最后 N 条日志（假定各文件内部按时间排列）
+         * @param filenames 日志文件名列表
+         * @param count 需要的条数
+         * @param filter 过滤谓词，为空时保留所有条目
+         * @return 按时间戳排序的最后 N 条日志
+         */
+        std::vector<LogEntry> parseFilesTail(const std::vector<std::string>& filenames, size_t count,
+                                             const EntryFilter& filter = EntryFilter());
+        
+        /**
+         * 判断文件能否使用持久化索引（TimeIndex / KeywordIndex）：可以映射且未压缩
+         * @param filename 日志文件名，"-" 表示标准输入
+         */
+        static bool supportsIndex(const std::string& filename);
+        
+        /**
+         * 只解析时间范围 [begin, end) 内的日志
+         * 普通文件借助持久化时间索引（见 TimeIndex）只映射并解析相关的字节区间；
+         * 标准输入等无法映射的输入完整解析后再过滤。统计信息只包含实际解析的行
+         * @param filename 日志文件名
+         * @param begin 起始时间（含）
+         * @param end 结束时间（不含）
+         * @return 范围内的日志条目（文件顺序）
+         * @throws std::runtime_error 如果文件无法打开
+         */
+        std::vector<LogEntry> parseFileRange(const std::string& filename,
+                                             const std::chrono::system_clock::time_point& begin,
+                                             const std::chrono::system_clock::time_point& end);
+        
+        /**
+         * 解析多个文件中时间范围 [begin, end) 内的日志并按时间戳合并
+         * @param filenames 日志文件名列表
+         * @param begin 起始时间（含）
+         * @param end 结束时间（不含）
+         * @return 按时间戳排序的日志条目
+         */
+        std::vector<LogEntry> parseFilesInRange(const std::vector<std::string>& filenames,
+                                                const std::chrono::system_clock::time_point& begin,
+                                                const std::chrono::system_clock::time_point& end);
+        
+        /**
+         * 只解析消息满足关键词查询的日志
+         * 普通文件借助持久化关键词倒排索引（见 KeywordIndex）只解析候选行；
+         * 标准输入等无法映射的输入完整解析后再过滤。统计信息只包含实际解析的行
+         * @param filename 日志文件名
+         * @param query 关键词查询
+         * @return 满足查询的日志条目（文件顺序）
+         * @throws std::runtime_error 如果文件无法打开
+         */
+        std::vector<LogEntry> parseFileMatching(const std::string& filename, const KeywordQuery& query);
+        
+        /**
+         * 解析多个文件中满足关键词查询的日志并按时间戳合并
+         * @param filenames 日志文件名列表
+         * @param query 关键词查询
+         * @return 按时间戳排序的日志条目
+         */
+        std::vector<LogEntry> parseFilesMatching(const std::vector<std::string>& filenames,
+                                                 const KeywordQuery& query);
+        
+        /**
+         * 一次扫描原始字节找出包含任一签名的行，只解析这些行
+         * 签名匹配针对整行原始文本（类似 grep -F），标准输入按整行对齐的分段读入后逐段扫描
+         * @param filename 日志文件名
+         * @param matcher 多模式匹配器
+         * @param hitCounts 按签名编号累加通过过滤的命中行数（大小不足时自动扩展）
+         * @param filter 过滤谓词，为空时保留所有条目
+         * @return 命中且通过过滤的日志条目（文件顺序）
+         * @throws std::runtime_error 如果文件无法打开
+         */
+        std::vector<LogEntry> parseFileMatching(const std::string& filename, const MultiPatternMatcher& matcher,
+                                                std::vector<size_t>& hitCounts,
+                                                const EntryFilter& filter = EntryFilter());
+        
+        /**
+         * 在内存缓冲区中查找包含任一签名的行并解析
+         * @param buffer 日志内容
+         * @param matcher 多模式匹配器
+         * @param hitCounts 按签名编号累加通过过滤的命中行数
+         * @param filter 过滤谓词，为空时保留所有条目
+         * @return 命中且通过过滤的日志条目（缓冲区顺序）
+         */
+        std::vector<LogEntry> parseBufferMatching(std::string_view buffer, const MultiPatternMatcher& matcher,
+                                                  std::vector<size_t>& hitCounts,
+                                                  const EntryFilter& filter = EntryFilter());
+        
+        /**
+         * 解析多个文件中包含任一签名的行并按时间戳合并
+         * @param filenames 日志文件名列表
+         * @param matcher 多模式匹配器
+         * @param hitCounts 按签名编号累加通过过滤的命中行数
+         * @param filter 过滤谓词，为空时保留所有条目
+         * @return 按时间戳排序的日志条目
+         */
+        std::vector<LogEntry> parseFilesMatching(const std::vector<std::string>& filenames,
+                                                 const MultiPatternMatcher& matcher,
+                                                 std::vector<size_t>& hitCounts,
+                                                 const EntryFilter& filter = EntryFilter());
+        
+        /**
+         * 设置解析单个文件时使用的线程数
+         * 大文件会被切分为按换行对齐的字节区间，每个区间由独立的工作解析器处理
+         * @param threads 线程数，0 表示使用全部硬件线程
+         */
+        void setThreadCount(unsigned threads);
+        unsigned getThreadCount() const { return threadCount_; }
+        
+        /**
+         * 设置字段投影：行仍会完整校验格式，但只解码需要的字段，
+         * 例如只统计级别时跳过时间戳换算、来源登记和消息拷贝
+         * @param fields ParseField 的按位组合
+         */
+        void setFieldMask(unsigned fields) { fieldMask_ = fields; }
+        unsigned getFieldMask() const { return fieldMask_; }
+        
+        /**
+         * 启用近似统计：之后每条成功解析的日志都计入草图（需要解码来源和消息字段）。
+         * 工作解析器各自维护一份草图，随统计信息一起合并
+         * @param options 精度设置
+         * @throws std::invalid_argument 如果精度设置超出范围
+         */
+        void enableSketches(const SketchOptions& options);
+        const LogSketches* getSketches() const { return sketches_.get(); }
+        
+        /**
+         * 启用消息模板挖掘：之后每条成功解析的日志的消息都计入模板树（需要解码消息字段）。
+         * 工作解析器各自维护一棵树，随统计信息按顺序合并
+         * @param options 挖掘参数
+         * @throws std::invalid_argument 如果参数超出范围
+         */
+        void enableTemplateMining(const TemplateMinerOptions& options);
+        const TemplateMiner* getTemplateMiner() const { return templateMiner_.get(); }
+        
+        /**
+         * 设置近似统计和模板挖掘的观察条件：只有满足条件的日志才计入（条件用到的字段需要在字段掩码中）。
+         * 工作解析器沿用同一条件
+         * @param filter 过滤谓词，为空时计入全部成功解析的日志
+         */
+        void setObserveFilter(EntryFilter filter) { observeFilter_ = std::move(filter); }
+        
+        /**
+         * 合并另一个解析器的统计信息（包括近似统计和模板挖掘）
+         * @param other 工作解析器
+         */
+        void mergeStats(const LogParser& other);
+        
+        /**
+         * 创建与当前解析器配置相同（自定义模式、字段投影）、统计信息独立的单线程解析器
+         * 用于工作线程，或建立索引等不应计入本解析器统计的辅助扫描
+         * @return 单线程工作解析器
+         */
+        std::unique_ptr<LogParser> createWorker() const;
+        
         // 统计信息访问器
         size_t getTotalLines() const { return totalLines_; }
         size_t getParsedLines() const { return parsedLines_; }
         size_t getErrorLines() const { return errorLines_; }
+        size_t getFormatMatches(LogFormat format) const { return formatMatches_[static_cast<size_t>(format)]; }
+        size_t getCustomPatternMatches() const { return customMatches_; }
         double getParseSuccessRate() const;
         
         /**
@@ -0,0 +1,104 @@
+/*
+ * LogPipeline.h
+ * 按批推送的日志处理流水线：来源 → 解析 → 过滤 → 聚合/输出
+ */
+
+#pragma once
+
+#include "LogParser.h"
+#include "FilterStage.h"
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    // 接收阶段：处理一批通过全部过滤阶段的条目（聚合或输出），条目只在调用期间有效
+    using BatchSink = std::function<void(const std::vector<LogEntry>& batch)>;
+
+    /**
+     * 日志处理流水线
+     * 来源为日志文件列表（"-" 表示标准输入），由 LogParser::parseFileBatches 逐个文件解析成
+     * 固定大小的批次；每批先经过全部过滤阶段，再依次推给各接收阶段，之后批次向量和消息内存即被复用，
+     * 内存占用只与批次大小有关，与文件大小无关。
+     * 过滤阶段融合为一次遍历：每个条目按阶段代价从低到高（FilterKind 的顺序）检查，任一条件不满足即跳过，
+     * 通过的条目在批内原地前移，不产生中间向量。
+     * 条目按文件顺序及文件内的原始顺序到达，不做跨文件的时间排序，适合计数、聚合等与顺序无关的阶段。
+     */
+    class LogPipeline {
+    public:
+        // 默认批次大小（条目数）
+        static constexpr size_t DEFAULT_BATCH_SIZE = 4096;
+
+    private:
+        LogParser& parser_;
+        size_t batchSize_;
+        std::vector<FilterStage> filters_;   // 按 FilterKind 排序
+        std::vector<BatchSink> sinks_;
+        std::uint64_t parsedEntries_;
+        std::uint64_t passedEntries_;
+
+        /**
+         * 过滤一批条目并推给各接收阶段
+         */
+        void process(std::vector<LogEntry>& batch);
+
+    public:
+        /**
+         * 构造函数
+         * @param parser 解析器（字段投影、自定义模式和统计都沿用它的设置）
+         * @param batchSize 每批的条目数
+         * @throws std::invalid_argument 如果批次大小为零
+         */
+        explicit LogPipeline(LogParser& parser, size_t batchSize = DEFAULT_BATCH_SIZE);
+
+        /**
+         * 添加过滤阶段
+         * @param stage 过滤阶段
+         * @return 流水线本身，便于连续添加
+         */
+        LogPipeline& addFilter(FilterStage stage);
+
+        /**
+         * 添加接收阶段，按添加顺序调用
+         * @param sink 接收阶段
+         * @return 流水线本身，便于连续添加
+         */
+        LogPipeline& addSink(BatchSink sink);
+
+        /**
+         * 判断一条日志是否通过全部过滤阶段
+         * @param entry 日志条目
+         */
+        bool matches(const LogEntry& entry) const;
+
+        /**
+         * 就地过滤一批条目，保持原有顺序
+         * @param batch 条目批次
+         * @return 保留的条目数
+         */
+        size_t filter(std::vector<LogEntry>& batch) const;
+
+        /**
+         * 把全部过滤阶段组合成逐条的过滤谓词（供跟踪、末尾读取等逐条处理的路径使用）
+         * @return 过滤谓词；没有过滤阶段时为空
+         */
+        EntryFilter entryFilter() const;
+
+        /**
+         * 依次处理各文件；单个文件无法读取或解压时报告错误并继续处理其余文件
+         * @param filenames 日志文件名列表
+         * @throws 过滤或接收阶段抛出的异常原样传出
+         */
+        void run(const std::vector<std::string>& filenames);
+
+        // 访问器
+        bool hasFilters() const { return !filters_.empty(); }
+        size_t batchSize() const { return batchSize_; }
+        std::uint64_t parsedEntries() const { return parsedEntries_; }   // 解析成功的条目数
+        std::uint64_t passedEntries() const { return passedEntries_; }   // 通过过滤的条目数
+    };
+
+} // namespace LogAnalyzer
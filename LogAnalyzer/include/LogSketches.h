@@ -0,0 +1,138 @@
+/*
+ * LogSketches.h
+ * 解析过程中维护的近似统计草图
+ */
+
+#pragma once
+
+#include "LogEntry.h"
+#include "HyperLogLog.h"
+#include "CountMinSketch.h"
+#include "SpaceSaving.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    class LogStore;
+
+    /**
+     * 近似统计的精度设置
+     */
+    struct SketchOptions {
+        unsigned hllPrecision = 14;    // HyperLogLog 精度，相对误差约 1.04 / sqrt(2^精度)
+        double cmsError = 0.001;       // Count-Min 误差上限占总条数的比例
+        double cmsConfidence = 0.99;   // Count-Min 误差不超过上限的概率
+        size_t capacity = 256;         // Space-Saving 跟踪的值的个数
+    };
+
+    /**
+     * 日志近似统计
+     * 对每条日志更新一组固定大小的草图，内存与日志条数和不同值个数无关：
+     * HyperLogLog 估计不同消息、不同消息模板和不同来源的个数；
+     * Space-Saving 跟踪最常见的来源和消息模板，Count-Min 给出它们频次的另一个上界，报告时取两者较小值。
+     * 消息模板是把消息中的数字串替换为 # 后的文本。
+     * 每个解析线程各自维护一份，最后合并；不同文件的草图同样可以合并。
+     */
+    class LogSketches {
+    public:
+        /**
+         * 高频项
+         */
+        struct HeavyHitter {
+            std::string label;
+            std::uint64_t estimate;     // 频次上界
+            std::uint64_t lowerBound;   // 频次下界
+        };
+
+    private:
+        SketchOptions options_;
+        std::uint64_t entries_;
+        HyperLogLog distinctMessages_;
+        HyperLogLog distinctTemplates_;
+        HyperLogLog distinctSources_;
+        CountMinSketch sourceFrequency_;
+        CountMinSketch templateFrequency_;
+        SpaceSaving topSources_;
+        SpaceSaving topTemplates_;
+
+        /**
+         * 由 Space-Saving 的候选和 Count-Min 的估计得到高频项
+         */
+        static std::vector<HeavyHitter> heavyHitters(const SpaceSaving& candidates,
+                                                     const CountMinSketch& frequency, size_t count);
+
+    public:
+        /**
+         * 构造函数
+         * @param options 精度设置
+         * @throws std::invalid_argument 如果精度设置超出范围
+         */
+        explicit LogSketches(const SketchOptions& options = SketchOptions());
+
+        /**
+         * 计入一条日志
+         * @param sourceId 来源编号
+         * @param message 消息内容
+         */
+        void add(std::uint32_t sourceId, std::string_view message);
+
+        /**
+         * 计入一条日志
+         * @param entry 日志条目
+         */
+        void add(const LogEntry& entry) { add(entry.getSourceId(), entry.getMessage()); }
+
+        /**
+         * 计入存储中 [begin, end) 行（只读取来源和消息列）
+         * @param store 列式存储
+         * @param begin 起始行
+         * @param end 结束行（不含）
+         */
+        void addRange(const LogStore& store, size_t begin, size_t end);
+
+        /**
+         * 合并另一份草图（精度设置必须相同）
+         * @param other 另一份草图
+         * @throws std::invalid_argument 如果精度设置不同
+         */
+        void merge(const LogSketches& other);
+
+        /**
+         * 消息模板：数字串替换为 #
+         * @param message 消息内容
+         * @return 模板文本
+         */
+        static std::string messageTemplate(std::string_view message);
+
+        // 不同值个数的估计
+        double distinctMessages() const { return distinctMessages_.estimate(); }
+        double distinctTemplates() const { return distinctTemplates_.estimate(); }
+        double distinctSources() const { return distinctSources_.estimate(); }
+
+        /**
+         * 最常见的来源
+         * @param count 个数
+         * @return 按频次上界递减排列
+         */
+        std::vector<HeavyHitter> topSources(size_t count) const;
+
+        /**
+         * 最常见的消息模板
+         * @param count 个数
+         * @return 按频次上界递减排列
+         */
+        std::vector<HeavyHitter> topTemplates(size_t count) const;
+
+        // 访问器
+        const SketchOptions& options() const { return options_; }
+        std::uint64_t entries() const { return entries_; }
+        double distinctError() const { return distinctMessages_.relativeError(); }
+        std::uint64_t frequencyErrorBound() const;
+        size_t memoryBytes() const;
+    };
+
+} // namespace LogAnalyzer
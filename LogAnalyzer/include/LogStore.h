@@ -0,0 +1,198 @@
+/*
+ * LogStore.h
+ * 列式（结构数组）日志存储
+ */
+
+#pragma once
+
+#include "LogEntry.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <array>
+#include <unordered_map>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    class MappedFile;
+
+    /**
+     * 只读列视图
+     * 指向自有列或快照映射中的连续数据
+     */
+    template <typename T>
+    class ColumnView {
+    private:
+        const T* data_;
+        size_t size_;
+
+    public:
+        ColumnView(const T* data, size_t size) : data_(data), size_(size) {}
+
+        const T* data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const T* begin() const { return data_; }
+        const T* end() const { return data_ + size_; }
+        const T& operator[](size_t index) const { return data_[index]; }
+    };
+
+    /**
+     * 列式日志存储类
+     * 时间戳、级别、来源编号和消息偏移各自保存在连续的列中，
+     * 统计和过滤只扫描需要的列；消息内容集中保存在一块连续的字节区。
+     * 存储可以保存为二进制快照文件，载入时直接 mmap，各列指向映射内存，不逐条分配。
+     */
+    class LogStore {
+    private:
+        // 自有数据：由日志条目构建时使用
+        std::vector<std::int64_t> timestamps_;      // 纪元以来的纳秒数
+        std::vector<std::uint8_t> levels_;          // LogLevel 的数值
+        std::vector<std::uint32_t> sourceIds_;      // SourceTable 编号
+        std::vector<std::uint64_t> messageOffsets_; // 第 i 条消息为 [offsets[i], offsets[i+1])
+        std::string messageData_;                   // 全部消息内容
+
+        // 快照映射：从快照载入时各列指向映射内存（来源编号需要重映射时除外）
+        std::shared_ptr<const MappedFile> snapshot_;
+
+        // 当前各列的位置
+        const std::int64_t* timestampColumn_;
+        const std::uint8_t* levelColumn_;
+        const std::uint32_t* sourceIdColumn_;
+        const std::uint64_t* offsetColumn_;
+        const char* messageColumn_;
+        size_t size_;
+        bool sorted_;                               // 时间戳列是否非递减
+
+        /**
+         * 让列指针指向自有数据（自有数据可能已重新分配或随对象移动）
+         */
+        void bindColumns();
+
+        /**
+         * 把快照中的数据拷贝为自有数据，之后才能修改
+         */
+        void detachSnapshot();
+
+    public:
+        using TimePoint = std::chrono::system_clock::time_point;
+
+        /**
+         * 默认构造函数
+         */
+        LogStore();
+
+        /**
+         * 拷贝与移动（快照映射在副本之间共享）
+         */
+        LogStore(const LogStore& other);
+        LogStore(LogStore&& other) noexcept;
+        LogStore& operator=(const LogStore& other);
+        LogStore& operator=(LogStore&& other) noexcept;
+
+        /**
+         * 由日志条目构造列式存储
+         * 消息拷贝进存储自己的连续缓冲区，与条目引用的内存池无关；构造期间两份消息同时存在
+         * @param entries 日志条目
+         * @return 列式存储
+         */
+        static LogStore fromEntries(const std::vector<LogEntry>& entries);
+
+        /**
+         * 载入快照文件
+         * 各列直接指向 mmap 的文件内容；来源字典登记到当前进程的 SourceTable，
+         * 编号与保存时不一致时才生成重映射后的来源列。
+         * 只校验文件头、各区段范围和来源字典，不逐行扫描各列，载入耗时与条目数无关；
+         * 损坏的单行在访问时按空消息或 UNKNOWN 级别处理，不会越界访问
+         * @param filename 快照文件名
+         * @return 列式存储
+         * @throws std::runtime_error 如果文件无法打开、不是快照文件或已损坏
+         */
+        static LogStore loadSnapshot(const std::string& filename);
+
+        /**
+         * 保存为快照文件（先写临时文件再重命名）
+         * @param filename 快照文件名
+         * @throws std::runtime_error 如果文件无法写入
+         */
+        void saveSnapshot(const std::string& filename) const;
+
+        /**
+         * 预留容量
+         * @param entries 条目数
+         * @param messageBytes 消息总字节数
+         */
+        void reserve(size_t entries, size_t messageBytes = 0);
+
+        /**
+         * 追加一条日志
+         * @param entry 日志条目
+         */
+        void append(const LogEntry& entry);
+
+        /**
+         * 清空全部数据
+         */
+        void clear();
+
+        // 基本信息
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        bool isSorted() const { return sorted_; }
+        bool isSnapshot() const { return snapshot_ != nullptr; }
+
+        // 列访问器
+        ColumnView<std::int64_t> timestamps() const { return ColumnView<std::int64_t>(timestampColumn_, size_); }
+        ColumnView<std::uint8_t> levels() const { return ColumnView<std::uint8_t>(levelColumn_, size_); }
+        ColumnView<std::uint32_t> sourceIds() const { return ColumnView<std::uint32_t>(sourceIdColumn_, size_); }
+        ColumnView<std::uint64_t> messageOffsets() const { return ColumnView<std::uint64_t>(offsetColumn_, size_ + 1); }
+        std::string_view messageData() const {
+            return std::string_view(messageColumn_, static_cast<size_t>(offsetColumn_[size_]));
+        }
+
+        // 单行访问器
+        TimePoint timestampAt(size_t index) const;
+        LogLevel levelAt(size_t index) const { return static_cast<LogLevel>(levelColumn_[index]); }
+        std::uint32_t sourceIdAt(size_t index) const { return sourceIdColumn_[index]; }
+        std::string_view messageAt(size_t index) const;
+
+        /**
+         * 统计各级别数量（只扫描级别列）
+         * @return 按 LogLevel 数值索引的计数
+         */
+        std::array<size_t, LOG_LEVEL_COUNT> countByLevel() const;
+
+        /**
+         * 选出指定级别的行号（只扫描级别列）
+         * @param level 日志级别
+         * @return 升序行号列表
+         */
+        std::vector<size_t> selectByLevel(LogLevel level) const;
+
+        /**
+         * 选出时间落在 [begin, end) 的行号（时间戳列有序时二分查找）
+         * @param begin 起始时间（含）
+         * @param end 结束时间（不含）
+         * @return 升序行号列表
+         */
+        std::vector<size_t> selectTimeRange(const TimePoint& begin, const TimePoint& end) const;
+
+        /**
+         * 按来源分组计数（只扫描来源列）
+         * @return 来源编号到条目数的映射
+         */
+        std::unordered_map<std::uint32_t, size_t> countBySource() const;
+
+        /**
+         * 按行号列表抽取一个新的存储
+         * @param indices 升序行号列表
+         * @return 只包含选中行的新存储
+         */
+        LogStore select(const std::vector<size_t>& indices) const;
+    };
+
+} // namespace LogAnalyzer
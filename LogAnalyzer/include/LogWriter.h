@@ -0,0 +1,166 @@
+/*
+ * LogWriter.h
+ * 批量异步输出日志条目
+ */
+
+#pragma once
+
+#include "LogEntry.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    class LogStore;
+
+    /**
+     * 日志输出器
+     * 把条目按 "[YYYY-MM-DD HH:MM:SS] [LEVEL] [source] message" 的格式（与 LogEntry::toString 相同）
+     * 直接渲染进大块缓冲区，写满后交给专用的写线程用 write(2) 整块写出，渲染与写出并行进行。
+     * 逐行没有堆分配：时间戳按秒缓存格式化结果（同一秒内的条目只做一次 localtime_r），
+     * 来源名称直接从 SourceTable 无锁读取。缓冲区最多 BUFFER_COUNT 块循环使用，写出跟不上时渲染方等待。
+     * 与 std::cout 混用时，先刷新 std::cout 再创建输出器，输出器 flush 或析构之后再使用 std::cout。
+     * 非线程安全：只能由一个线程调用写入方法。
+     */
+    class LogWriter {
+    public:
+        // 默认缓冲区大小
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+
+        // 循环使用的缓冲区数量（含正在渲染的一块）
+        static constexpr size_t BUFFER_COUNT = 4;
+
+    private:
+        struct Buffer {
+            std::unique_ptr<char[]> data;
+            size_t size = 0;
+        };
+
+        int fd_;
+        size_t bufferSize_;
+
+        // 正在渲染的缓冲区
+        Buffer current_;
+        size_t allocated_;
+
+        // 写线程与渲染方共享的状态
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<Buffer> full_;        // 等待写出的缓冲区
+        std::vector<Buffer> free_;       // 已写出、可复用的缓冲区
+        bool writing_;                   // 写线程正在写出一块
+        bool stop_;
+        int error_;                      // 第一次写出失败的 errno，0 表示没有失败
+        std::uint64_t bytesWritten_;
+        std::thread thread_;
+
+        // 时间戳缓存：上一次格式化的秒数及其文本
+        std::int64_t cachedSecond_;
+        char cachedTime_[32];
+        size_t cachedTimeLength_;
+
+        /**
+         * 写线程主循环
+         */
+        void run();
+
+        /**
+         * 把 size 字节整块写到文件描述符，处理部分写入和 EINTR
+         * @return 0 或失败时的 errno
+         */
+        int writeAll(const char* data, size_t size);
+
+        /**
+         * 把当前缓冲区交给写线程，并换一块空缓冲区
+         */
+        void submit();
+
+        /**
+         * 追加文本（慢速路径：跨越缓冲区边界）
+         */
+        void appendSlow(std::string_view text);
+
+        /**
+         * 追加文本
+         */
+        void append(std::string_view text) {
+            if (text.size() <= bufferSize_ - current_.size) {
+                std::char_traits<char>::copy(current_.data.get() + current_.size, text.data(), text.size());
+                current_.size += text.size();
+            } else {
+                appendSlow(text);
+            }
+        }
+
+    public:
+        /**
+         * 构造函数：启动写线程
+         * @param fd 输出的文件描述符（不接管其所有权）
+         * @param bufferSize 每块缓冲区的大小
+         * @throws std::invalid_argument 如果缓冲区大小为零
+         */
+        explicit LogWriter(int fd, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+        /**
+         * 析构函数：写出剩余内容并结束写线程（不报告错误，需要检查错误时先调用 flush）
+         */
+        ~LogWriter();
+
+        LogWriter(const LogWriter&) = delete;
+        LogWriter& operator=(const LogWriter&) = delete;
+
+        /**
+         * 写入一条日志（末尾加换行符）
+         * @param timestampNanos 纪元以来的纳秒数
+         * @param level 日志级别
+         * @param sourceId SourceTable 中的来源编号
+         * @param message 消息内容
+         */
+        void writeEntry(std::int64_t timestampNanos, LogLevel level, std::uint32_t sourceId, std::string_view message);
+
+        /**
+         * 写入一条日志（末尾加换行符）
+         * @param entry 日志条目
+         */
+        void writeEntry(const LogEntry& entry);
+
+        /**
+         * 写入存储中 [begin, end) 行的日志，直接读取各列
+         * @param store 列式存储
+         * @param begin 起始行
+         * @param end 结束行（不含）
+         */
+        void writeRange(const LogStore& store, size_t begin, size_t end);
+
+        /**
+         * 写入原样文本
+         * @param text 文本内容
+         */
+        void write(std::string_view text) { append(text); }
+
+        /**
+         * 获取格式化后的时间戳 "YYYY-MM-DD HH:MM:SS"（本地时间，按秒缓存）
+         * @param timestampNanos 纪元以来的纳秒数
+         * @return 指向内部缓存的视图，下一次调用前有效
+         */
+        std::string_view formattedTime(std::int64_t timestampNanos);
+
+        /**
+         * 写出全部已渲染的内容并等待完成
+         * @throws std::runtime_error 如果写出失败
+         */
+        void flush();
+
+        // 已写出的字节数
+        std::uint64_t bytesWritten();
+    };
+
+} // namespace LogAnalyzer
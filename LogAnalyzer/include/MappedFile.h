@@ -0,0 +1,104 @@
+/*
+ * MappedFile.h
+ * 只读内存映射文件的 RAII 封装
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    /**
+     * 内存映射文件类
+     * 以只读方式 mmap 整个普通文件，析构时自动解除映射。
+     * 管道、字符设备等无法映射的输入由调用方回退到流式读取。
+     */
+    class MappedFile {
+    public:
+        /**
+         * 访问方式提示
+         *   SEQUENTIAL：整段顺序读取，对整个映射设置 MADV_SEQUENTIAL 并立即预读 (MADV_WILLNEED)
+         *   RANDOM：只读取少量位置（探测压缩格式、文件头哈希、反向扫描末尾等），
+         *           设置 MADV_RANDOM 且不预读，需要顺序读取的区间再用 prefetch 单独预读
+         */
+        enum class Access {
+            SEQUENTIAL,
+            RANDOM
+        };
+
+    private:
+        const char* data_;
+        size_t size_;
+        void* mapBase_;     // 实际映射的起始地址（按页对齐）
+        size_t mapLength_;  // 实际映射的长度
+        bool open_;
+
+    public:
+        /**
+         * 默认构造函数
+         */
+        MappedFile();
+
+        /**
+         * 禁用拷贝，只允许移动
+         */
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        /**
+         * 析构函数，解除映射
+         */
+        ~MappedFile();
+
+        /**
+         * 映射文件并设置访问提示 (madvise)
+         * @param filename 文件名
+         * @param access 访问方式提示
+         * @return 映射是否成功；文件不存在或不是普通文件时返回 false
+         */
+        bool open(const std::string& filename, Access access = Access::SEQUENTIAL);
+        
+        /**
+         * 只映射文件中的一段字节区间（内部按页对齐，view() 返回精确区间）
+         * @param filename 文件名
+         * @param offset 起始偏移
+         * @param length 长度，超出文件末尾的部分被截去
+         * @param access 访问方式提示
+         * @return 映射是否成功
+         */
+        bool openRange(const std::string& filename, size_t offset, size_t length,
+                       Access access = Access::SEQUENTIAL);
+
+        /**
+         * 对 view() 中的一段区间设置顺序访问提示并预读 (MADV_SEQUENTIAL + MADV_WILLNEED)
+         * 以 RANDOM 方式映射的文件只在真正要扫描的区间上调用
+         * @param offset 相对 view() 起点的偏移
+         * @param length 长度，超出 view() 的部分被截去
+         */
+        void prefetch(size_t offset, size_t length);
+
+        /**
+         * 丢弃 view() 中 offset 之前已经读过的整页 (MADV_DONTNEED)
+         * 顺序扫描大文件时调用，常驻内存不随文件大小增长；之后再访问这些页会重新从文件读取
+         * @param offset 相对 view() 起点的偏移
+         */
+        void discardBefore(size_t offset);
+
+        /**
+         * 解除映射
+         */
+        void close();
+
+        // 访问器
+        bool isOpen() const { return open_; }
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+        std::string_view view() const { return std::string_view(data_, size_); }
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,108 @@
+/*
+ * MultiPatternMatcher.h
+ * 多模式字面量匹配（Aho-Corasick 自动机 + SIMD 首字节预过滤）
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    /**
+     * 多模式匹配器
+     * 把所有签名编译成一个确定性 Aho-Corasick 自动机，一次扫描文本即可找出全部签名的所有出现位置，
+     * 耗时与签名数量无关。
+     * 转移表按字节等价类压缩：没有出现在任何签名中的字节共用一个类。
+     * 自动机处于根状态时，先用首字节预过滤跳到下一个可能开始匹配的位置：
+     * AVX2 下用 nibble 查表（shufti）一次检查 32 字节，只有一个首字节时使用 memchr，其余情况逐字节查表。
+     * 可通过环境变量 LOGANALYZER_SIMD=avx2|sse2|scalar 强制指定预过滤实现。
+     * 匹配区分大小写。
+     */
+    class MultiPatternMatcher {
+    public:
+        /**
+         * 匹配回调
+         * 参数依次为签名编号和匹配结束位置（最后一个字节之后的偏移）
+         */
+        using MatchCallback = std::function<void(size_t, size_t)>;
+
+    private:
+        std::vector<std::string> patterns_;
+        std::array<std::uint16_t, 256> byteClass_;    // 字节到等价类的映射，0 表示不属于任何签名
+        size_t classCount_;
+        std::vector<std::int32_t> transitions_;       // 状态 × 等价类 -> 下一状态
+        std::vector<std::int32_t> patternAt_;         // 在该状态结束的签名编号，-1 表示没有
+        std::vector<std::int32_t> outputLink_;        // 沿失败链最近的有输出的状态，-1 表示没有
+
+        // 首字节预过滤
+        std::array<bool, 256> firstByte_;
+        std::vector<unsigned char> firstBytes_;
+        std::array<std::uint8_t, 16> nibbleLow_;      // 低 4 位 -> 允许的高 4 位集合（位图）
+        std::array<std::uint8_t, 16> nibbleHigh_;     // 高 4 位 -> 对应的位
+        bool asciiFirstBytes_;
+
+        /**
+         * 构建自动机
+         */
+        void build();
+
+        /**
+         * 从 from 开始查找下一个首字节候选位置
+         * @return 候选位置，没有时返回 size
+         */
+        size_t skipToCandidate(const char* data, size_t size, size_t from) const;
+
+        /**
+         * 运行自动机，每次匹配调用 onMatch(签名编号, 结束位置)；onMatch 返回 false 时提前停止
+         */
+        template <typename OnMatch>
+        void run(std::string_view text, OnMatch&& onMatch) const;
+
+    public:
+        /**
+         * 构造函数
+         * @param patterns 签名列表，空串被忽略，重复的签名只保留第一个
+         */
+        explicit MultiPatternMatcher(const std::vector<std::string>& patterns);
+
+        /**
+         * 从文件读取签名，每行一个；忽略空行和以 # 开头的行
+         * @param filename 签名文件名
+         * @return 匹配器
+         * @throws std::runtime_error 如果文件无法打开
+         */
+        static MultiPatternMatcher fromFile(const std::string& filename);
+
+        /**
+         * 扫描文本，报告所有签名的所有出现位置（按结束位置递增）
+         * @param text 文本
+         * @param callback 每次匹配调用一次
+         */
+        void scan(std::string_view text, const MatchCallback& callback) const;
+
+        /**
+         * 判断文本中是否出现任一签名
+         * @param text 文本
+         */
+        bool containsAny(std::string_view text) const;
+
+        /**
+         * 获取当前使用的预过滤实现名称
+         * @return "avx2"、"sse2" 或 "scalar"
+         */
+        static const char* prefilterName();
+
+        // 访问器
+        const std::vector<std::string>& getPatterns() const { return patterns_; }
+        size_t patternCount() const { return patterns_.size(); }
+        size_t stateCount() const { return patternAt_.size(); }
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,221 @@
+/*
+ * PerformanceMonitor.h
+ * 分阶段的耗时、吞吐量与内存统计
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    // 处理流水线的阶段
+    enum class Stage : unsigned {
+        READ = 0,        // 映射文件、读取快照、解压
+        SPLIT,           // 按换行切分
+        PARSE,           // 格式扫描与字段解码（不含时间戳换算）
+        TIMESTAMP,       // 时间戳换算
+        SORT_MERGE,      // 单文件排序与多文件归并
+        STORE,           // 转为列式存储
+        FILTER,          // 级别、时间和关键词过滤
+        AGGREGATE,       // 聚合
+        OUTPUT           // 输出结果
+    };
+
+    // 阶段数量
+    constexpr size_t STAGE_COUNT = 9;
+
+    /**
+     * 性能统计
+     * 与 AllocationCounter 一样是进程级的：各阶段的耗时、字节数和条目数累加到全局原子计数器，
+     * 忙碌时间分主线程和全部线程合计两项记录（工作线程随用随建，不逐个列出）。未启用时所有记录调用只做一次判断，几乎没有开销。
+     * 记录都发生在最内层（计时区间不嵌套），多线程阶段的耗时为各线程之和。
+     */
+    class PerformanceMonitor {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * 一个阶段的累计值
+         */
+        struct StageStats {
+            std::uint64_t nanos;
+            std::uint64_t bytes;
+            std::uint64_t items;
+        };
+
+        /**
+         * 区间计时器：析构时把耗时计入阶段和当前线程的忙碌时间
+         */
+        class Timer {
+        private:
+            Stage stage_;
+            std::uint64_t bytes_;
+            std::uint64_t items_;
+            bool active_;
+            Clock::time_point start_;
+
+        public:
+            explicit Timer(Stage stage, std::uint64_t bytes = 0, std::uint64_t items = 0);
+            ~Timer();
+            Timer(const Timer&) = delete;
+            Timer& operator=(const Timer&) = delete;
+
+            /**
+             * 设置计入的字节数和条目数（在区间结束前得知时使用）
+             */
+            void setVolume(std::uint64_t bytes, std::uint64_t items) {
+                bytes_ = bytes;
+                items_ = items;
+            }
+
+            /**
+             * 提前结束计时（之后析构不再记录）
+             */
+            void stop();
+        };
+
+        /**
+         * 开始统计：记录起始时间，调用线程登记为主线程
+         */
+        static void enable();
+
+        /**
+         * 是否已启用
+         */
+        static bool enabled();
+
+        /**
+         * 计入一个阶段
+         * @param stage 阶段
+         * @param nanos 耗时（纳秒）
+         * @param bytes 处理的字节数
+         * @param items 处理的条目数
+         */
+        static void record(Stage stage, std::uint64_t nanos, std::uint64_t bytes, std::uint64_t items);
+
+        /**
+         * 计入调用线程的忙碌时间
+         * @param nanos 忙碌时间（纳秒）
+         */
+        static void recordBusy(std::uint64_t nanos);
+
+        /**
+         * 获取阶段累计值
+         */
+        static StageStats stage(Stage stage);
+
+        /**
+         * 获取主线程（调用 enable 的线程）的忙碌时间（纳秒）
+         */
+        static std::uint64_t mainThreadBusy();
+
+        /**
+         * 获取全部线程的忙碌时间之和（纳秒），除以总耗时即平均并行度
+         */
+        static std::uint64_t totalBusy();
+
+        /**
+         * 启用以来经过的时间（纳秒）
+         */
+        static std::uint64_t elapsedNanos();
+
+        /**
+         * 进程的峰值常驻内存（字节）
+         */
+        static std::uint64_t peakRssBytes();
+
+        /**
+         * 阶段名称
+         * @param stage 阶段
+         * @param json true 时返回 JSON 中使用的英文键名
+         */
+        static const char* stageName(Stage stage, bool json = false);
+
+        /**
+         * 生成文本报告
+         * @param allocations 统计期间的堆分配次数
+         * @param allocatedBytes 统计期间的堆分配字节数
+         */
+        static std::string textReport(std::uint64_t allocations, std::uint64_t allocatedBytes);
+
+        /**
+         * 生成 JSON 报告（单个对象），便于跟踪性能回归
+         * @param allocations 统计期间的堆分配次数
+         * @param allocatedBytes 统计期间的堆分配字节数
+         */
+        static std::string jsonReport(std::uint64_t allocations, std::uint64_t allocatedBytes);
+    };
+
+    /**
+     * 解析循环的抽样计时
+     * 逐行计时的开销与解析一行相当，因此每 SAMPLE_INTERVAL 行只对一行分别计时切分、扫描和时间戳换算，
+     * 循环结束时按抽样得到的比例把整个循环的实际耗时分摊到 SPLIT、PARSE、TIMESTAMP 三个阶段。
+     * 构造时登记到解析器的抽样指针上，析构时恢复。
+     */
+    class ParseSampler {
+    private:
+        using Clock = PerformanceMonitor::Clock;
+
+        ParseSampler*& slot_;
+        ParseSampler* previous_;
+        bool active_;
+        bool sampling_;
+        unsigned counter_;
+        Clock::time_point start_;
+        std::uint64_t splitNanos_;
+        std::uint64_t scanNanos_;
+        std::uint64_t timestampNanos_;
+        std::uint64_t bytes_;
+        std::uint64_t lines_;
+
+    public:
+        static constexpr unsigned SAMPLE_INTERVAL = 64;
+
+        /**
+         * 构造函数
+         * @param slot 解析器中指向当前抽样器的指针
+         */
+        explicit ParseSampler(ParseSampler*& slot);
+        ~ParseSampler();
+        ParseSampler(const ParseSampler&) = delete;
+        ParseSampler& operator=(const ParseSampler&) = delete;
+
+        /**
+         * 开始处理一行
+         * @return 这一行是否需要计时
+         */
+        bool beginLine() {
+            sampling_ = active_ && counter_++ % SAMPLE_INTERVAL == 0;
+            return sampling_;
+        }
+
+        /**
+         * 结束一行抽样：三个时间点分别为切分开始、解析开始、解析结束
+         */
+        void endLine(Clock::time_point splitStart, Clock::time_point parseStart, Clock::time_point parseEnd);
+
+        /**
+         * 当前行是否在抽样
+         */
+        bool sampling() const { return sampling_; }
+
+        /**
+         * 计入当前行中时间戳换算的耗时
+         */
+        void addTimestamp(std::uint64_t nanos) { timestampNanos_ += nanos; }
+
+        /**
+         * 计入循环处理的数据量
+         */
+        void addVolume(std::uint64_t bytes, std::uint64_t lines) {
+            bytes_ += bytes;
+            lines_ += lines;
+        }
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,143 @@
+/*
+ * ReportWriter.h
+ * 流式生成 JSON / CSV / HTML 报告
+ */
+
+#pragma once
+
+#include "LogEntry.h"
+#include "LogWriter.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    class LogStore;
+    class LogAggregator;
+
+    // 报告格式
+    enum class ReportFormat {
+        JSON = 0,
+        CSV = 1,
+        HTML = 2
+    };
+
+    /**
+     * 报告摘要：写入条目时随之累计，解析统计由调用方在结束前填写
+     */
+    struct ReportSummary {
+        std::uint64_t totalLines = 0;    // 读取的总行数
+        std::uint64_t errorLines = 0;    // 无法解析的行数
+        std::uint64_t entries = 0;       // 写入报告的条目数
+        std::array<std::uint64_t, LOG_LEVEL_COUNT> levelCounts{};
+        std::int64_t firstTimestamp = 0; // 最早与最晚的时间戳（纳秒），entries 为 0 时无意义
+        std::int64_t lastTimestamp = 0;
+    };
+
+    /**
+     * 报告生成器
+     * 调用顺序为 begin → writeEntry / writeRange（任意次）→ finish，内容边生成边经 LogWriter 批量写出，
+     * 内存占用与条目数无关。条目在前、摘要和聚合结果在后（流式生成时只有写完条目才知道汇总值）：
+     *   JSON  单个对象 {"files", "entries", "summary", "aggregation"}，每个条目占一行；
+     *         字符串按 RFC 8259 转义，无效的 UTF-8 字节替换为 U+FFFD
+     *   CSV   RFC 4180 表格 timestamp,level,source,message，只包含条目（表格无法容纳摘要）
+     *   HTML  单个自包含页面：条目表格，之后是摘要、时间线、来源排行与突增
+     * 转义都是逐字节扫描，无需转义的片段整段拷贝，不生成中间字符串。
+     */
+    class ReportWriter {
+    private:
+        ReportFormat format_;
+        int fd_;
+        bool ownsFd_;
+        std::unique_ptr<LogWriter> out_;
+        std::vector<std::string> files_;
+        ReportSummary summary_;
+        bool begun_;
+
+        // 转义输出
+        void writeJsonString(std::string_view text);
+        void writeCsvField(std::string_view text);
+        void writeHtmlText(std::string_view text);
+
+        // 数值输出
+        void writeNumber(std::uint64_t value);
+        void writeDecimal(double value);
+
+        // 各格式的聚合部分
+        void finishJson(const LogAggregator* aggregation, size_t topCount);
+        void finishHtml(const LogAggregator* aggregation, size_t topCount);
+
+    public:
+        /**
+         * 构造函数
+         * @param format 报告格式
+         * @param path 输出文件，"-" 表示标准输出
+         * @param files 报告涉及的输入文件（写入报告头）
+         * @throws std::runtime_error 如果输出文件无法创建
+         */
+        ReportWriter(ReportFormat format, const std::string& path, std::vector<std::string> files);
+
+        /**
+         * 析构函数：写出剩余内容并关闭输出文件
+         */
+        ~ReportWriter();
+
+        ReportWriter(const ReportWriter&) = delete;
+        ReportWriter& operator=(const ReportWriter&) = delete;
+
+        /**
+         * 解析报告格式名称（json、csv、html，不区分大小写）
+         * @param text 格式名称
+         * @param format 输出的格式
+         * @return 是否识别
+         */
+        static bool parseFormat(std::string_view text, ReportFormat& format);
+
+        /**
+         * 写出报告头
+         */
+        void begin();
+
+        /**
+         * 写入一条日志
+         * @param timestampNanos 纪元以来的纳秒数
+         * @param level 日志级别
+         * @param sourceId SourceTable 中的来源编号
+         * @param message 消息内容
+         */
+        void writeEntry(std::int64_t timestampNanos, LogLevel level, std::uint32_t sourceId, std::string_view message);
+
+        /**
+         * 写入一条日志
+         * @param entry 日志条目
+         */
+        void writeEntry(const LogEntry& entry);
+
+        /**
+         * 写入存储中 [begin, end) 行的日志
+         * @param store 列式存储
+         * @param begin 起始行
+         * @param end 结束行（不含）
+         */
+        void writeRange(const LogStore& store, size_t begin, size_t end);
+
+        /**
+         * 写出摘要与聚合结果并结束报告，等待全部内容写出
+         * @param aggregation 聚合结果，为空时省略时间线、来源排行和突增
+         * @param topCount 来源排行的条数
+         * @throws std::runtime_error 如果写出失败
+         */
+        void finish(const LogAggregator* aggregation, size_t topCount);
+
+        /**
+         * 摘要（调用方在 finish 之前填写解析统计）
+         */
+        ReportSummary& summary() { return summary_; }
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,87 @@
+/*
+ * SpaceSaving.h
+ * 固定内存的高频项（heavy hitters）统计
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    /**
+     * Space-Saving 高频项统计
+     * 最多跟踪 capacity 个值：已跟踪的值直接计数；表满时新值替换计数最小的值，
+     * 并继承它的计数作为误差。任何真实频次超过 总数 / capacity 的值一定在表中，
+     * 每个计数满足 count - error ≤ 真实频次 ≤ count。
+     * 计数器按最小堆排列，另用开放寻址表按哈希定位，更新为 O(log capacity)，运行中不再分配内存
+     * （标签字符串除外）。
+     */
+    class SpaceSaving {
+    public:
+        /**
+         * 一个被跟踪的值
+         */
+        struct Counter {
+            std::uint64_t hash;
+            std::uint64_t count;
+            std::uint64_t error;   // 计数中可能多算的部分
+            std::string label;     // 由调用方在值首次进入表时填写
+            size_t slot;           // 在开放寻址表中的位置
+        };
+
+    private:
+        size_t capacity_;
+        std::vector<Counter> counters_;     // 按 count 排列的最小堆
+        std::vector<std::uint32_t> table_;  // 开放寻址表，保存 计数器下标 + 1，0 表示空
+        size_t mask_;
+        std::uint64_t total_;
+
+        size_t findSlot(std::uint64_t hash) const;
+        void insertSlot(size_t index);
+        void eraseSlot(size_t slot);
+        void swapCounters(size_t a, size_t b);
+        void siftDown(size_t index);
+        void siftUp(size_t index);
+
+    public:
+        /**
+         * 构造函数
+         * @param capacity 最多跟踪的值的个数
+         * @throws std::invalid_argument 如果 capacity 为 0
+         */
+        explicit SpaceSaving(size_t capacity = 256);
+
+        /**
+         * 计入一个值
+         * @param hash 值的 64 位哈希
+         * @param count 次数
+         * @return 值新进入表时返回其标签，由调用方填写；否则返回 nullptr
+         */
+        std::string* add(std::uint64_t hash, std::uint64_t count = 1);
+
+        /**
+         * 合并另一个统计（合并后仍满足上述误差保证）
+         * 只在一侧出现的值，按另一侧的最小计数补上计数和误差，再保留计数最大的 capacity 个
+         * @param other 另一个统计
+         */
+        void merge(const SpaceSaving& other);
+
+        /**
+         * 计数最大的若干个值
+         * @param count 个数
+         * @return 按计数递减排列，相同时按哈希递增
+         */
+        std::vector<Counter> top(size_t count) const;
+
+        // 访问器
+        size_t capacity() const { return capacity_; }
+        size_t size() const { return counters_.size(); }
+        std::uint64_t total() const { return total_; }
+        size_t memoryBytes() const;
+    };
+
+} // namespace LogAnalyzer
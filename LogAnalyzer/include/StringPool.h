@@ -0,0 +1,143 @@
+/*
+ * StringPool.h
+ * 来源字符串驻留表与消息内存池
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    /**
+     * 来源驻留表
+     * 来源（线程名、类名等）取值很少，每个不同的字符串只保存一份，
+     * 日志条目中只记录 32 位编号。编号 0 固定表示空字符串。
+     * 字符串只追加不删除，存放在地址固定的分段数组中，已登记数量以原子变量发布：
+     * name/size 无锁，只有登记新字符串时加锁。
+     * 所有方法线程安全；返回的引用在进程生命周期内有效。
+     */
+    class SourceTable {
+    public:
+        // 每个分段的字符串数与分段数上限（来源总数上限为二者之积）
+        static constexpr size_t SEGMENT_SIZE = 1024;
+        static constexpr size_t MAX_SEGMENTS = 4096;
+
+        // 最后一个编号保留给超出上限之后的所有来源，名称为 OVERFLOW_NAME
+        static constexpr std::uint32_t OVERFLOW_ID = static_cast<std::uint32_t>(SEGMENT_SIZE * MAX_SEGMENTS - 1);
+        static constexpr const char* OVERFLOW_NAME = "<other>";
+
+        /**
+         * 获取来源字符串的编号，首次出现时登记
+         * 来源数量达到上限后，新的来源统一归入 OVERFLOW_ID，并只在第一次时向标准错误输出警告
+         * @param name 来源字符串
+         * @return 来源编号
+         */
+        static std::uint32_t intern(std::string_view name);
+
+        /**
+         * 根据编号获取来源字符串
+         * @param id 来源编号
+         * @return 来源字符串，编号无效时返回空字符串
+         */
+        static const std::string& name(std::uint32_t id);
+
+        /**
+         * 获取已登记的来源数量（含编号 0）
+         */
+        static size_t size();
+    };
+
+    /**
+     * 消息内存池
+     * 以大块内存顺序分配（bump allocation）保存日志消息，避免每条消息一次堆分配。
+     * 每个线程有一个默认内存池，随线程退出释放。一次解析的结果应写入调用方的独立内存池：
+     * 通过 Scope 把它设为当前线程的内存池，条目用完后销毁或重置内存池即释放全部消息。
+     * 解析器的工作线程各自写入局部内存池，结束后用 releaseTo 把内存块转交给调用线程的当前内存池。
+     */
+    class MessageArena {
+    private:
+        std::vector<std::unique_ptr<char[]>> blocks_;       // 标准大小的内存块
+        std::vector<std::unique_ptr<char[]>> largeBlocks_;  // 超大消息独占的内存块
+        char* cursor_;
+        size_t remaining_;
+        size_t bytesUsed_;
+        size_t blockSize_;
+
+        /**
+         * 分配一个新的标准大小内存块
+         */
+        void grow();
+
+    public:
+        // 默认内存块大小
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+        /**
+         * 构造函数
+         * @param blockSize 内存块大小
+         */
+        explicit MessageArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+        /**
+         * 禁用拷贝和移动（消息视图指向内部内存块）
+         */
+        MessageArena(const MessageArena&) = delete;
+        MessageArena& operator=(const MessageArena&) = delete;
+
+        /**
+         * 析构函数，释放全部内存块
+         */
+        ~MessageArena() = default;
+
+        /**
+         * 拷贝一段文本到内存池
+         * @param text 文本内容
+         * @return 指向内存池中副本的视图
+         */
+        std::string_view store(std::string_view text);
+
+        /**
+         * 重置内存池，保留第一个内存块供复用；此前返回的视图全部失效
+         */
+        void reset();
+
+        /**
+         * 将全部内存块转交给另一个内存池（用于保留消息的生命周期）
+         * @param target 接收内存块的内存池
+         */
+        void releaseTo(MessageArena& target);
+
+        // 统计信息
+        size_t bytesUsed() const { return bytesUsed_; }
+        size_t blockCount() const { return blocks_.size() + largeBlocks_.size(); }
+
+        /**
+         * 获取当前线程使用的内存池
+         * 没有活动的 Scope 时返回线程默认内存池；它从不重置，写入的消息一直保留到线程退出
+         * @return 当前内存池引用
+         */
+        static MessageArena& current();
+
+        /**
+         * RAII 作用域：在作用域内把指定内存池设为当前线程的内存池
+         */
+        class Scope {
+        private:
+            MessageArena* previous_;
+
+        public:
+            explicit Scope(MessageArena& arena);
+            ~Scope();
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+        };
+    };
+
+} // namespace LogAnalyzer
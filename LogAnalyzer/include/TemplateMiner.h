@@ -0,0 +1,121 @@
+/*
+ * TemplateMiner.h
+ * 消息模板挖掘（Drain 式固定深度前缀树）
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace LogAnalyzer {
+
+    class LogStore;
+
+    /**
+     * 模板挖掘参数
+     */
+    struct TemplateMinerOptions {
+        size_t prefixTokens = 2;     // 用作树键的前导词数
+        double similarity = 0.4;     // 归入已有模板所需的最低相似度（相同词的比例）
+        size_t maxChildren = 100;    // 每个树节点的最多子节点数，超出后归入通配子节点
+    };
+
+    /**
+     * 消息模板挖掘器
+     * 把 "user 123 logged in"、"user 456 logged in" 这样的消息归为同一个模板 "user <*> logged in"。
+     * 消息按空白切分为词，先按词数、再按前 prefixTokens 个词沿固定深度的前缀树找到叶节点
+     * （含数字的词和超出子节点上限的词走通配分支），只与叶节点中的模板比较：
+     * 相似度达到阈值时归入最相似的模板，不同的位置改为通配符，否则新建模板。
+     * 含数字的词在新模板中直接视为参数。
+     * 每个解析线程各自维护一棵树，最后按线程顺序合并；合并把另一棵树的模板逐个当作消息归并进来，
+     * 结果与顺序挖掘可能略有不同（Drain 本身与输入顺序有关）。
+     */
+    class TemplateMiner {
+    public:
+        /**
+         * 挖掘结果中的一个模板
+         */
+        struct Template {
+            std::string text;      // 词之间用单个空格连接，参数位置为 <*>
+            std::uint64_t count;
+            std::string example;   // 第一条归入该模板的消息
+        };
+
+    private:
+        struct Cluster {
+            std::vector<std::string> tokens;
+            std::uint64_t count;
+            std::string example;
+        };
+
+        struct Node {
+            std::map<std::string, std::unique_ptr<Node>, std::less<>> children;
+            std::vector<std::uint32_t> clusters;   // 叶节点上的模板编号
+        };
+
+        TemplateMinerOptions options_;
+        std::unordered_map<size_t, Node> lengthNodes_;   // 第一层：按词数
+        std::vector<Cluster> clusters_;
+        std::uint64_t total_;
+        std::vector<std::string_view> tokens_;           // 切分消息用的缓冲区，避免逐行分配
+
+        /**
+         * 沿前缀树找到（必要时建立）词序列所属的叶节点
+         */
+        Node& leafFor(const std::vector<std::string_view>& tokens);
+
+        /**
+         * 把一个词序列计入 count 次：归入最相似的模板或新建模板
+         */
+        void insert(const std::vector<std::string_view>& tokens, std::uint64_t count, std::string_view example);
+
+    public:
+        /**
+         * 构造函数
+         * @param options 挖掘参数
+         * @throws std::invalid_argument 如果参数超出范围
+         */
+        explicit TemplateMiner(const TemplateMinerOptions& options = TemplateMinerOptions());
+
+        /**
+         * 计入一条消息
+         * @param message 消息内容
+         */
+        void add(std::string_view message);
+
+        /**
+         * 计入存储中 [begin, end) 行的消息
+         * @param store 列式存储
+         * @param begin 起始行
+         * @param end 结束行（不含）
+         */
+        void addRange(const LogStore& store, size_t begin, size_t end);
+
+        /**
+         * 合并另一个挖掘器的模板（参数必须相同）
+         * @param other 另一个挖掘器
+         * @throws std::invalid_argument 如果参数不同
+         */
+        void merge(const TemplateMiner& other);
+
+        /**
+         * 全部模板
+         * @return 按条目数递减排列，相同时按模板文本递增
+         */
+        std::vector<Template> templates() const;
+
+        // 访问器
+        const TemplateMinerOptions& options() const { return options_; }
+        size_t templateCount() const { return clusters_.size(); }
+        std::uint64_t total() const { return total_; }
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,119 @@
+/*
+ * TimeIndex.h
+ * 日志文件旁的持久化时间索引
+ */
+
+#pragma once
+
+#include "FileSignature.h"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <utility>
+#include <cstdint>
+
+namespace LogAnalyzer {
+
+    class LogParser;
+
+    /**
+     * 时间索引类
+     * 把固定宽度的时间桶映射到该桶第一行日志的字节偏移，保存在 "<日志文件>.tidx" 中。
+     * 时间范围查询先二分查找索引得到字节区间，只映射并解析该区间。
+     * 索引记录文件签名（见 FileSignature）：
+     *   - 文件未变化时直接使用；
+     *   - 文件只在末尾追加时从上次索引到的位置增量扩展；
+     *   - 文件被替换或截断时重建。
+     * 如果日志中出现时间倒退跨越时间桶，索引标记为无序，查询退化为全文件扫描。
+     * 文件格式使用本机字节序。
+     */
+    class TimeIndex {
+    public:
+        using TimePoint = std::chrono::system_clock::time_point;
+
+        // 时间桶：起始秒（纪元秒 / 桶宽）及该桶第一行的字节偏移
+        struct Bucket {
+            std::int64_t bucket;
+            std::uint64_t offset;
+        };
+
+        // 默认桶宽（秒）
+        static constexpr std::uint32_t DEFAULT_BUCKET_SECONDS = 60;
+
+    private:
+        std::string filename_;
+        std::vector<Bucket> buckets_;
+        std::uint64_t indexedBytes_;   // 已索引到的位置（最后一个完整行之后）
+        FileSignature signature_;      // 建立索引时的文件签名
+        std::uint32_t bucketSeconds_;
+        bool sorted_;
+
+        /**
+         * 扫描 [from, to) 区间内的完整行并追加时间桶
+         * @param data 文件内容
+         * @param from 起始偏移（行首）
+         * @param to 结束偏移
+         * @param parser 用于解析时间戳的解析器
+         */
+        void scan(const char* data, std::uint64_t from, std::uint64_t to, LogParser& parser);
+
+        /**
+         * 从磁盘读取索引，不抛出异常
+         * @return 读取是否成功；索引不存在、损坏或截断时返回 false
+         */
+        bool load();
+
+        /**
+         * 读取指定的索引文件
+         * @param path 索引文件路径
+         * @return 读取是否成功
+         */
+        bool loadFrom(const std::string& path);
+
+    public:
+        /**
+         * 构造函数
+         * @param filename 日志文件名
+         * @param bucketSeconds 时间桶宽度（秒）
+         */
+        explicit TimeIndex(const std::string& filename,
+                           std::uint32_t bucketSeconds = DEFAULT_BUCKET_SECONDS);
+
+        /**
+         * 加载索引，必要时增量扩展或重建，并写回磁盘
+         * @param filename 日志文件名
+         * @param parser 用于解析时间戳的解析器（其统计信息会包含被扫描的行）
+         * @return 与文件当前内容一致的索引
+         * @throws std::runtime_error 如果日志文件无法映射
+         */
+        static TimeIndex loadOrBuild(const std::string& filename, LogParser& parser);
+
+        /**
+         * 索引文件路径
+         * @param filename 日志文件名
+         * @return 索引文件名
+         */
+        static std::string indexPath(const std::string& filename);
+
+        /**
+         * 写入磁盘（先写临时文件再重命名）
+         * @return 写入是否成功
+         */
+        bool save() const;
+
+        /**
+         * 计算时间范围 [begin, end) 对应的字节区间
+         * 结果区间包含所有时间落在范围内的行，也可能包含少量边界桶中的其他行
+         * @param begin 起始时间（含）
+         * @param end 结束时间（不含）
+         * @return (起始偏移, 结束偏移)
+         */
+        std::pair<std::uint64_t, std::uint64_t> byteRange(const TimePoint& begin, const TimePoint& end) const;
+
+        // 访问器
+        bool isSorted() const { return sorted_; }
+        size_t bucketCount() const { return buckets_.size(); }
+        std::uint64_t indexedBytes() const { return indexedBytes_; }
+    };
+
+} // namespace LogAnalyzer
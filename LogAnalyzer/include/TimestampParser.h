@@ -0,0 +1,89 @@
+/*
+ * TimestampParser.h
+ * 定长时间戳快速解析器
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string_view>
+#include <cstdint>
+
+namespace LogAnalyzer {
+
+    /**
+     * 时间戳解析器
+     * 对常见的定长布局直接做数字运算，用 days-from-civil 换算日期，不调用 mktime；
+     * 同一秒内的连续时间戳复用上一次的换算结果，只叠加毫秒部分。
+     * 时间戳按本地时间解释，时区偏移按小时缓存。
+     * 非线程安全：每个解析线程各持有一个实例。
+     *
+     * 支持的快速布局：
+     *   2024-01-15 14:30:45[,123]    2024-01-15T14:30:45[.123][Z]    Jan 15 14:30:45
+     * 其余输入回退到 std::get_time 逐格式尝试。
+     */
+    class TimestampParser {
+    public:
+        using TimePoint = std::chrono::system_clock::time_point;
+
+    private:
+        // 上一次解析的秒级文本（不含毫秒）及其换算结果
+        char cachedText_[32];
+        size_t cachedLength_;
+        std::int64_t cachedSeconds_;
+
+        // 上一次查询的本地小时及其 UTC 偏移（秒）
+        std::int64_t cachedHour_;
+        std::int64_t cachedOffset_;
+
+        /**
+         * 快速路径：解析定长布局
+         * @param text 时间戳文本
+         * @param localSeconds 输出的本地时间秒数（按 UTC 纪元计算）
+         * @param nanos 输出的秒内纳秒数
+         * @param secondsLength 输出的秒级部分长度（用于缓存键）
+         * @return 是否识别为定长布局
+         */
+        bool parseFixed(std::string_view text, std::int64_t& localSeconds,
+                        std::int64_t& nanos, size_t& secondsLength) const;
+
+        /**
+         * 慢速路径：用 std::get_time 逐个尝试格式
+         * @param text 时间戳文本
+         * @param localSeconds 输出的本地时间秒数
+         * @return 是否解析成功
+         */
+        bool parseGeneric(std::string_view text, std::int64_t& localSeconds) const;
+
+        /**
+         * 将本地时间秒数转换为 UTC 秒数
+         * @param localSeconds 本地时间秒数
+         * @return UTC 纪元秒数
+         */
+        std::int64_t localToUtc(std::int64_t localSeconds);
+
+    public:
+        /**
+         * 默认构造函数
+         */
+        TimestampParser();
+
+        /**
+         * 解析时间戳
+         * @param text 时间戳文本
+         * @param result 输出的时间点（保留毫秒）
+         * @return 是否解析成功
+         */
+        bool parse(std::string_view text, TimePoint& result);
+
+        /**
+         * 公历日期到 1970-01-01 的天数
+         * @param year 年
+         * @param month 月 (1-12)
+         * @param day 日 (1-31)
+         * @return 距 Unix 纪元的天数
+         */
+        static std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day);
+    };
+
+} // namespace LogAnalyzer
@@ -0,0 +1,118 @@
+/*
+ * AllocationCounter.cpp
+ * 全局 operator new / delete 的计数替换
+ */
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        std::atomic<std::uint64_t> allocationCount(0);
+        std::atomic<std::uint64_t> allocationBytes(0);
+
+        // 分配并计数；与标准库默认实现一致，失败时调用 new_handler 后重试
+        void* countedAllocate(std::size_t size) {
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+            allocationBytes.fetch_add(size, std::memory_order_relaxed);
+            if (size == 0) {
+                size = 1;
+            }
+            while (true) {
+                void* ptr = std::malloc(size);
+                if (ptr != nullptr) {
+                    return ptr;
+                }
+                std::new_handler handler = std::get_new_handler();
+                if (handler == nullptr) {
+                    return nullptr;
+                }
+                handler();
+            }
+        }
+
+        // 对齐分配并计数；aligned_alloc 要求大小是对齐值的整数倍
+        void* countedAllocateAligned(std::size_t size, std::size_t alignment) {
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+            allocationBytes.fetch_add(size, std::memory_order_relaxed);
+            if (size == 0) {
+                size = 1;
+            }
+            size = (size + alignment - 1) / alignment * alignment;
+            while (true) {
+                void* ptr = std::aligned_alloc(alignment, size);
+                if (ptr != nullptr) {
+                    return ptr;
+                }
+                std::new_handler handler = std::get_new_handler();
+                if (handler == nullptr) {
+                    return nullptr;
+                }
+                handler();
+            }
+        }
+
+    } // namespace
+
+    std::uint64_t AllocationCounter::count() {
+        return allocationCount.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t AllocationCounter::bytes() {
+        return allocationBytes.load(std::memory_order_relaxed);
+    }
+
+} // namespace LogAnalyzer
+
+// 数组形式的默认实现会转发到这里的基本形式和对齐形式
+void* operator new(std::size_t size) {
+    void* ptr = LogAnalyzer::countedAllocate(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return LogAnalyzer::countedAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* ptr = LogAnalyzer::countedAllocateAligned(size, static_cast<std::size_t>(alignment));
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try {
+        return LogAnalyzer::countedAllocateAligned(size, static_cast<std::size_t>(alignment));
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
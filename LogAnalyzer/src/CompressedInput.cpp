@@ -0,0 +1,457 @@
+/*
+ * CompressedInput.cpp
+ * CompressedInput 类的实现
+ */
+
+#include "CompressedInput.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef LOGANALYZER_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef LOGANALYZER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef LOGANALYZER_HAVE_LZ4
+#include <lz4frame.h>
+#endif
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        // 流式解压时每次交付的最大字节数
+        constexpr size_t OUTPUT_CHUNK_BYTES = 1 << 20;
+
+        // 推测解压的 gzip 成员最多缓冲的字节数，超出即放弃，轮到它时再流式解压
+        constexpr size_t SPECULATIVE_OUTPUT_LIMIT = 64u << 20;
+
+        unsigned char byteAt(std::string_view data, size_t offset) {
+            return static_cast<unsigned char>(data[offset]);
+        }
+
+        bool hasMagic(std::string_view data, const unsigned char* magic, size_t length) {
+            if (data.size() < length) {
+                return false;
+            }
+            for (size_t i = 0; i < length; ++i) {
+                if (byteAt(data, i) != magic[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // gzip 成员头：1f 8b，压缩方法 8 (deflate)，标志位的保留位为 0
+        bool isGzipHeader(std::string_view data, size_t offset) {
+            return offset + 10 <= data.size() && byteAt(data, offset) == 0x1f &&
+                   byteAt(data, offset + 1) == 0x8b && byteAt(data, offset + 2) == 0x08 &&
+                   (byteAt(data, offset + 3) & 0xe0) == 0;
+        }
+
+        /**
+         * 并行解压单元（gzip 成员或 zstd 帧）的结果
+         */
+        struct DecodedUnit {
+            std::string output;
+            size_t consumed = 0;    // 消耗的压缩字节数
+            bool ok = false;
+            std::string error;
+        };
+
+        // 用工作线程解压 units 中的每个单元，decode(i, unit) 在工作线程上调用；
+        // 同时在调用线程上执行 lead()，工作线程全部结束后才返回（lead 抛出异常时也一样）
+        template <typename Decode, typename Lead>
+        void decodeParallel(std::vector<DecodedUnit>& units, unsigned threads, Decode&& decode, Lead&& lead) {
+            std::atomic<size_t> next(0);
+            auto work = [&]() {
+                for (size_t i = next++; i < units.size(); i = next++) {
+                    try {
+                        decode(i, units[i]);
+                        units[i].ok = true;
+                    } catch (const std::exception& e) {
+                        units[i].error = e.what();
+                    }
+                }
+            };
+
+            std::vector<std::thread> pool;
+            unsigned workers = static_cast<unsigned>(std::min<size_t>(threads, units.size()));
+            for (unsigned t = 0; t < workers; ++t) {
+                pool.emplace_back(work);
+            }
+            try {
+                lead();
+            } catch (...) {
+                for (auto& thread : pool) {
+                    thread.join();
+                }
+                throw;
+            }
+            for (auto& thread : pool) {
+                thread.join();
+            }
+        }
+
+        template <typename Decode>
+        void decodeParallel(std::vector<DecodedUnit>& units, unsigned threads, Decode&& decode) {
+            decodeParallel(units, threads, std::forward<Decode>(decode), []() {});
+        }
+
+#ifdef LOGANALYZER_HAVE_ZLIB
+
+        // ===== gzip =====
+
+        // 最后一个成员之后只允许填充的零字节（与 gzip 工具一致）
+        void checkTrailing(std::string_view data, size_t offset) {
+            if (data.find_first_not_of('\0', offset) != std::string_view::npos) {
+                throw std::runtime_error("gzip 数据在偏移 " + std::to_string(offset) + " 处无法识别");
+            }
+        }
+
+        // 所有可能的成员起始位置；压缩数据中偶然出现的成员头由解压结果排除
+        std::vector<size_t> findGzipCandidates(std::string_view data) {
+            std::vector<size_t> candidates;
+            const std::string_view magic("\x1f\x8b\x08", 3);
+            for (size_t pos = data.find(magic); pos != std::string_view::npos; pos = data.find(magic, pos + 1)) {
+                if (isGzipHeader(data, pos)) {
+                    candidates.push_back(pos);
+                }
+            }
+            return candidates;
+        }
+
+        // 解压从 offset 开始的一个 gzip 成员，sink(数据, 长度) 接收输出
+        // @return 成员的压缩字节数
+        template <typename Sink>
+        size_t inflateMember(std::string_view data, size_t offset, Sink&& sink) {
+            z_stream stream{};
+            if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+                throw std::runtime_error("无法初始化 gzip 解压");
+            }
+            std::unique_ptr<z_stream, int (*)(z_stream*)> guard(&stream, inflateEnd);
+
+            std::vector<char> chunk(OUTPUT_CHUNK_BYTES);
+            size_t position = offset;
+            int result = Z_OK;
+            while (result != Z_STREAM_END) {
+                // avail_in 是 32 位的，超大文件分段喂入
+                if (stream.avail_in == 0 && position < data.size()) {
+                    size_t feed = std::min<size_t>(data.size() - position, UINT_MAX);
+                    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data() + position));
+                    stream.avail_in = static_cast<uInt>(feed);
+                    position += feed;
+                }
+                stream.next_out = reinterpret_cast<Bytef*>(chunk.data());
+                stream.avail_out = static_cast<uInt>(chunk.size());
+
+                result = inflate(&stream, Z_NO_FLUSH);
+                if (result != Z_OK && result != Z_STREAM_END) {
+                    throw std::runtime_error(result == Z_BUF_ERROR ? "gzip 数据不完整" : "gzip 数据已损坏");
+                }
+                size_t produced = chunk.size() - stream.avail_out;
+                if (produced > 0) {
+                    sink(chunk.data(), produced);
+                }
+            }
+            return position - offset - stream.avail_in;
+        }
+
+        void decompressGzip(std::string_view data, unsigned threads, const CompressedInput::BlockCallback& callback) {
+            std::vector<size_t> candidates = findGzipCandidates(data);
+            size_t offset = 0;
+
+            if (threads <= 1 || candidates.size() <= 1) {
+                auto deliver = [&callback](const char* bytes, size_t length) {
+                    callback(std::string_view(bytes, length));
+                };
+                while (isGzipHeader(data, offset)) {
+                    offset += inflateMember(data, offset, deliver);
+                }
+                checkTrailing(data, offset);
+                return;
+            }
+
+            // 成员边界要解压后才知道：每轮调用线程流式解压当前位置的成员并直接交付，
+            // 同时工作线程推测解压其后的 threads - 1 个候选，输出先缓冲（每个不超过 SPECULATIVE_OUTPUT_LIMIT）；
+            // 再从当前位置沿 "起点 + 压缩长度" 串起真正的成员，落在成员内部的伪候选被丢弃，
+            // 失败或超出缓冲上限的真成员留到下一轮在调用线程上重新流式解压（损坏的数据届时报错）
+            auto deliver = [&callback](const char* bytes, size_t length) {
+                callback(std::string_view(bytes, length));
+            };
+            size_t first = 0;
+            while (true) {
+                while (first < candidates.size() && candidates[first] < offset) {
+                    ++first;
+                }
+                if (first == candidates.size() || candidates[first] != offset) {
+                    break;
+                }
+
+                size_t count = std::min<size_t>(threads - 1, candidates.size() - first - 1);
+                std::vector<DecodedUnit> units(count);
+                decodeParallel(units, threads - 1, [&](size_t i, DecodedUnit& unit) {
+                    unit.consumed = inflateMember(data, candidates[first + 1 + i], [&unit](const char* bytes, size_t length) {
+                        if (unit.output.size() + length > SPECULATIVE_OUTPUT_LIMIT) {
+                            throw std::runtime_error("推测解压的输出超出缓冲上限");
+                        }
+                        unit.output.append(bytes, length);
+                    });
+                }, [&]() {
+                    offset += inflateMember(data, offset, deliver);
+                });
+
+                for (size_t i = 0; i < count; ++i) {
+                    if (candidates[first + 1 + i] != offset) {
+                        continue;
+                    }
+                    if (!units[i].ok) {
+                        break;
+                    }
+                    callback(units[i].output);
+                    offset += units[i].consumed;
+                    std::string().swap(units[i].output);
+                }
+            }
+            checkTrailing(data, offset);
+        }
+
+#endif
+
+#ifdef LOGANALYZER_HAVE_ZSTD
+
+        // ===== zstd =====
+
+        using ZstdContext = std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)>;
+
+        ZstdContext createZstdContext() {
+            ZstdContext context(ZSTD_createDCtx(), ZSTD_freeDCtx);
+            if (!context) {
+                throw std::runtime_error("无法初始化 zstd 解压");
+            }
+            return context;
+        }
+
+        // 帧头记录了每个块的长度，不解压即可切分出所有帧
+        std::vector<std::string_view> splitZstdFrames(std::string_view data) {
+            std::vector<std::string_view> frames;
+            size_t offset = 0;
+            while (offset < data.size()) {
+                size_t length = ZSTD_findFrameCompressedSize(data.data() + offset, data.size() - offset);
+                if (ZSTD_isError(length)) {
+                    if (data.find_first_not_of('\0', offset) != std::string_view::npos) {
+                        throw std::runtime_error(std::string("zstd 数据不完整或已损坏: ") + ZSTD_getErrorName(length));
+                    }
+                    break;
+                }
+                frames.push_back(data.substr(offset, length));
+                offset += length;
+            }
+            return frames;
+        }
+
+        // 流式解压一个帧（也能处理可跳过帧）
+        template <typename Sink>
+        void decodeZstdFrame(ZSTD_DCtx* context, std::string_view frame, std::vector<char>& chunk, Sink&& sink) {
+            ZSTD_DCtx_reset(context, ZSTD_reset_session_only);
+            ZSTD_inBuffer input = {frame.data(), frame.size(), 0};
+            size_t remaining = 1;
+            while (input.pos < input.size || remaining != 0) {
+                ZSTD_outBuffer output = {chunk.data(), chunk.size(), 0};
+                remaining = ZSTD_decompressStream(context, &output, &input);
+                if (ZSTD_isError(remaining)) {
+                    throw std::runtime_error(std::string("zstd 数据已损坏: ") + ZSTD_getErrorName(remaining));
+                }
+                if (output.pos > 0) {
+                    sink(chunk.data(), output.pos);
+                } else if (input.pos == input.size && remaining != 0) {
+                    throw std::runtime_error("zstd 数据不完整");
+                }
+            }
+        }
+
+        void decompressZstd(std::string_view data, unsigned threads, const CompressedInput::BlockCallback& callback) {
+            std::vector<std::string_view> frames = splitZstdFrames(data);
+
+            if (threads <= 1 || frames.size() <= 1) {
+                ZstdContext context = createZstdContext();
+                std::vector<char> chunk(OUTPUT_CHUNK_BYTES);
+                for (std::string_view frame : frames) {
+                    decodeZstdFrame(context.get(), frame, chunk, [&callback](const char* bytes, size_t length) {
+                        callback(std::string_view(bytes, length));
+                    });
+                }
+                return;
+            }
+
+            // 与 gzip 相同：每轮调用线程流式解压当前帧并直接交付，
+            // 同时工作线程推测解压其后的 threads - 1 个帧，输出先缓冲（每个不超过 SPECULATIVE_OUTPUT_LIMIT）；
+            // 失败或超出缓冲上限的帧留到下一轮在调用线程上重新流式解压（损坏的数据届时报错）。
+            // 帧头中的内容长度来自输入数据，不用于预留内存，只用于提前放弃必然超限的帧
+            auto deliver = [&callback](const char* bytes, size_t length) {
+                callback(std::string_view(bytes, length));
+            };
+            ZstdContext leadContext = createZstdContext();
+            std::vector<char> leadChunk(OUTPUT_CHUNK_BYTES);
+            size_t next = 0;
+            while (next < frames.size()) {
+                size_t count = std::min<size_t>(threads - 1, frames.size() - next - 1);
+                std::vector<DecodedUnit> units(count);
+                decodeParallel(units, threads - 1, [&](size_t i, DecodedUnit& unit) {
+                    std::string_view frame = frames[next + 1 + i];
+                    unsigned long long contentSize = ZSTD_getFrameContentSize(frame.data(), frame.size());
+                    if (contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR &&
+                        contentSize > SPECULATIVE_OUTPUT_LIMIT) {
+                        throw std::runtime_error("推测解压的输出超出缓冲上限");
+                    }
+                    ZstdContext context = createZstdContext();
+                    std::vector<char> chunk(OUTPUT_CHUNK_BYTES);
+                    decodeZstdFrame(context.get(), frame, chunk, [&unit](const char* bytes, size_t length) {
+                        if (unit.output.size() + length > SPECULATIVE_OUTPUT_LIMIT) {
+                            throw std::runtime_error("推测解压的输出超出缓冲上限");
+                        }
+                        unit.output.append(bytes, length);
+                    });
+                }, [&]() {
+                    decodeZstdFrame(leadContext.get(), frames[next], leadChunk, deliver);
+                });
+                ++next;
+
+                for (auto& unit : units) {
+                    if (!unit.ok) {
+                        break;
+                    }
+                    callback(unit.output);
+                    ++next;
+                    std::string().swap(unit.output);
+                }
+            }
+        }
+
+#endif
+
+#ifdef LOGANALYZER_HAVE_LZ4
+
+        // ===== lz4 =====
+
+        struct Lz4ContextDeleter {
+            void operator()(LZ4F_dctx* context) const { LZ4F_freeDecompressionContext(context); }
+        };
+
+        // lz4 帧内的块依赖前面的数据，按顺序流式解压；连续的多个帧由 LZ4F 依次处理
+        void decompressLz4(std::string_view data, const CompressedInput::BlockCallback& callback) {
+            LZ4F_dctx* raw = nullptr;
+            if (LZ4F_isError(LZ4F_createDecompressionContext(&raw, LZ4F_VERSION))) {
+                throw std::runtime_error("无法初始化 lz4 解压");
+            }
+            std::unique_ptr<LZ4F_dctx, Lz4ContextDeleter> context(raw);
+
+            std::vector<char> chunk(OUTPUT_CHUNK_BYTES);
+            size_t offset = 0;
+            while (true) {
+                size_t produced = chunk.size();
+                size_t consumed = data.size() - offset;
+                size_t hint = LZ4F_decompress(context.get(), chunk.data(), &produced,
+                                              data.data() + offset, &consumed, nullptr);
+                if (LZ4F_isError(hint)) {
+                    throw std::runtime_error(std::string("lz4 数据已损坏: ") + LZ4F_getErrorName(hint));
+                }
+                offset += consumed;
+                if (produced > 0) {
+                    callback(std::string_view(chunk.data(), produced));
+                }
+                if (hint == 0 && offset == data.size()) {
+                    break;
+                }
+                if (produced == 0 && consumed == 0) {
+                    throw std::runtime_error("lz4 数据不完整");
+                }
+            }
+        }
+
+#endif
+
+    } // namespace
+
+    // 识别压缩格式
+    Compression CompressedInput::detect(std::string_view data) {
+        static const unsigned char ZSTD_MAGIC[] = {0x28, 0xb5, 0x2f, 0xfd};
+        static const unsigned char LZ4_MAGIC[] = {0x04, 0x22, 0x4d, 0x18};
+
+        if (isGzipHeader(data, 0)) {
+            return Compression::GZIP;
+        }
+        if (hasMagic(data, ZSTD_MAGIC, sizeof(ZSTD_MAGIC))) {
+            return Compression::ZSTD;
+        }
+        if (hasMagic(data, LZ4_MAGIC, sizeof(LZ4_MAGIC))) {
+            return Compression::LZ4;
+        }
+        return Compression::NONE;
+    }
+
+    // 当前构建是否支持
+    bool CompressedInput::isSupported(Compression compression) {
+        switch (compression) {
+            case Compression::NONE: return true;
+#ifdef LOGANALYZER_HAVE_ZLIB
+            case Compression::GZIP: return true;
+#endif
+#ifdef LOGANALYZER_HAVE_ZSTD
+            case Compression::ZSTD: return true;
+#endif
+#ifdef LOGANALYZER_HAVE_LZ4
+            case Compression::LZ4: return true;
+#endif
+            default: return false;
+        }
+    }
+
+    const char* CompressedInput::name(Compression compression) {
+        switch (compression) {
+            case Compression::GZIP: return "gzip";
+            case Compression::ZSTD: return "zstd";
+            case Compression::LZ4: return "lz4";
+            default: return "none";
+        }
+    }
+
+    // 解压
+    void CompressedInput::decompress(std::string_view data, unsigned threads, const BlockCallback& callback) {
+        Compression compression = detect(data);
+        if (!isSupported(compression)) {
+            throw std::runtime_error(std::string("当前构建不支持 ") + name(compression) + " 压缩文件");
+        }
+        threads = std::max(1u, threads);
+
+        switch (compression) {
+#ifdef LOGANALYZER_HAVE_ZLIB
+            case Compression::GZIP:
+                decompressGzip(data, threads, callback);
+                break;
+#endif
+#ifdef LOGANALYZER_HAVE_ZSTD
+            case Compression::ZSTD:
+                decompressZstd(data, threads, callback);
+                break;
+#endif
+#ifdef LOGANALYZER_HAVE_LZ4
+            case Compression::LZ4:
+                decompressLz4(data, callback);
+                break;
+#endif
+            default:
+                callback(data);
+                break;
+        }
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,56 @@
+/*
+ * CountMinSketch.cpp
+ * CountMinSketch 类的实现
+ */
+
+#include "CountMinSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace LogAnalyzer {
+
+    // 构造函数
+    CountMinSketch::CountMinSketch(double epsilon, double delta) : epsilon_(epsilon), total_(0) {
+        if (!(epsilon > 0.0 && epsilon < 1.0) || !(delta > 0.0 && delta < 1.0)) {
+            throw std::invalid_argument("Count-Min 的误差和置信参数必须在 0 到 1 之间");
+        }
+        width_ = static_cast<size_t>(std::ceil(std::exp(1.0) / epsilon));
+        depth_ = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::log(1.0 / delta))));
+        counters_.assign(width_ * depth_, 0);
+    }
+
+    // 双重哈希：第 row 行使用 h1 + row × h2，再用乘法映射到 [0, width) 代替取模
+    size_t CountMinSketch::column(std::uint64_t hash, size_t row) const {
+        std::uint64_t rowHash = mixHash(hash + row * (mixHash(hash ^ 0x9e3779b97f4a7c15ull) | 1));
+        return static_cast<size_t>((static_cast<unsigned __int128>(rowHash) * width_) >> 64);
+    }
+
+    void CountMinSketch::add(std::uint64_t hash, std::uint64_t count) {
+        for (size_t row = 0; row < depth_; ++row) {
+            counters_[row * width_ + column(hash, row)] += count;
+        }
+        total_ += count;
+    }
+
+    std::uint64_t CountMinSketch::estimate(std::uint64_t hash) const {
+        std::uint64_t result = std::numeric_limits<std::uint64_t>::max();
+        for (size_t row = 0; row < depth_; ++row) {
+            result = std::min(result, counters_[row * width_ + column(hash, row)]);
+        }
+        return result;
+    }
+
+    // 合并：逐个计数器相加
+    void CountMinSketch::merge(const CountMinSketch& other) {
+        if (other.width_ != width_ || other.depth_ != depth_) {
+            throw std::invalid_argument("无法合并尺寸不同的 Count-Min 草图");
+        }
+        for (size_t i = 0; i < counters_.size(); ++i) {
+            counters_[i] += other.counters_[i];
+        }
+        total_ += other.total_;
+    }
+
+} // namespace LogAnalyzer
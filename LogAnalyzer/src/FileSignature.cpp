@@ -0,0 +1,70 @@
+/*
+ * FileSignature.cpp
+ * FileSignature 的实现
+ */
+
+#include "FileSignature.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        constexpr size_t PREFIX_HASH_BYTES = 4096;
+
+        // 对文件开头最多 PREFIX_HASH_BYTES 字节（且不超过 limit）求哈希
+        std::uint64_t hashPrefix(const MappedFile& mapped, std::uint64_t limit) {
+            size_t length = static_cast<size_t>(std::min<std::uint64_t>(limit, PREFIX_HASH_BYTES));
+            return hashBytes(std::string_view(mapped.data(), std::min(length, mapped.size())));
+        }
+
+    } // namespace
+
+    // 计算签名
+    FileSignature FileSignature::capture(const std::string& filename, const MappedFile& mapped,
+                                         std::uint64_t parserHash) {
+        struct stat st;
+        if (::stat(filename.c_str(), &st) != 0) {
+            throw std::runtime_error("无法获取文件信息: " + filename);
+        }
+
+        FileSignature signature;
+        signature.size = mapped.size();
+        signature.mtime = static_cast<std::int64_t>(st.st_mtime);
+        signature.inode = static_cast<std::uint64_t>(st.st_ino);
+        signature.prefixHash = hashPrefix(mapped, mapped.size());
+        signature.parserHash = parserHash;
+        return signature;
+    }
+
+    // 文件未变化
+    bool FileSignature::matches(const FileSignature& current) const {
+        return size == current.size && mtime == current.mtime && inode == current.inode &&
+               prefixHash == current.prefixHash && parserHash == current.parserHash;
+    }
+
+    // 文件只在末尾追加
+    bool FileSignature::isPrefixOf(const FileSignature& current, const MappedFile& mapped) const {
+        return parserHash == current.parserHash && inode == current.inode && size <= current.size &&
+               prefixHash == hashPrefix(mapped, size);
+    }
+
+    // 写入
+    void FileSignature::write(std::ostream& out) const {
+        writeBinary(out, size);
+        writeBinary(out, mtime);
+        writeBinary(out, inode);
+        writeBinary(out, prefixHash);
+        writeBinary(out, parserHash);
+    }
+
+    // 读取
+    bool FileSignature::read(std::istream& in) {
+        return readBinary(in, size) && readBinary(in, mtime) &&
+               readBinary(in, inode) && readBinary(in, prefixHash) && readBinary(in, parserHash);
+    }
+
+} // namespace LogAnalyzer
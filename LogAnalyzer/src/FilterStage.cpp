@@ -0,0 +1,44 @@
+/*
+ * FilterStage.cpp
+ * FilterStage 类的实现
+ */
+
+#include "FilterStage.h"
+#include <stdexcept>
+
+namespace LogAnalyzer {
+
+    // 构造函数
+    FilterStage::FilterStage(FilterKind kind)
+        : kind_(kind), level_(LogLevel::INFO), after_(TimePoint::min()), before_(TimePoint::max()) {
+    }
+
+    FilterStage FilterStage::level(LogLevel level) {
+        FilterStage stage(FilterKind::LEVEL);
+        stage.level_ = level;
+        return stage;
+    }
+
+    FilterStage FilterStage::timeRange(const TimePoint& after, const TimePoint& before) {
+        FilterStage stage(FilterKind::TIME_RANGE);
+        stage.after_ = after;
+        stage.before_ = before;
+        return stage;
+    }
+
+    FilterStage FilterStage::keyword(KeywordQuery query) {
+        FilterStage stage(FilterKind::KEYWORD);
+        stage.query_ = std::make_shared<const KeywordQuery>(std::move(query));
+        return stage;
+    }
+
+    FilterStage FilterStage::custom(EntryFilter predicate) {
+        if (!predicate) {
+            throw std::invalid_argument("自定义过滤谓词不能为空");
+        }
+        FilterStage stage(FilterKind::CUSTOM);
+        stage.predicate_ = std::move(predicate);
+        return stage;
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,69 @@
+/*
+ * HyperLogLog.cpp
+ * HyperLogLog 类的实现
+ */
+
+#include "HyperLogLog.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace LogAnalyzer {
+
+    // 构造函数
+    HyperLogLog::HyperLogLog(unsigned precision) : precision_(precision) {
+        if (precision < MIN_PRECISION || precision > MAX_PRECISION) {
+            throw std::invalid_argument("HyperLogLog 精度必须在 " + std::to_string(MIN_PRECISION) + " 到 " +
+                                        std::to_string(MAX_PRECISION) + " 之间");
+        }
+        registers_.assign(size_t(1) << precision, 0);
+    }
+
+    // 合并：逐个寄存器取最大值
+    void HyperLogLog::merge(const HyperLogLog& other) {
+        if (other.precision_ != precision_) {
+            throw std::invalid_argument("无法合并精度不同的 HyperLogLog");
+        }
+        for (size_t i = 0; i < registers_.size(); ++i) {
+            registers_[i] = std::max(registers_[i], other.registers_[i]);
+        }
+    }
+
+    // 估计基数
+    double HyperLogLog::estimate() const {
+        const double m = static_cast<double>(registers_.size());
+        double alpha;
+        switch (registers_.size()) {
+            case 16: alpha = 0.673; break;
+            case 32: alpha = 0.697; break;
+            case 64: alpha = 0.709; break;
+            default: alpha = 0.7213 / (1.0 + 1.079 / m); break;
+        }
+
+        double sum = 0.0;
+        size_t zeros = 0;
+        for (std::uint8_t value : registers_) {
+            sum += std::ldexp(1.0, -static_cast<int>(value));
+            if (value == 0) {
+                ++zeros;
+            }
+        }
+
+        // 64 位哈希不需要大基数修正；小基数时空寄存器还多，线性计数更准
+        double raw = alpha * m * m / sum;
+        if (raw <= 2.5 * m && zeros > 0) {
+            return m * std::log(m / static_cast<double>(zeros));
+        }
+        return raw;
+    }
+
+    void HyperLogLog::clear() {
+        std::fill(registers_.begin(), registers_.end(), 0);
+    }
+
+    double HyperLogLog::relativeError() const {
+        return 1.04 / std::sqrt(static_cast<double>(registers_.size()));
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,362 @@
+/*
+ * KeywordIndex.cpp
+ * KeywordQuery 与 KeywordIndex 类的实现
+ */
+
+#include "KeywordIndex.h"
+#include "LogParser.h"
+#include "MappedFile.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        const char INDEX_MAGIC[8] = {'L', 'A', 'K', 'I', 'D', 'X', '0', '1'};
+        constexpr std::uint32_t INDEX_VERSION = 2;
+
+    } // namespace
+
+    // ==================== KeywordQuery ====================
+
+    // 解析查询字符串
+    KeywordQuery::KeywordQuery(const std::string& query) {
+        std::istringstream words(query);
+        std::string word;
+        std::string buffer;
+
+        while (words >> word) {
+            std::vector<std::vector<std::string>> alternatives;
+            size_t start = 0;
+            while (start <= word.size()) {
+                size_t bar = word.find('|', start);
+                if (bar == std::string::npos) {
+                    bar = word.size();
+                }
+                std::vector<std::string> tokens;
+                KeywordIndex::forEachToken(std::string_view(word).substr(start, bar - start), buffer,
+                                           [&tokens](std::string_view token) {
+                                               tokens.emplace_back(token);
+                                           });
+                if (!tokens.empty()) {
+                    alternatives.push_back(std::move(tokens));
+                }
+                start = bar + 1;
+            }
+
+            if (alternatives.size() == 1) {
+                // 没有 '|'："connection-reset" 这样的词拆开后各自作为 AND 条件
+                for (auto& token : alternatives.front()) {
+                    groups_.push_back({std::move(token)});
+                }
+            } else if (!alternatives.empty()) {
+                std::vector<std::string> group;
+                for (auto& tokens : alternatives) {
+                    if (tokens.size() != 1) {
+                        throw std::runtime_error("关键词查询中 '|' 两侧只能是单个词: " + word);
+                    }
+                    group.push_back(std::move(tokens.front()));
+                }
+                groups_.push_back(std::move(group));
+            }
+        }
+    }
+
+    // 判断消息是否满足查询
+    bool KeywordQuery::matches(std::string_view message) const {
+        std::vector<std::string> tokens;
+        std::string buffer;
+        KeywordIndex::forEachToken(message, buffer, [&tokens](std::string_view token) {
+            tokens.emplace_back(token);
+        });
+
+        return std::all_of(groups_.begin(), groups_.end(), [&tokens](const std::vector<std::string>& group) {
+            return std::any_of(group.begin(), group.end(), [&tokens](const std::string& term) {
+                return std::find(tokens.begin(), tokens.end(), term) != tokens.end();
+            });
+        });
+    }
+
+    // ==================== PostingList ====================
+
+    // 追加偏移：写入与上一个偏移的差值，每字节 7 位，最高位表示后面还有字节
+    void KeywordIndex::PostingList::append(std::uint64_t offset) {
+        if (count > 0 && offset <= last) {
+            return;
+        }
+        std::uint64_t delta = count > 0 ? offset - last : offset;
+        while (delta >= 0x80) {
+            bytes.push_back(static_cast<std::uint8_t>(delta | 0x80));
+            delta >>= 7;
+        }
+        bytes.push_back(static_cast<std::uint8_t>(delta));
+        last = offset;
+        ++count;
+    }
+
+    // 解码；损坏的编码返回空列表
+    std::vector<std::uint64_t> KeywordIndex::PostingList::decode() const {
+        std::vector<std::uint64_t> offsets;
+        if (!decode(offsets)) {
+            offsets.clear();
+        }
+        return offsets;
+    }
+
+    bool KeywordIndex::PostingList::decode(std::vector<std::uint64_t>& offsets) const {
+        offsets.clear();
+        // 每个偏移至少占一个字节，count 来自文件，不能直接用来预留
+        offsets.reserve(static_cast<size_t>(std::min<std::uint64_t>(count, bytes.size())));
+
+        std::uint64_t value = 0;
+        std::uint64_t delta = 0;
+        int shift = 0;
+        for (std::uint8_t byte : bytes) {
+            if (shift > 63) {
+                return false;
+            }
+            delta |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (byte & 0x80) {
+                shift += 7;
+                continue;
+            }
+            // 除第一个外差值必须为正，偏移严格递增
+            if (!offsets.empty() && (delta == 0 || value + delta < value)) {
+                return false;
+            }
+            value += delta;
+            offsets.push_back(value);
+            delta = 0;
+            shift = 0;
+        }
+        return shift == 0 && offsets.size() == count && (count == 0 || value == last);
+    }
+
+    // ==================== KeywordIndex ====================
+
+    // 构造函数
+    KeywordIndex::KeywordIndex(const std::string& filename)
+        : filename_(filename), indexedBytes_(0) {
+    }
+
+    std::string KeywordIndex::indexPath(const std::string& filename) {
+        return filename + ".kidx";
+    }
+
+    // 加载、校验、增量扩展或重建
+    KeywordIndex KeywordIndex::loadOrBuild(const std::string& filename, LogParser& parser) {
+        // 索引可直接使用时只读取文件开头算签名，不为整个文件安排预读；需要扫描的区间再单独预读
+        MappedFile mapped;
+        if (!mapped.open(filename, MappedFile::Access::RANDOM)) {
+            throw std::runtime_error("无法打开文件: " + filename);
+        }
+        FileSignature current = FileSignature::capture(filename, mapped, parser.getPatternHash());
+
+        KeywordIndex index(filename);
+        bool loaded = index.load();
+        if (loaded && index.signature_.matches(current)) {
+            return index;
+        }
+
+        if (loaded && index.signature_.isPrefixOf(current, mapped)) {
+            // 只在末尾追加：新行的偏移更大，直接接在各倒排表之后
+            mapped.prefetch(static_cast<size_t>(index.indexedBytes_),
+                            static_cast<size_t>(current.size - index.indexedBytes_));
+            index.scan(mapped.data(), index.indexedBytes_, current.size, parser);
+        } else {
+            index = KeywordIndex(filename);
+            mapped.prefetch(0, static_cast<size_t>(current.size));
+            index.scan(mapped.data(), 0, current.size, parser);
+        }
+        index.signature_ = current;
+
+        // 写不进去（例如只读目录）时索引仍可在本次查询中使用
+        index.save();
+        return index;
+    }
+
+    // 扫描完整的行，为消息中的每个词登记行偏移
+    void KeywordIndex::scan(const char* data, std::uint64_t from, std::uint64_t to, LogParser& parser) {
+        // 扫描期间的消息写入临时内存池，定期重置
+        MessageArena scratch;
+        MessageArena::Scope scope(scratch);
+        std::string buffer;
+        LogEntry entry;
+
+        std::uint64_t cursor = from;
+        while (cursor < to) {
+            const char* newline = static_cast<const char*>(
+                std::memchr(data + cursor, '\n', static_cast<size_t>(to - cursor)));
+            if (newline == nullptr) {
+                break;  // 末尾的半行等写完后再索引
+            }
+            std::uint64_t lineEnd = static_cast<std::uint64_t>(newline - data);
+
+            if (parser.parseLine(std::string_view(data + cursor, static_cast<size_t>(lineEnd - cursor)), entry)) {
+                const std::uint64_t lineStart = cursor;
+                // 回调中的词就是 buffer 的内容，直接用它查表，只在新词插入时拷贝
+                forEachToken(entry.getMessage(), buffer, [this, &buffer, lineStart](std::string_view) {
+                    postings_[buffer].append(lineStart);
+                });
+            }
+
+            cursor = lineEnd + 1;
+            indexedBytes_ = cursor;
+            if (scratch.bytesUsed() >= MessageArena::DEFAULT_BLOCK_SIZE) {
+                scratch.reset();
+            }
+        }
+    }
+
+    // 读取索引文件；索引损坏或截断时返回 false，由调用方重建，而不是让异常跳过整个日志文件
+    bool KeywordIndex::load() {
+        try {
+            if (loadFrom(indexPath(filename_))) {
+                return true;
+            }
+        } catch (const std::exception&) {
+        }
+        postings_.clear();
+        return false;
+    }
+
+    bool KeywordIndex::loadFrom(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            return false;
+        }
+
+        char magic[sizeof(INDEX_MAGIC)];
+        std::uint32_t version = 0;
+        std::uint64_t termCount = 0;
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+            !readBinary(in, version) || version != INDEX_VERSION ||
+            !signature_.read(in) || !readBinary(in, indexedBytes_) || !readBinary(in, termCount)) {
+            return false;
+        }
+
+        // 以下数量都来自文件，分配前先和剩余字节数比较：每个词至少占长度、last、count 和字节数四个字段
+        const std::uint64_t fixedTermBytes = sizeof(std::uint32_t) + sizeof(PostingList::last) +
+                                             sizeof(PostingList::count) + sizeof(std::uint64_t);
+        std::uint64_t remaining = remainingBytes(in);
+        if (termCount > remaining / fixedTermBytes) {
+            return false;
+        }
+
+        postings_.reserve(static_cast<size_t>(termCount));
+        std::vector<std::uint64_t> decoded;
+        for (std::uint64_t i = 0; i < termCount; ++i) {
+            std::uint32_t termLength = 0;
+            std::uint64_t byteCount = 0;
+            PostingList list;
+            std::string term;
+            if (!readBinary(in, termLength) || fixedTermBytes + termLength > remaining) {
+                return false;
+            }
+            term.resize(termLength);
+            if (!in.read(&term[0], termLength) ||
+                !readBinary(in, list.last) || !readBinary(in, list.count) || !readBinary(in, byteCount)) {
+                return false;
+            }
+            remaining -= fixedTermBytes + termLength;
+            if (byteCount > remaining) {
+                return false;
+            }
+            list.bytes.resize(static_cast<size_t>(byteCount));
+            if (!in.read(reinterpret_cast<char*>(list.bytes.data()), static_cast<std::streamsize>(byteCount))) {
+                return false;
+            }
+            remaining -= byteCount;
+
+            // 每个偏移至少占一个字节；编码必须能完整解码并与记录的 count、last 一致
+            if (list.count > byteCount || !list.decode(decoded)) {
+                return false;
+            }
+            postings_.emplace(std::move(term), std::move(list));
+        }
+        return true;
+    }
+
+    // 写入索引文件
+    bool KeywordIndex::save() const {
+        const std::string path = indexPath(filename_);
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+
+            out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+            writeBinary(out, INDEX_VERSION);
+            signature_.write(out);
+            writeBinary(out, indexedBytes_);
+            writeBinary(out, static_cast<std::uint64_t>(postings_.size()));
+            for (const auto& posting : postings_) {
+                writeBinary(out, static_cast<std::uint32_t>(posting.first.size()));
+                out.write(posting.first.data(), static_cast<std::streamsize>(posting.first.size()));
+                writeBinary(out, posting.second.last);
+                writeBinary(out, posting.second.count);
+                writeBinary(out, static_cast<std::uint64_t>(posting.second.bytes.size()));
+                out.write(reinterpret_cast<const char*>(posting.second.bytes.data()),
+                          static_cast<std::streamsize>(posting.second.bytes.size()));
+            }
+            if (!out) {
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+        return std::rename(tempPath.c_str(), path.c_str()) == 0;
+    }
+
+    // 查询候选行
+    std::vector<std::uint64_t> KeywordIndex::lookup(const KeywordQuery& query) const {
+        // 每组合并为一个有序偏移列表
+        std::vector<std::vector<std::uint64_t>> groupOffsets;
+        for (const auto& group : query.getGroups()) {
+            std::vector<std::uint64_t> merged;
+            for (const auto& term : group) {
+                auto it = postings_.find(term);
+                if (it == postings_.end()) {
+                    continue;
+                }
+                auto offsets = it->second.decode();
+                std::vector<std::uint64_t> combined;
+                combined.reserve(merged.size() + offsets.size());
+                std::set_union(merged.begin(), merged.end(), offsets.begin(), offsets.end(),
+                               std::back_inserter(combined));
+                merged.swap(combined);
+            }
+            if (merged.empty()) {
+                return {};
+            }
+            groupOffsets.push_back(std::move(merged));
+        }
+        if (groupOffsets.empty()) {
+            return {};
+        }
+
+        // 从最短的列表开始求交集，结果只会越来越短
+        std::sort(groupOffsets.begin(), groupOffsets.end(),
+                  [](const std::vector<std::uint64_t>& a, const std::vector<std::uint64_t>& b) {
+                      return a.size() < b.size();
+                  });
+        std::vector<std::uint64_t> result = std::move(groupOffsets.front());
+        for (size_t i = 1; i < groupOffsets.size() && !result.empty(); ++i) {
+            std::vector<std::uint64_t> narrowed;
+            std::set_intersection(result.begin(), result.end(),
+                                  groupOffsets[i].begin(), groupOffsets[i].end(),
+                                  std::back_inserter(narrowed));
+            result.swap(narrowed);
+        }
+        return result;
+    }
+
+} // namespace LogAnalyzer
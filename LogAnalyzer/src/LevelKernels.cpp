@@ -0,0 +1,229 @@
+/*
+ * LevelKernels.cpp
+ * 级别列 SIMD 内核实现
+ */
+
+#include "LevelKernels.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LOGANALYZER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        using Histogram = std::array<size_t, LOG_LEVEL_COUNT>;
+        using HistogramKernel = void (*)(const std::uint8_t*, size_t, Histogram&);
+        using BitmapKernel = void (*)(const std::uint8_t*, size_t, std::uint8_t, std::uint64_t*);
+
+        // ===== 标量实现（也用于处理 SIMD 剩余的尾部） =====
+
+        void histogramScalar(const std::uint8_t* levels, size_t count, Histogram& counts) {
+            for (size_t i = 0; i < count; ++i) {
+                if (levels[i] < LOG_LEVEL_COUNT) {
+                    counts[levels[i]]++;
+                }
+            }
+        }
+
+        // 逐字节置位；SIMD 版本处理尾部时传入偏移到对应字的位图指针
+        void bitmapScalar(const std::uint8_t* levels, size_t count, std::uint8_t level,
+                          std::uint64_t* bitmap) {
+            for (size_t i = 0; i < count; ++i) {
+                if (levels[i] == level) {
+                    bitmap[i / 64] |= std::uint64_t(1) << (i % 64);
+                }
+            }
+        }
+
+#ifdef LOGANALYZER_X86
+
+        // ===== SSE2 实现（x86-64 基线指令集） =====
+
+        // 单次遍历：每个向量只加载一次，与五个级别分别比较并累加到各自的寄存器
+        void histogramSse2(const std::uint8_t* levels, size_t count, Histogram& counts) {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i needles[LOG_LEVEL_COUNT];
+            __m128i totals[LOG_LEVEL_COUNT];
+            for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                needles[level] = _mm_set1_epi8(static_cast<char>(level));
+                totals[level] = zero;
+            }
+
+            size_t i = 0;
+            while (i + 16 <= count) {
+                // 字节计数器最多累加 255 次，之后用 SAD 横向求和到 64 位
+                __m128i acc[LOG_LEVEL_COUNT];
+                for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                    acc[level] = zero;
+                }
+                size_t blocks = std::min<size_t>((count - i) / 16, 255);
+                for (size_t b = 0; b < blocks; ++b, i += 16) {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(levels + i));
+                    for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                        acc[level] = _mm_sub_epi8(acc[level], _mm_cmpeq_epi8(v, needles[level]));
+                    }
+                }
+                for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                    totals[level] = _mm_add_epi64(totals[level], _mm_sad_epu8(acc[level], zero));
+                }
+            }
+            for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                alignas(16) std::uint64_t lanes[2];
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanes), totals[level]);
+                counts[level] += static_cast<size_t>(lanes[0] + lanes[1]);
+            }
+            histogramScalar(levels + i, count - i, counts);
+        }
+
+        void bitmapSse2(const std::uint8_t* levels, size_t count, std::uint8_t level,
+                        std::uint64_t* bitmap) {
+            const __m128i needle = _mm_set1_epi8(static_cast<char>(level));
+            size_t i = 0;
+            for (; i + 64 <= count; i += 64) {
+                std::uint64_t word = 0;
+                for (size_t k = 0; k < 4; ++k) {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(levels + i + k * 16));
+                    std::uint32_t mask = static_cast<std::uint32_t>(
+                        _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)));
+                    word |= static_cast<std::uint64_t>(mask) << (k * 16);
+                }
+                bitmap[i / 64] = word;
+            }
+            bitmapScalar(levels + i, count - i, level, bitmap + i / 64);
+        }
+
+        // ===== AVX2 实现 =====
+
+        __attribute__((target("avx2")))
+        void histogramAvx2(const std::uint8_t* levels, size_t count, Histogram& counts) {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i needles[LOG_LEVEL_COUNT];
+            __m256i totals[LOG_LEVEL_COUNT];
+            for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                needles[level] = _mm256_set1_epi8(static_cast<char>(level));
+                totals[level] = zero;
+            }
+
+            size_t i = 0;
+            while (i + 32 <= count) {
+                __m256i acc[LOG_LEVEL_COUNT];
+                for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                    acc[level] = zero;
+                }
+                size_t blocks = std::min<size_t>((count - i) / 32, 255);
+                for (size_t b = 0; b < blocks; ++b, i += 32) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(levels + i));
+                    for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                        acc[level] = _mm256_sub_epi8(acc[level], _mm256_cmpeq_epi8(v, needles[level]));
+                    }
+                }
+                for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                    totals[level] = _mm256_add_epi64(totals[level], _mm256_sad_epu8(acc[level], zero));
+                }
+            }
+            for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                alignas(32) std::uint64_t lanes[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), totals[level]);
+                counts[level] += static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+            }
+            histogramScalar(levels + i, count - i, counts);
+        }
+
+        __attribute__((target("avx2")))
+        void bitmapAvx2(const std::uint8_t* levels, size_t count, std::uint8_t level,
+                        std::uint64_t* bitmap) {
+            const __m256i needle = _mm256_set1_epi8(static_cast<char>(level));
+            size_t i = 0;
+            for (; i + 64 <= count; i += 64) {
+                __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(levels + i));
+                __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(levels + i + 32));
+                std::uint32_t maskLo = static_cast<std::uint32_t>(
+                    _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+                std::uint32_t maskHi = static_cast<std::uint32_t>(
+                    _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+                bitmap[i / 64] = static_cast<std::uint64_t>(maskLo) |
+                                 (static_cast<std::uint64_t>(maskHi) << 32);
+            }
+            bitmapScalar(levels + i, count - i, level, bitmap + i / 64);
+        }
+
+#endif // LOGANALYZER_X86
+
+        // ===== 运行时分派 =====
+
+        struct KernelTable {
+            const char* name;
+            HistogramKernel histogram;
+            BitmapKernel bitmap;
+        };
+
+        KernelTable selectKernels() {
+            const char* forced = std::getenv("LOGANALYZER_SIMD");
+            std::string wanted = forced ? forced : "";
+
+#ifdef LOGANALYZER_X86
+            __builtin_cpu_init();
+            bool hasAvx2 = __builtin_cpu_supports("avx2");
+            if (hasAvx2 && (wanted.empty() || wanted == "avx2")) {
+                return {"avx2", histogramAvx2, bitmapAvx2};
+            }
+            if (wanted.empty() || wanted == "avx2" || wanted == "sse2") {
+                return {"sse2", histogramSse2, bitmapSse2};
+            }
+#endif
+            return {"scalar", histogramScalar, bitmapScalar};
+        }
+
+        const KernelTable& kernels() {
+            static const KernelTable table = selectKernels();
+            return table;
+        }
+
+    } // namespace
+
+    std::array<size_t, LOG_LEVEL_COUNT> levelHistogram(const std::uint8_t* levels, size_t count) {
+        Histogram counts{};
+        kernels().histogram(levels, count, counts);
+        return counts;
+    }
+
+    std::vector<std::uint64_t> levelSelectBitmap(const std::uint8_t* levels, size_t count, LogLevel level) {
+        std::vector<std::uint64_t> bitmap((count + 63) / 64, 0);
+        kernels().bitmap(levels, count, static_cast<std::uint8_t>(level), bitmap.data());
+        return bitmap;
+    }
+
+    std::vector<size_t> bitmapToIndices(const std::vector<std::uint64_t>& bitmap, size_t count) {
+        size_t selected = 0;
+        for (std::uint64_t word : bitmap) {
+            selected += static_cast<size_t>(__builtin_popcountll(word));
+        }
+
+        std::vector<size_t> indices;
+        indices.reserve(selected);
+        for (size_t w = 0; w < bitmap.size(); ++w) {
+            std::uint64_t word = bitmap[w];
+            while (word != 0) {
+                size_t index = w * 64 + static_cast<size_t>(__builtin_ctzll(word));
+                if (index >= count) {
+                    break;
+                }
+                indices.push_back(index);
+                word &= word - 1;
+            }
+        }
+        return indices;
+    }
+
+    const char* levelKernelName() {
+        return kernels().name;
+    }
+
+} // namespace LogAnalyzer
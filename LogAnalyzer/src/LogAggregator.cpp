@@ -0,0 +1,256 @@
+/*
+ * LogAggregator.cpp
+ * LogAggregator 类的实现
+ */
+
+#include "LogAggregator.h"
+#include "LogStore.h"
+#include "PerformanceMonitor.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        constexpr std::int64_t NANOS_PER_SECOND = 1000000000;
+
+        // 每个线程至少聚合的行数，行数太少时不值得启动线程
+        constexpr size_t MIN_ROWS_PER_THREAD = 1 << 16;
+
+        // 向下取整的除法（1970 年以前的时间戳为负数）
+        std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+            std::int64_t quotient = value / divisor;
+            return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+        }
+
+    } // namespace
+
+    size_t LogAggregator::KeyHash::operator()(const Key& key) const {
+        std::uint64_t hash = static_cast<std::uint64_t>(key.bucket) * 0x9e3779b97f4a7c15ull;
+        hash ^= (static_cast<std::uint64_t>(key.sourceId) << 8 | key.level) + 0x632be59bd9b4e019ull +
+                (hash << 6) + (hash >> 2);
+        return static_cast<size_t>(hash);
+    }
+
+    // 构造函数
+    LogAggregator::LogAggregator(std::chrono::seconds bucketWidth)
+        : bucketNanos_(std::max<std::int64_t>(1, bucketWidth.count()) * NANOS_PER_SECOND), total_(0) {
+    }
+
+    std::int64_t LogAggregator::bucketOf(std::int64_t timestampNanos) const {
+        return floorDiv(timestampNanos, bucketNanos_);
+    }
+
+    // 计入一条日志
+    void LogAggregator::add(std::int64_t timestampNanos, LogLevel level, std::uint32_t sourceId) {
+        counts_[Key{bucketOf(timestampNanos), sourceId, static_cast<std::uint8_t>(level)}]++;
+        ++total_;
+    }
+
+    void LogAggregator::add(const LogEntry& entry) {
+        add(std::chrono::duration_cast<std::chrono::nanoseconds>(entry.getTimestamp().time_since_epoch()).count(),
+            entry.getLevel(), entry.getSourceId());
+    }
+
+    // 扫描存储的三列
+    void LogAggregator::addRange(const LogStore& store, size_t begin, size_t end) {
+        auto timestamps = store.timestamps();
+        auto levels = store.levels();
+        auto sourceIds = store.sourceIds();
+        end = std::min(end, store.size());
+        PerformanceMonitor::Timer timer(Stage::AGGREGATE, 0, end > begin ? end - begin : 0);
+
+        // 相邻的行经常落在同一组：先在本地累加，键变化时才查一次哈希表
+        Key current{0, 0, 0};
+        std::uint64_t pending = 0;
+        for (size_t i = begin; i < end; ++i) {
+            Key key{bucketOf(timestamps[i]), sourceIds[i], levels[i]};
+            if (pending > 0 && key == current) {
+                ++pending;
+                continue;
+            }
+            if (pending > 0) {
+                counts_[current] += pending;
+            }
+            current = key;
+            pending = 1;
+        }
+        if (pending > 0) {
+            counts_[current] += pending;
+        }
+        total_ += end > begin ? end - begin : 0;
+    }
+
+    // 与 addRange 相同，相邻条目同组时只在本地累加
+    void LogAggregator::addBatch(const std::vector<LogEntry>& entries) {
+        PerformanceMonitor::Timer timer(Stage::AGGREGATE, 0, entries.size());
+        Key current{0, 0, 0};
+        std::uint64_t pending = 0;
+        for (const auto& entry : entries) {
+            Key key{bucketOf(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        entry.getTimestamp().time_since_epoch()).count()),
+                    entry.getSourceId(), static_cast<std::uint8_t>(entry.getLevel())};
+            if (pending > 0 && key == current) {
+                ++pending;
+                continue;
+            }
+            if (pending > 0) {
+                counts_[current] += pending;
+            }
+            current = key;
+            pending = 1;
+        }
+        if (pending > 0) {
+            counts_[current] += pending;
+        }
+        total_ += entries.size();
+    }
+
+    // 合并
+    void LogAggregator::merge(const LogAggregator& other) {
+        if (other.bucketNanos_ != bucketNanos_) {
+            throw std::invalid_argument("无法合并时间桶宽度不同的聚合结果");
+        }
+        for (const auto& group : other.counts_) {
+            counts_[group.first] += group.second;
+        }
+        total_ += other.total_;
+    }
+
+    // 并行聚合
+    LogAggregator LogAggregator::aggregate(const LogStore& store, std::chrono::seconds bucketWidth, unsigned threads) {
+        const size_t rows = store.size();
+        unsigned workers = static_cast<unsigned>(std::min<size_t>(std::max(1u, threads), rows / MIN_ROWS_PER_THREAD));
+
+        LogAggregator result(bucketWidth);
+        if (workers <= 1) {
+            result.addRange(store, 0, rows);
+            return result;
+        }
+
+        std::vector<LogAggregator> partials(workers, LogAggregator(bucketWidth));
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < workers; ++t) {
+            pool.emplace_back([&, t]() {
+                partials[t].addRange(store, rows / workers * t, t + 1 == workers ? rows : rows / workers * (t + 1));
+            });
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        for (const auto& partial : partials) {
+            result.merge(partial);
+        }
+        return result;
+    }
+
+    // 时间线
+    std::vector<LogAggregator::TimelineBucket> LogAggregator::timeline() const {
+        std::map<std::int64_t, std::array<std::uint64_t, LOG_LEVEL_COUNT>> buckets;
+        for (const auto& group : counts_) {
+            auto& counts = buckets[group.first.bucket];
+            if (group.first.level < LOG_LEVEL_COUNT) {
+                counts[group.first.level] += group.second;
+            }
+        }
+
+        std::vector<TimelineBucket> result;
+        result.reserve(buckets.size());
+        for (const auto& bucket : buckets) {
+            result.push_back({bucket.first, bucket.second});
+        }
+        return result;
+    }
+
+    // Top-N 来源
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> LogAggregator::topSources(LogLevel minLevel, size_t count) const {
+        std::unordered_map<std::uint32_t, std::uint64_t> perSource;
+        for (const auto& group : counts_) {
+            if (group.first.level >= static_cast<std::uint8_t>(minLevel)) {
+                perSource[group.first.sourceId] += group.second;
+            }
+        }
+
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> result(perSource.begin(), perSource.end());
+        auto more = [](const std::pair<std::uint32_t, std::uint64_t>& a, const std::pair<std::uint32_t, std::uint64_t>& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        };
+        if (result.size() > count) {
+            std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(count), result.end(), more);
+            result.resize(count);
+        } else {
+            std::sort(result.begin(), result.end(), more);
+        }
+        return result;
+    }
+
+    // 突增检测：维护之前 window 个桶（含空桶）的和与平方和
+    std::vector<LogAggregator::Spike> LogAggregator::findSpikes(LogLevel minLevel, size_t window, double threshold) const {
+        std::map<std::int64_t, std::uint64_t> series;
+        for (const auto& group : counts_) {
+            std::uint64_t& count = series[group.first.bucket];
+            if (group.first.level >= static_cast<std::uint8_t>(minLevel)) {
+                count += group.second;
+            }
+        }
+
+        window = std::max<size_t>(window, 1);
+        const size_t minHistory = std::min<size_t>(window, 5);   // 基线至少需要几个桶才有意义
+        std::deque<double> recent;
+        double sum = 0.0;
+        double sumSquares = 0.0;
+        auto push = [&](double value) {
+            recent.push_back(value);
+            sum += value;
+            sumSquares += value * value;
+            if (recent.size() > window) {
+                sum -= recent.front();
+                sumSquares -= recent.front() * recent.front();
+                recent.pop_front();
+            }
+        };
+
+        // 桶可能相隔很远（例如没有年份的 syslog 时间），空桶最多补 window 个，不展开整个区间
+        std::vector<Spike> spikes;
+        bool first = true;
+        std::int64_t previous = 0;
+        for (const auto& bucket : series) {
+            if (!first) {
+                std::uint64_t gap = static_cast<std::uint64_t>(bucket.first - previous - 1);
+                for (std::uint64_t i = 0; i < std::min<std::uint64_t>(gap, window); ++i) {
+                    push(0.0);
+                }
+            }
+            first = false;
+            previous = bucket.first;
+
+            if (recent.size() >= minHistory) {
+                double history = static_cast<double>(recent.size());
+                double mean = sum / history;
+                double variance = std::max(0.0, sumSquares / history - mean * mean);
+                double deviation = std::max({std::sqrt(variance), std::sqrt(mean), 1.0});
+                double score = (static_cast<double>(bucket.second) - mean) / deviation;
+                if (score >= threshold) {
+                    spikes.push_back({bucket.first, bucket.second, mean, score});
+                }
+            }
+            push(static_cast<double>(bucket.second));
+        }
+        return spikes;
+    }
+
+    LogAggregator::TimePoint LogAggregator::bucketStart(std::int64_t bucket) const {
+        return TimePoint(std::chrono::duration_cast<TimePoint::duration>(
+            std::chrono::nanoseconds(bucket * bucketNanos_)));
+    }
+
+    std::chrono::seconds LogAggregator::bucketWidth() const {
+        return std::chrono::seconds(bucketNanos_ / NANOS_PER_SECOND);
+    }
+
+} // namespace LogAnalyzer
@@ -4,6 +4,7 @@
  */
 
 #include "LogEntry.h"
+#include "StringPool.h"
 #include <sstream>
 #include <iomanip>
 #include <map>
@@ -11,11 +12,30 @@
 namespace LogAnalyzer {
 
     // 构造函数实现
+    LogEntry::LogEntry()
+        : timestamp_(), message_(""), messageLength_(0), sourceId_(0), level_(LogLevel::INFO) {
+    }
+
     LogEntry::LogEntry(const std::chrono::system_clock::time_point& timestamp,
                       LogLevel level, 
-                      const std::string& source, 
-                      const std::string& message)
-        : timestamp_(timestamp), level_(level), source_(source), message_(message) {
+                      std::string_view source, 
+                      std::string_view message)
+        : timestamp_(timestamp), message_(""), messageLength_(0),
+          sourceId_(SourceTable::intern(source)), level_(level) {
+        setMessage(message);
+    }
+
+    LogEntry LogEntry::fromStored(const std::chrono::system_clock::time_point& timestamp,
+                                  LogLevel level,
+                                  std::uint32_t sourceId,
+                                  std::string_view message) {
+        LogEntry entry;
+        entry.timestamp_ = timestamp;
+        entry.level_ = level;
+        entry.sourceId_ = sourceId;
+        entry.message_ = message.data();
+        entry.messageLength_ = static_cast<std::uint32_t>(message.size());
+        return entry;
     }
 
     // 访问器实现
@@ -28,11 +48,11 @@ namespace LogAnalyzer {
     }
 
     const std::string& LogEntry::getSource() const {
-        return source_;
+        return SourceTable::name(sourceId_);
     }
 
-    const std::string& LogEntry::getMessage() const {
-        return message_;
+    std::string_view LogEntry::getMessage() const {
+        return std::string_view(message_, messageLength_);
     }
 
     // 修改器实现
@@ -44,12 +64,14 @@ namespace LogAnalyzer {
         level_ = level;
     }
 
-    void LogEntry::setSource(const std::string& source) {
-        source_ = source;
+    void LogEntry::setSource(std::string_view source) {
+        sourceId_ = SourceTable::intern(source);
     }
 
-    void LogEntry::setMessage(const std::string& message) {
-        message_ = message;
+    void LogEntry::setMessage(std::string_view message) {
+        std::string_view stored = MessageArena::current().store(message);
+        message_ = stored.empty() ? "" : stored.data();
+        messageLength_ = static_cast<std::uint32_t>(stored.size());
     }
 
     // 工具方法实现
@@ -68,8 +90,8 @@ namespace LogAnalyzer {
         std::stringstream ss;
         ss << "[" << getFormattedTimestamp() << "] "
            << "[" << getLevelString() << "] "
-           << "[" << source_ << "] "
-           << message_;
+           << "[" << getSource() << "] "
+           << getMessage();
         return ss.str();
     }
 
@@ -81,8 +103,8 @@ namespace LogAnalyzer {
     bool LogEntry::operator==(const LogEntry& other) const {
         return timestamp_ == other.timestamp_ &&
                level_ == other.level_ &&
-               source_ == other.source_ &&
-               message_ == other.message_;
+               sourceId_ == other.sourceId_ &&
+               getMessage() == other.getMessage();
     }
 
     // 全局函数实现
@@ -99,8 +121,14 @@ namespace LogAnalyzer {
         return (it != levelMap.end()) ? it->second : "UNKNOWN";
     }
 
-    LogLevel stringToLogLevel(const std::string& levelStr) {
-        static const std::map<std::string, LogLevel> stringMap = {
+    std::string_view logLevelName(LogLevel level) {
+        static constexpr std::string_view names[LOG_LEVEL_COUNT] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+        size_t index = static_cast<size_t>(level);
+        return index < LOG_LEVEL_COUNT ? names[index] : std::string_view("UNKNOWN");
+    }
+
+    LogLevel stringToLogLevel(std::string_view levelStr) {
+        static const std::map<std::string, LogLevel, std::less<>> stringMap = {
             {"DEBUG", LogLevel::DEBUG},
             {"INFO",  LogLevel::INFO},
             {"WARN",  LogLevel::WARN},
@@ -0,0 +1,230 @@
+/*
+ * LogFollower.cpp
+ * LogFollower 类的实现
+ */
+
+#include "LogFollower.h"
+#include "StringPool.h"
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        // 单次读取的字节数
+        constexpr size_t READ_CHUNK_BYTES = 1 << 16;
+
+        // 两次检查之间的最长等待时间（毫秒）
+        constexpr int POLL_INTERVAL_MS = 500;
+
+        // 获取文件所在目录
+        std::string parentDirectory(const std::string& filename) {
+            auto slash = filename.find_last_of('/');
+            if (slash == std::string::npos) {
+                return ".";
+            }
+            return slash == 0 ? "/" : filename.substr(0, slash);
+        }
+
+    } // namespace
+
+    // 构造函数
+    LogFollower::LogFollower(LogParser& parser)
+        : parser_(parser), inotifyFd_(-1), readBuffer_(READ_CHUNK_BYTES, '\0') {
+#ifdef __linux__
+        inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    }
+
+    // 析构函数
+    LogFollower::~LogFollower() {
+        for (auto& file : files_) {
+            if (file.fd >= 0) {
+                ::close(file.fd);
+            }
+        }
+        if (inotifyFd_ >= 0) {
+            ::close(inotifyFd_);
+        }
+    }
+
+    // 添加文件：从当前末尾开始跟踪
+    bool LogFollower::addFile(const std::string& filename) {
+        FollowedFile file;
+        file.filename = filename;
+        bool opened = openFile(file, true);
+        files_.push_back(std::move(file));
+        addWatches(files_.back());
+        return opened;
+    }
+
+    // 打开文件并记录身份
+    bool LogFollower::openFile(FollowedFile& file, bool fromEnd) {
+        int fd = ::open(file.filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        if (file.fd >= 0) {
+            ::close(file.fd);
+        }
+        file.fd = fd;
+        file.device = st.st_dev;
+        file.inode = st.st_ino;
+        file.offset = fromEnd ? st.st_size : 0;
+        file.pending.clear();
+        return true;
+    }
+
+    // 注册 inotify 监视：文件本身的修改/移动/删除，以及目录中同名文件的创建
+    void LogFollower::addWatches(FollowedFile& file) {
+#ifdef __linux__
+        if (inotifyFd_ < 0) {
+            return;
+        }
+        if (file.fd >= 0) {
+            file.watch = inotify_add_watch(inotifyFd_, file.filename.c_str(),
+                                           IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+        }
+        if (file.dirWatch < 0) {
+            file.dirWatch = inotify_add_watch(inotifyFd_, parentDirectory(file.filename).c_str(),
+                                              IN_CREATE | IN_MOVED_TO);
+        }
+#else
+        (void)file;
+#endif
+    }
+
+    // 读取新增内容并逐行解析
+    void LogFollower::drain(FollowedFile& file, const EntryCallback& callback) {
+        if (file.fd < 0) {
+            return;
+        }
+
+        // 每批数据使用临时内存池，回调处理完即可重置
+        MessageArena::Scope scope(scratch_);
+
+        while (true) {
+            ssize_t n = ::pread(file.fd, &readBuffer_[0], readBuffer_.size(), file.offset);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            file.offset += n;
+
+            std::string_view chunk(readBuffer_.data(), static_cast<size_t>(n));
+            size_t lastNewline = chunk.rfind('\n');
+            if (lastNewline == std::string_view::npos) {
+                file.pending.append(chunk.data(), chunk.size());
+                continue;
+            }
+
+            // 先补全上次残留的半行，再直接解析本块中的完整行（保留结尾换行，空行照常计数）
+            size_t start = 0;
+            if (!file.pending.empty()) {
+                size_t firstNewline = chunk.find('\n');
+                file.pending.append(chunk.data(), firstNewline);
+                LogEntry entry;
+                if (parser_.parseLine(file.pending, entry)) {
+                    callback(entry);
+                }
+                file.pending.clear();
+                start = firstNewline + 1;
+            }
+            parser_.parseBuffer(chunk.substr(start, lastNewline + 1 - start), callback);
+            file.pending.assign(chunk.data() + lastNewline + 1, chunk.size() - lastNewline - 1);
+            scratch_.reset();
+        }
+    }
+
+    // 检查轮转与截断
+    void LogFollower::checkRotation(FollowedFile& file, const EntryCallback& callback) {
+        struct stat st;
+        if (::stat(file.filename.c_str(), &st) != 0) {
+            // 文件已被移走且新文件尚未创建：继续读旧描述符
+            return;
+        }
+
+        if (file.fd < 0 || st.st_dev != file.device || st.st_ino != file.inode) {
+            // 轮转：先读完旧文件，残留的半行按一行处理，再从头读取新文件
+            drain(file, callback);
+            if (!file.pending.empty()) {
+                MessageArena::Scope scope(scratch_);
+                LogEntry entry;
+                if (parser_.parseLine(file.pending, entry)) {
+                    callback(entry);
+                }
+                scratch_.reset();
+            }
+            if (openFile(file, false)) {
+#ifdef __linux__
+                if (file.watch >= 0) {
+                    inotify_rm_watch(inotifyFd_, file.watch);
+                    file.watch = -1;
+                }
+#endif
+                addWatches(file);
+            }
+            return;
+        }
+
+        if (st.st_size < file.offset) {
+            // 截断（copytruncate）：从头开始
+            file.offset = 0;
+            file.pending.clear();
+        }
+    }
+
+    // 等待变化
+    void LogFollower::waitForChange(int timeoutMs) {
+#ifdef __linux__
+        if (inotifyFd_ >= 0) {
+            struct pollfd pfd;
+            pfd.fd = inotifyFd_;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (::poll(&pfd, 1, timeoutMs) > 0) {
+                // 事件内容无需逐条解析：任何变化都触发一次全量检查
+                char events[4096];
+                while (::read(inotifyFd_, events, sizeof(events)) > 0) {
+                }
+            }
+            return;
+        }
+#endif
+        ::poll(nullptr, 0, timeoutMs);
+    }
+
+    // 主循环
+    void LogFollower::run(const EntryCallback& callback, const std::atomic<bool>& stop,
+                          const std::function<void()>& onBatch) {
+        while (!stop) {
+            for (auto& file : files_) {
+                drain(file, callback);
+                checkRotation(file, callback);
+            }
+            if (onBatch) {
+                onBatch();
+            }
+            waitForChange(POLL_INTERVAL_MS);
+        }
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,241 @@
+/*
+ * LogFormats.cpp
+ * 内置日志格式扫描器实现
+ *
+ * 每个扫描器对应 LogParser 过去使用的一条正则表达式：
+ *   APP_BRACKETED  (\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2})\s+\[(\w+)\]\s+\[([^\]]+)\]\s+(.+)
+ *   SYSLOG         (\w{3} \d{1,2} \d{2}:\d{2}:\d{2})\s+(\w+)\s+([^:]+):\s+(.+)
+ *   JAVA_MILLIS    (\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2},\d{3})\s+(\w+)\s+\[([^\]]+)\]\s+(.+)
+ *   SIMPLE_COLON   (\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2})\s+(\w+):\s+(.+)
+ *   ISO8601        (\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3}Z?)\s+\[(\w+)\]\s+\[([^\]]+)\]\s+(.+)
+ * 字符类与 ECMAScript 正则在 "C" locale 下的定义一致：
+ *   \d = [0-9]，\w = [A-Za-z0-9_]，\s = [ \t\n\v\f\r]，. 不匹配 \n 和 \r
+ */
+
+#include "LogFormats.h"
+#include <cstring>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        inline bool isDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        inline bool isSpace(char c) {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+
+        inline bool isWord(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || isDigit(c) || c == '_';
+        }
+
+        inline bool isLineTerminator(char c) {
+            return c == '\n' || c == '\r';
+        }
+
+        // 匹配 n 个数字
+        inline bool matchDigits(const char*& p, const char* end, int n) {
+            if (end - p < n) return false;
+            for (int i = 0; i < n; ++i) {
+                if (!isDigit(p[i])) return false;
+            }
+            p += n;
+            return true;
+        }
+
+        // 匹配单个字面字符
+        inline bool matchChar(const char*& p, const char* end, char c) {
+            if (p == end || *p != c) return false;
+            ++p;
+            return true;
+        }
+
+        // 匹配 \d{4}-\d{2}-\d{2}<sep>\d{2}:\d{2}:\d{2}
+        inline bool matchDateTime(const char*& p, const char* end, char sep) {
+            return matchDigits(p, end, 4) && matchChar(p, end, '-') &&
+                   matchDigits(p, end, 2) && matchChar(p, end, '-') &&
+                   matchDigits(p, end, 2) && matchChar(p, end, sep) &&
+                   matchDigits(p, end, 2) && matchChar(p, end, ':') &&
+                   matchDigits(p, end, 2) && matchChar(p, end, ':') &&
+                   matchDigits(p, end, 2);
+        }
+
+        // 匹配 \s+，返回匹配的长度
+        inline size_t skipSpaces(const char*& p, const char* end) {
+            const char* start = p;
+            while (p < end && isSpace(*p)) ++p;
+            return static_cast<size_t>(p - start);
+        }
+
+        // 匹配 (\w+)
+        inline bool matchWord(const char*& p, const char* end, std::string_view& out) {
+            const char* start = p;
+            while (p < end && isWord(*p)) ++p;
+            if (p == start) return false;
+            out = std::string_view(start, static_cast<size_t>(p - start));
+            return true;
+        }
+
+        // 匹配 \[([^\]]+)\]
+        inline bool matchBracketed(const char*& p, const char* end, std::string_view& out) {
+            if (!matchChar(p, end, '[')) return false;
+            const char* close = static_cast<const char*>(
+                std::memchr(p, ']', static_cast<size_t>(end - p)));
+            if (close == nullptr || close == p) return false;
+            out = std::string_view(p, static_cast<size_t>(close - p));
+            p = close + 1;
+            return true;
+        }
+
+        /**
+         * 匹配行尾的 \s+(.+)$
+         * 贪婪的 \s+ 吃掉全部空白；若其后没有字符，则回溯让出最后一个空白给 (.+)
+         */
+        bool matchTrailingMessage(const char* p, const char* end, std::string_view& out) {
+            const char* spaceStart = p;
+            if (skipSpaces(p, end) == 0) return false;
+
+            if (p < end) {
+                for (const char* q = p; q < end; ++q) {
+                    if (isLineTerminator(*q)) return false;
+                }
+                out = std::string_view(p, static_cast<size_t>(end - p));
+                return true;
+            }
+
+            // 整个行尾都是空白：至少需要两个空白，且最后一个不能是行终止符
+            if (end - spaceStart < 2 || isLineTerminator(end[-1])) return false;
+            out = std::string_view(end - 1, 1);
+            return true;
+        }
+
+        // \[(\w+)\]\s+\[([^\]]+)\]\s+(.+)
+        bool scanBracketedTail(const char* p, const char* end, LogFields& fields) {
+            if (!matchChar(p, end, '[') || !matchWord(p, end, fields.level) ||
+                !matchChar(p, end, ']')) {
+                return false;
+            }
+            if (skipSpaces(p, end) == 0) return false;
+            if (!matchBracketed(p, end, fields.source)) return false;
+            fields.hasSource = true;
+            return matchTrailingMessage(p, end, fields.message);
+        }
+
+        bool scanAppBracketed(const char* begin, const char* end, LogFields& fields) {
+            const char* p = begin;
+            if (!matchDateTime(p, end, ' ')) return false;
+            fields.timestamp = std::string_view(begin, static_cast<size_t>(p - begin));
+            if (skipSpaces(p, end) == 0) return false;
+            return scanBracketedTail(p, end, fields);
+        }
+
+        bool scanSyslog(const char* begin, const char* end, LogFields& fields) {
+            const char* p = begin;
+
+            // \w{3} \d{1,2} \d{2}:\d{2}:\d{2}
+            if (end - p < 3 || !isWord(p[0]) || !isWord(p[1]) || !isWord(p[2])) return false;
+            p += 3;
+            if (!matchChar(p, end, ' ')) return false;
+            if (!matchDigits(p, end, 1)) return false;
+            if (p < end && isDigit(*p)) ++p;
+            if (!matchChar(p, end, ' ') ||
+                !matchDigits(p, end, 2) || !matchChar(p, end, ':') ||
+                !matchDigits(p, end, 2) || !matchChar(p, end, ':') ||
+                !matchDigits(p, end, 2)) {
+                return false;
+            }
+            fields.timestamp = std::string_view(begin, static_cast<size_t>(p - begin));
+
+            // \s+(\w+)\s+
+            if (skipSpaces(p, end) == 0) return false;
+            if (!matchWord(p, end, fields.level)) return false;
+            const char* spaceStart = p;
+            if (skipSpaces(p, end) == 0) return false;
+
+            // ([^:]+): —— [^:] 也能匹配空白，紧跟冒号时回溯让出一个空白
+            if (p == end) return false;
+            const char* sourceStart = p;
+            if (*p == ':') {
+                if (p - spaceStart < 2) return false;
+                sourceStart = p - 1;
+            }
+            const char* colon = static_cast<const char*>(
+                std::memchr(p, ':', static_cast<size_t>(end - p)));
+            if (colon == nullptr) return false;
+            fields.source = std::string_view(sourceStart, static_cast<size_t>(colon - sourceStart));
+            fields.hasSource = true;
+
+            return matchTrailingMessage(colon + 1, end, fields.message);
+        }
+
+        bool scanJavaMillis(const char* begin, const char* end, LogFields& fields) {
+            const char* p = begin;
+            if (!matchDateTime(p, end, ' ') || !matchChar(p, end, ',') ||
+                !matchDigits(p, end, 3)) {
+                return false;
+            }
+            fields.timestamp = std::string_view(begin, static_cast<size_t>(p - begin));
+
+            if (skipSpaces(p, end) == 0) return false;
+            if (!matchWord(p, end, fields.level)) return false;
+            if (skipSpaces(p, end) == 0) return false;
+            if (!matchBracketed(p, end, fields.source)) return false;
+            fields.hasSource = true;
+            return matchTrailingMessage(p, end, fields.message);
+        }
+
+        bool scanSimpleColon(const char* begin, const char* end, LogFields& fields) {
+            const char* p = begin;
+            if (!matchDateTime(p, end, ' ')) return false;
+            fields.timestamp = std::string_view(begin, static_cast<size_t>(p - begin));
+
+            if (skipSpaces(p, end) == 0) return false;
+            if (!matchWord(p, end, fields.level)) return false;
+            if (!matchChar(p, end, ':')) return false;
+            fields.hasSource = false;
+            return matchTrailingMessage(p, end, fields.message);
+        }
+
+        bool scanIso8601(const char* begin, const char* end, LogFields& fields) {
+            const char* p = begin;
+            if (!matchDateTime(p, end, 'T') || !matchChar(p, end, '.') ||
+                !matchDigits(p, end, 3)) {
+                return false;
+            }
+            if (p < end && *p == 'Z') ++p;
+            fields.timestamp = std::string_view(begin, static_cast<size_t>(p - begin));
+
+            if (skipSpaces(p, end) == 0) return false;
+            return scanBracketedTail(p, end, fields);
+        }
+
+    } // namespace
+
+    bool scanLogLine(LogFormat format, std::string_view line, LogFields& fields) {
+        const char* begin = line.data();
+        const char* end = line.data() + line.size();
+
+        switch (format) {
+            case LogFormat::APP_BRACKETED: return scanAppBracketed(begin, end, fields);
+            case LogFormat::SYSLOG:        return scanSyslog(begin, end, fields);
+            case LogFormat::JAVA_MILLIS:   return scanJavaMillis(begin, end, fields);
+            case LogFormat::SIMPLE_COLON:  return scanSimpleColon(begin, end, fields);
+            case LogFormat::ISO8601:       return scanIso8601(begin, end, fields);
+        }
+        return false;
+    }
+
+    const char* logFormatName(LogFormat format) {
+        switch (format) {
+            case LogFormat::APP_BRACKETED: return "应用程序日志格式";
+            case LogFormat::SYSLOG:        return "Syslog 格式";
+            case LogFormat::JAVA_MILLIS:   return "Java 应用日志格式";
+            case LogFormat::SIMPLE_COLON:  return "简单格式";
+            case LogFormat::ISO8601:       return "ISO-8601 毫秒格式";
+        }
+        return "未知格式";
+    }
+
+} // namespace LogAnalyzer
@@ -4,34 +4,143 @@
  */
 
 #include "LogParser.h"
+#include "CompressedInput.h"
+#include "MappedFile.h"
+#include "PerformanceMonitor.h"
+#include "StringPool.h"
+#include "TimeIndex.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstring>
+#include <thread>
+#include <exception>
+#include <stdexcept>
+#include <atomic>
+#include <queue>
+#include <functional>
+#include <deque>
+#include <iterator>
 
 namespace LogAnalyzer {
 
-    // 静态成员初始化：预定义的日志格式模式
-    const std::vector<std::regex> LogParser::LOG_PATTERNS = {
-        // Apache 通用日志格式
-        std::regex(R"((\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2})\s+\[(\w+)\]\s+\[([^\]]+)\]\s+(.+))"),
+    // 每个并行区间的最小字节数，小文件不值得启动线程
+    static constexpr size_t MIN_PARALLEL_CHUNK_BYTES = 1 << 20;
+
+    // 逐条解析文件时每个扫描窗口的字节数，扫过的映射页随即丢弃
+    static constexpr size_t STREAM_WINDOW_BYTES = 16 << 20;
+
+    // 无法映射的输入（管道、标准输入）按签名匹配时每次读取的字节数
+    static constexpr size_t STREAM_CHUNK_BYTES = 1 << 20;
+
+    // --recent 反向扫描时每次预读的字节数，只为实际读到的末尾部分安排 I/O
+    static constexpr size_t TAIL_PREFETCH_BYTES = 1 << 20;
+
+    // k 路归并：每个分段已按时间排序，时间相同时保持分段顺序
+    static std::vector<LogEntry> mergeSortedRuns(std::vector<std::vector<LogEntry>>& runs) {
+        std::vector<LogEntry> merged;
+        size_t total = 0;
+        for (const auto& run : runs) {
+            total += run.size();
+        }
+        merged.reserve(total);
         
-        // Syslog 格式  
-        std::regex(R"((\w{3} \d{1,2} \d{2}:\d{2}:\d{2})\s+(\w+)\s+([^:]+):\s+(.+))"),
+        // 堆元素：(分段下标, 分段内位置)
+        using Cursor = std::pair<size_t, size_t>;
+        auto later = [&runs](const Cursor& a, const Cursor& b) {
+            const auto& ta = runs[a.first][a.second].getTimestamp();
+            const auto& tb = runs[b.first][b.second].getTimestamp();
+            return ta != tb ? tb < ta : b.first < a.first;
+        };
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heap(later);
         
-        // Java 应用日志格式
-        std::regex(R"((\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2},\d{3})\s+(\w+)\s+\[([^\]]+)\]\s+(.+))"),
+        for (size_t i = 0; i < runs.size(); ++i) {
+            if (!runs[i].empty()) {
+                heap.emplace(i, 0);
+            }
+        }
         
-        // 简单格式：时间戳 + 级别 + 消息
-        std::regex(R"((\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2})\s+(\w+):\s+(.+))"),
+        while (!heap.empty()) {
+            Cursor top = heap.top();
+            heap.pop();
+            auto& run = runs[top.first];
+            merged.emplace_back(std::move(run[top.second]));
+            
+            // 同一分段中连续更早的条目无需经过堆
+            size_t next = top.second + 1;
+            while (next < run.size() &&
+                   (heap.empty() || !later(Cursor(top.first, next), heap.top()))) {
+                merged.emplace_back(std::move(run[next]));
+                ++next;
+            }
+            if (next < run.size()) {
+                heap.emplace(top.first, next);
+            }
+        }
         
-        // 带毫秒的格式
-        std::regex(R"((\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3}Z?)\s+\[(\w+)\]\s+\[([^\]]+)\]\s+(.+))")
-    };
+        return merged;
+    }
 
     // 构造函数
     LogParser::LogParser() 
-        : totalLines_(0), parsedLines_(0), errorLines_(0) {
+        : patternHash_(0), totalLines_(0), parsedLines_(0), errorLines_(0), customMatches_(0),
+          threadCount_(1), fieldMask_(FIELD_ALL), sampler_(nullptr) {
+        formatMatches_.fill(0);
+        for (size_t i = 0; i < LOG_FORMAT_COUNT; ++i) {
+            formatOrder_[i] = static_cast<std::uint8_t>(i);
+        }
+    }
+
+    // 设置线程数
+    void LogParser::setThreadCount(unsigned threads) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threadCount_ = threads;
+    }
+
+    // 创建工作解析器：共享模式配置，统计信息独立
+    std::unique_ptr<LogParser> LogParser::createWorker() const {
+        auto worker = std::make_unique<LogParser>();
+        worker->customPatterns_ = customPatterns_;
+        worker->patternHash_ = patternHash_;
+        worker->fieldMask_ = fieldMask_;
+        if (sketches_) {
+            worker->sketches_ = std::make_unique<LogSketches>(sketches_->options());
+        }
+        if (templateMiner_) {
+            worker->templateMiner_ = std::make_unique<TemplateMiner>(templateMiner_->options());
+        }
+        worker->observeFilter_ = observeFilter_;
+        return worker;
+    }
+    
+    // 启用近似统计
+    void LogParser::enableSketches(const SketchOptions& options) {
+        sketches_ = std::make_unique<LogSketches>(options);
+    }
+    
+    // 启用模板挖掘
+    void LogParser::enableTemplateMining(const TemplateMinerOptions& options) {
+        templateMiner_ = std::make_unique<TemplateMiner>(options);
+    }
+
+    // 合并统计信息
+    void LogParser::mergeStats(const LogParser& other) {
+        totalLines_ += other.totalLines_;
+        parsedLines_ += other.parsedLines_;
+        errorLines_ += other.errorLines_;
+        customMatches_ += other.customMatches_;
+        for (size_t i = 0; i < LOG_FORMAT_COUNT; ++i) {
+            formatMatches_[i] += other.formatMatches_[i];
+        }
+        if (sketches_ && other.sketches_) {
+            sketches_->merge(*other.sketches_);
+        }
+        if (templateMiner_ && other.templateMiner_) {
+            templateMiner_->merge(*other.templateMiner_);
+        }
     }
 
     // 添加自定义模式
@@ -39,6 +148,8 @@ namespace LogAnalyzer {
         try {
             std::regex customRegex(pattern);
             customPatterns_.push_back(std::move(customRegex));
+            patternHash_ = hashBytes(pattern, patternHash_ == 0 ? FNV_OFFSET_BASIS : patternHash_);
+            patternHash_ = hashBytes(std::string_view("\n", 1), patternHash_);
             return true;
         } catch (const std::regex_error& e) {
             std::cerr << "错误：无效的正则表达式模式: " << e.what() << std::endl;
@@ -47,95 +158,159 @@ namespace LogAnalyzer {
     }
 
     // 尝试用给定模式解析日志行
-    std::unique_ptr<LogEntry> LogParser::tryParseWithPattern(const std::string& line, 
-                                                           const std::regex& pattern) const {
-        std::smatch matches;
-        if (std::regex_match(line, matches, pattern)) {
-            try {
-                // 根据匹配组数量判断日志格式
-                if (matches.size() >= 4) {
-                    std::string timestampStr = matches[1].str();
-                    std::string levelStr = matches[2].str();
-                    std::string sourceStr = matches.size() >= 5 ? matches[3].str() : "unknown";
-                    std::string messageStr = matches.size() >= 5 ? matches[4].str() : matches[3].str();
-                    
-                    auto timestamp = parseTimestamp(timestampStr);
-                    auto level = stringToLogLevel(levelStr);
-                    
-                    return std::make_unique<LogEntry>(timestamp, level, sourceStr, messageStr);
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "解析日志条目时发生错误: " << e.what() << std::endl;
+    bool LogParser::tryParseWithPattern(std::string_view line, const std::regex& pattern,
+                                        LogEntry& entry) const {
+        std::cmatch matches;
+        if (std::regex_match(line.data(), line.data() + line.size(), matches, pattern)) {
+            // 根据匹配组数量判断日志格式
+            if (matches.size() >= 4) {
+                auto group = [&matches](size_t i) {
+                    return std::string_view(matches[i].first, static_cast<size_t>(matches[i].length()));
+                };
+                return makeEntry(group(1), group(2),
+                                 matches.size() >= 5 ? group(3) : std::string_view("unknown"),
+                                 matches.size() >= 5 ? group(4) : group(3),
+                                 entry);
             }
         }
-        return nullptr;
+        return false;
+    }
+
+    // 尝试用内置格式扫描器解析日志行
+    bool LogParser::tryParseWithFormat(std::string_view line, LogFormat format, LogEntry& entry) const {
+        LogFields fields;
+        if (!scanLogLine(format, line, fields)) {
+            return false;
+        }
+        return makeEntry(fields.timestamp, fields.level,
+                         fields.hasSource ? fields.source : std::string_view("unknown"),
+                         fields.message, entry);
+    }
+
+    // 由字段构造日志条目
+    bool LogParser::makeEntry(std::string_view timestampStr,
+                              std::string_view levelStr,
+                              std::string_view sourceStr,
+                              std::string_view messageStr,
+                              LogEntry& entry) const {
+        try {
+            // 按投影跳过不需要的字段
+            auto level = stringToLogLevel(levelStr);
+            auto timestamp = (fieldMask_ & FIELD_TIMESTAMP) ? parseTimestamp(timestampStr)
+                                                            : std::chrono::system_clock::time_point();
+            std::uint32_t sourceId = (fieldMask_ & FIELD_SOURCE) ? SourceTable::intern(sourceStr) : 0;
+            std::string_view message = (fieldMask_ & FIELD_MESSAGE) ? MessageArena::current().store(messageStr)
+                                                                    : std::string_view("");
+            entry = LogEntry::fromStored(timestamp, level, sourceId, message);
+            return true;
+        } catch (const std::exception& e) {
+            std::cerr << "解析日志条目时发生错误: " << e.what() << std::endl;
+        }
+        return false;
     }
 
     // 解析时间戳
-    std::chrono::system_clock::time_point LogParser::parseTimestamp(const std::string& timestampStr) const {
-        std::istringstream ss(timestampStr);
-        std::tm tm = {};
-        
-        // 尝试不同的时间格式
-        std::vector<std::string> formats = {
-            "%Y-%m-%d %H:%M:%S",           // 2024-01-15 14:30:45
-            "%Y-%m-%dT%H:%M:%S",           // 2024-01-15T14:30:45
-            "%Y-%m-%d %H:%M:%S,%f",        // 2024-01-15 14:30:45,123
-            "%Y-%m-%dT%H:%M:%S.%f",        // 2024-01-15T14:30:45.123
-            "%b %d %H:%M:%S"               // Jan 15 14:30:45
-        };
+    std::chrono::system_clock::time_point LogParser::parseTimestamp(std::string_view timestampStr) const {
+        std::chrono::system_clock::time_point timestamp;
         
-        for (const auto& format : formats) {
-            ss.clear();
-            ss.str(timestampStr);
-            ss >> std::get_time(&tm, format.c_str());
-            if (!ss.fail()) {
-                break;
-            }
+        // 抽样行单独计时时间戳换算
+        PerformanceMonitor::Clock::time_point start;
+        if (sampler_ && sampler_->sampling()) {
+            start = PerformanceMonitor::Clock::now();
         }
         
         // 如果解析失败，使用当前时间
-        if (ss.fail()) {
+        bool parsed = timestampParser_.parse(timestampStr, timestamp);
+        if (sampler_ && sampler_->sampling()) {
+            sampler_->addTimestamp(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                PerformanceMonitor::Clock::now() - start).count()));
+        }
+        if (!parsed) {
             return std::chrono::system_clock::now();
         }
-        
-        auto time_t_value = std::mktime(&tm);
-        return std::chrono::system_clock::from_time_t(time_t_value);
+        return timestamp;
     }
 
     // 解析单行日志
-    std::unique_ptr<LogEntry> LogParser::parseLine(const std::string& line) {
+    bool LogParser::parseLine(std::string_view line, LogEntry& entry) {
         totalLines_++;
         
         // 跳过空行
-        if (line.empty() || line.find_first_not_of(" \t\r\n") == std::string::npos) {
-            return nullptr;
+        if (line.empty() || line.find_first_not_of(" \t\r\n") == std::string_view::npos) {
+            return false;
         }
         
-        // 首先尝试自定义模式
+        // 首先尝试自定义模式（优先级高于内置格式，必须按顺序尝试）
         for (const auto& pattern : customPatterns_) {
-            auto entry = tryParseWithPattern(line, pattern);
-            if (entry) {
+            if (tryParseWithPattern(line, pattern, entry)) {
+                customMatches_++;
                 parsedLines_++;
-                return entry;
+                observeEntry(entry);
+                return true;
             }
         }
         
-        // 然后尝试预定义模式
-        for (const auto& pattern : LOG_PATTERNS) {
-            auto entry = tryParseWithPattern(line, pattern);
-            if (entry) {
+        // 然后按自适应顺序尝试内置格式扫描器，最常命中的格式最先尝试，未命中时依次回退
+        for (size_t k = 0; k < LOG_FORMAT_COUNT; ++k) {
+            size_t format = formatOrder_[k];
+            if (tryParseWithFormat(line, static_cast<LogFormat>(format), entry)) {
+                // 命中次数超过前一位时前移一位
+                formatMatches_[format]++;
+                if (k > 0 && formatMatches_[format] > formatMatches_[formatOrder_[k - 1]]) {
+                    std::swap(formatOrder_[k], formatOrder_[k - 1]);
+                }
                 parsedLines_++;
-                return entry;
+                observeEntry(entry);
+                return true;
             }
         }
         
         errorLines_++;
-        return nullptr;
+        return false;
+    }
+
+    // 解析单行日志（便捷版本）
+    std::unique_ptr<LogEntry> LogParser::parseLine(std::string_view line) {
+        auto entry = std::make_unique<LogEntry>();
+        if (!parseLine(line, *entry)) {
+            return nullptr;
+        }
+        return entry;
     }
 
     // 解析文件
     std::vector<LogEntry> LogParser::parseFile(const std::string& filename) {
+        if (filename == "-") {
+            return parseStream(std::cin);
+        }
+        
+        // 普通文件走 mmap 零拷贝路径
+        MappedFile mapped;
+        bool mappedOk;
+        {
+            PerformanceMonitor::Timer timer(Stage::READ);
+            mappedOk = mapped.open(filename);
+            timer.setVolume(mapped.size(), 0);
+        }
+        if (mappedOk) {
+            if (!CompressedInput::isCompressed(mapped.view())) {
+                return parseBuffer(mapped.view());
+            }
+            
+            // 压缩文件：解压出的每段完整行仍可分块并行解析
+            std::vector<LogEntry> entries;
+            forEachDecompressedLines(mapped.view(), [this, &entries](std::string_view lines) {
+                auto part = parseBuffer(lines);
+                if (entries.empty()) {
+                    entries = std::move(part);
+                } else {
+                    entries.insert(entries.end(), part.begin(), part.end());
+                }
+            });
+            return entries;
+        }
+        
+        // 管道、设备等无法映射的输入回退到流式读取
         std::ifstream file(filename);
         if (!file.is_open()) {
             throw std::runtime_error("无法打开文件: " + filename);
@@ -144,37 +319,823 @@ namespace LogAnalyzer {
         return parseStream(file);
     }
 
+    // 逐条解析日志文件
+    void LogParser::parseFile(const std::string& filename, const EntryCallback& callback) {
+        // 每用满一块就重置临时内存池，回调之后不再引用之前的消息
+        MessageArena scratch;
+        MessageArena::Scope scope(scratch);
+        scanFile(filename, [&](const LogEntry& entry) {
+            callback(entry);
+            if (scratch.bytesUsed() >= MessageArena::DEFAULT_BLOCK_SIZE) {
+                scratch.reset();
+            }
+        });
+    }
+    
+    // 按批解析日志文件
+    void LogParser::parseFileBatches(const std::string& filename, size_t batchSize, const BatchCallback& callback) {
+        if (batchSize == 0) {
+            throw std::invalid_argument("批次大小必须为正数");
+        }
+        
+        // 整批交付之后才重置临时内存池
+        MessageArena scratch;
+        MessageArena::Scope scope(scratch);
+        std::vector<LogEntry> batch;
+        batch.reserve(batchSize);
+        auto deliver = [&]() {
+            callback(batch);
+            batch.clear();
+            if (scratch.bytesUsed() >= MessageArena::DEFAULT_BLOCK_SIZE) {
+                scratch.reset();
+            }
+        };
+        
+        // 多线程时每个窗口分块并行解析；窗口内的消息都在内存池中，逐批交付完之后才能重置
+        std::function<void(std::string_view)> onWindow;
+        if (threadCount_ > 1) {
+            onWindow = [&](std::string_view window) {
+                std::vector<LogEntry> entries = parseBuffer(window);
+                for (size_t begin = 0; begin < entries.size(); begin += batchSize) {
+                    size_t end = std::min(entries.size(), begin + batchSize);
+                    batch.assign(entries.begin() + begin, entries.begin() + end);
+                    callback(batch);
+                }
+                batch.clear();
+                if (scratch.bytesUsed() >= MessageArena::DEFAULT_BLOCK_SIZE) {
+                    scratch.reset();
+                }
+            };
+        }
+        scanFile(filename, [&](const LogEntry& entry) {
+            batch.push_back(entry);
+            if (batch.size() == batchSize) {
+                deliver();
+            }
+        }, onWindow);
+        if (!batch.empty()) {
+            deliver();
+        }
+    }
+    
+    // 逐条解析日志文件的输入部分：标准输入、压缩文件、按窗口扫描的映射文件或普通流
+    void LogParser::scanFile(const std::string& filename, const EntryCallback& deliver,
+                             const std::function<void(std::string_view)>& onWindow) {
+        if (filename == "-") {
+            parseStream(std::cin, deliver);
+            return;
+        }
+        
+        MappedFile mapped;
+        bool mappedOk;
+        {
+            PerformanceMonitor::Timer timer(Stage::READ);
+            mappedOk = mapped.open(filename);
+            timer.setVolume(mapped.size(), 0);
+        }
+        if (mappedOk) {
+            std::string_view data = mapped.view();
+            if (CompressedInput::isCompressed(data)) {
+                forEachDecompressedLines(data, [&](std::string_view lines) {
+                    parseBuffer(lines, deliver);
+                });
+                return;
+            }
+            
+            // 按整行窗口扫描，扫过的页立即丢弃
+            size_t offset = 0;
+            while (offset < data.size()) {
+                size_t end = std::min(data.size(), offset + STREAM_WINDOW_BYTES);
+                if (end < data.size()) {
+                    size_t newline = data.find('\n', end - 1);
+                    end = newline == std::string_view::npos ? data.size() : newline + 1;
+                }
+                if (onWindow) {
+                    onWindow(data.substr(offset, end - offset));
+                } else {
+                    parseBuffer(data.substr(offset, end - offset), deliver);
+                }
+                mapped.discardBefore(end);
+                offset = end;
+            }
+            return;
+        }
+        
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("无法打开文件: " + filename);
+        }
+        parseStream(file, deliver);
+    }
+
     // 解析多个文件
     std::vector<LogEntry> LogParser::parseFiles(const std::vector<std::string>& filenames) {
-        std::vector<LogEntry> allEntries;
+        const size_t fileCount = filenames.size();
+        std::vector<std::vector<LogEntry>> runs(fileCount);
+        std::vector<std::unique_ptr<LogParser>> workers(fileCount);
+        std::vector<std::string> errors(fileCount);
         
-        for (const auto& filename : filenames) {
+        // 文件级并发数；剩余线程留给单个文件内部的分块解析
+        unsigned fileThreads = static_cast<unsigned>(std::min<size_t>(threadCount_, fileCount));
+        unsigned chunkThreads = std::max(1u, threadCount_ / std::max(1u, fileThreads));
+        
+        auto parseOne = [&](size_t i) {
+            workers[i] = createWorker();
+            workers[i]->threadCount_ = chunkThreads;
             try {
-                auto fileEntries = parseFile(filename);
-                allEntries.insert(allEntries.end(), 
-                                std::make_move_iterator(fileEntries.begin()),
-                                std::make_move_iterator(fileEntries.end()));
+                runs[i] = workers[i]->parseFile(filenames[i]);
             } catch (const std::exception& e) {
-                std::cerr << "解析文件 " << filename << " 时发生错误: " << e.what() << std::endl;
+                errors[i] = e.what();
+                return;
+            }
+            
+            // 单个文件通常已按时间排列，只有乱序时才在本地排序（条目数由归并计入，这里只计耗时）
+            PerformanceMonitor::Timer timer(Stage::SORT_MERGE);
+            if (!std::is_sorted(runs[i].begin(), runs[i].end())) {
+                std::stable_sort(runs[i].begin(), runs[i].end());
+            }
+        };
+        
+        if (fileThreads <= 1) {
+            for (size_t i = 0; i < fileCount; ++i) {
+                parseOne(i);
+            }
+        } else {
+            // 每个线程写入自己的内存池，结束后交给调用线程的当前内存池
+            std::atomic<size_t> nextFile(0);
+            std::deque<MessageArena> arenas(fileThreads);
+            std::vector<std::thread> pool;
+            for (unsigned t = 0; t < fileThreads; ++t) {
+                pool.emplace_back([&, t]() {
+                    MessageArena::Scope scope(arenas[t]);
+                    for (size_t i = nextFile++; i < fileCount; i = nextFile++) {
+                        parseOne(i);
+                    }
+                });
+            }
+            for (auto& thread : pool) {
+                thread.join();
+            }
+            for (auto& arena : arenas) {
+                arena.releaseTo(MessageArena::current());
             }
         }
         
-        // 按时间戳排序
-        std::sort(allEntries.begin(), allEntries.end());
+        // 按文件顺序汇总统计信息与错误
+        for (size_t i = 0; i < fileCount; ++i) {
+            mergeStats(*workers[i]);
+            if (!errors[i].empty()) {
+                std::cerr << "解析文件 " << filenames[i] << " 时发生错误: " << errors[i] << std::endl;
+            }
+        }
         
-        return allEntries;
+        PerformanceMonitor::Timer timer(Stage::SORT_MERGE);
+        auto merged = mergeSortedRuns(runs);
+        timer.setVolume(0, merged.size());
+        return merged;
+    }
+
+    // 解压并按完整行交付
+    void LogParser::forEachDecompressedLines(std::string_view data,
+                                             const std::function<void(std::string_view)>& onLines) {
+        // 解压耗时 = 总耗时 - 回调中解析的耗时
+        const bool timed = PerformanceMonitor::enabled();
+        const auto start = PerformanceMonitor::Clock::now();
+        std::uint64_t callbackNanos = 0;
+        std::uint64_t decompressedBytes = 0;
+        auto deliver = [&](std::string_view lines) {
+            decompressedBytes += lines.size();
+            if (!timed) {
+                onLines(lines);
+                return;
+            }
+            auto callbackStart = PerformanceMonitor::Clock::now();
+            onLines(lines);
+            callbackNanos += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                PerformanceMonitor::Clock::now() - callbackStart).count());
+        };
+        
+        std::string pending;   // 上一块末尾未结束的行
+        CompressedInput::decompress(data, threadCount_, [&](std::string_view block) {
+            size_t lastNewline = block.rfind('\n');
+            if (lastNewline == std::string_view::npos) {
+                pending.append(block);
+                return;
+            }
+            
+            // 先补完跨块的那一行，其余完整行直接从解压块中交付
+            size_t begin = 0;
+            if (!pending.empty()) {
+                size_t firstNewline = block.find('\n');
+                pending.append(block.substr(0, firstNewline + 1));
+                deliver(pending);
+                pending.clear();
+                begin = firstNewline + 1;
+            }
+            if (begin <= lastNewline) {
+                deliver(block.substr(begin, lastNewline + 1 - begin));
+            }
+            pending.assign(block.substr(lastNewline + 1));
+        });
+        if (!pending.empty()) {
+            deliver(pending);
+        }
+        
+        if (timed) {
+            std::uint64_t total = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                PerformanceMonitor::Clock::now() - start).count());
+            std::uint64_t decompressNanos = total > callbackNanos ? total - callbackNanos : 0;
+            PerformanceMonitor::record(Stage::READ, decompressNanos, decompressedBytes, 0);
+            PerformanceMonitor::recordBusy(decompressNanos);
+        }
     }
 
     // 解析输入流
     std::vector<LogEntry> LogParser::parseStream(std::istream& input) {
         std::vector<LogEntry> entries;
+        parseStream(input, [&entries](const LogEntry& entry) {
+            entries.push_back(entry);
+        });
+        return entries;
+    }
+
+    // 逐条解析输入流
+    void LogParser::parseStream(std::istream& input, const EntryCallback& callback) {
         std::string line;
+        LogEntry entry;
         
-        while (std::getline(input, line)) {
-            auto entry = parseLine(line);
-            if (entry) {
-                entries.emplace_back(std::move(*entry));
+        // 流式读取时读入与切分无法分开，一并计入切分
+        ParseSampler sampler(sampler_);
+        auto lineStart = PerformanceMonitor::Clock::time_point();
+        while (true) {
+            const bool sampled = sampler.beginLine();
+            if (sampled) {
+                lineStart = PerformanceMonitor::Clock::now();
+            }
+            if (!std::getline(input, line)) {
+                break;
             }
+            auto parseStart = sampled ? PerformanceMonitor::Clock::now() : lineStart;
+            bool parsed = parseLine(line, entry);
+            if (sampled) {
+                sampler.endLine(lineStart, parseStart, PerformanceMonitor::Clock::now());
+            }
+            sampler.addVolume(line.size() + 1, 1);
+            if (parsed) {
+                callback(entry);
+            }
+        }
+    }
+
+    // 解析内存缓冲区：行视图直接指向缓冲区，不做逐行拷贝
+    std::vector<LogEntry> LogParser::parseBuffer(std::string_view buffer) {
+        unsigned threads = static_cast<unsigned>(
+            std::min<size_t>(threadCount_, buffer.size() / MIN_PARALLEL_CHUNK_BYTES));
+        if (threads > 1) {
+            return parseBufferParallel(buffer, threads);
+        }
+        
+        std::vector<LogEntry> entries;
+        parseBuffer(buffer, entries);
+        return entries;
+    }
+
+    // 解析内存缓冲区并追加到批次
+    size_t LogParser::parseBuffer(std::string_view buffer, std::vector<LogEntry>& batch) {
+        const size_t before = batch.size();
+        const char* cursor = buffer.data();
+        const char* end = buffer.data() + buffer.size();
+        
+        LogEntry entry;
+        ParseSampler sampler(sampler_);
+        size_t lines = 0;
+        while (cursor < end) {
+            const bool sampled = sampler.beginLine();
+            auto splitStart = sampled ? PerformanceMonitor::Clock::now() : PerformanceMonitor::Clock::time_point();
+            const char* newline = static_cast<const char*>(
+                std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+            const char* lineEnd = newline ? newline : end;
+            
+            auto parseStart = sampled ? PerformanceMonitor::Clock::now() : splitStart;
+            bool parsed = parseLine(std::string_view(cursor, static_cast<size_t>(lineEnd - cursor)), entry);
+            if (sampled) {
+                sampler.endLine(splitStart, parseStart, PerformanceMonitor::Clock::now());
+            }
+            if (parsed) {
+                batch.push_back(entry);
+            }
+            cursor = newline ? newline + 1 : end;
+            ++lines;
+        }
+        sampler.addVolume(buffer.size(), lines);
+        return batch.size() - before;
+    }
+
+    // 逐条解析内存缓冲区
+    void LogParser::parseBuffer(std::string_view buffer, const EntryCallback& callback) {
+        const char* cursor = buffer.data();
+        const char* end = buffer.data() + buffer.size();
+        
+        // 与 std::getline 保持一致：末尾没有换行符的最后一行也算一行
+        LogEntry entry;
+        ParseSampler sampler(sampler_);
+        size_t lines = 0;
+        while (cursor < end) {
+            const bool sampled = sampler.beginLine();
+            auto splitStart = sampled ? PerformanceMonitor::Clock::now() : PerformanceMonitor::Clock::time_point();
+            const char* newline = static_cast<const char*>(
+                std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+            const char* lineEnd = newline ? newline : end;
+            
+            auto parseStart = sampled ? PerformanceMonitor::Clock::now() : splitStart;
+            bool parsed = parseLine(std::string_view(cursor, static_cast<size_t>(lineEnd - cursor)), entry);
+            if (sampled) {
+                sampler.endLine(splitStart, parseStart, PerformanceMonitor::Clock::now());
+            }
+            if (parsed) {
+                callback(entry);
+            }
+            cursor = newline ? newline + 1 : end;
+            ++lines;
+        }
+        sampler.addVolume(buffer.size(), lines);
+    }
+
+    // 只解析文件末尾的 N 条日志
+    std::vector<LogEntry> LogParser::parseTail(const std::string& filename, size_t count,
+                                               const EntryFilter& filter) {
+        std::vector<LogEntry> tail;
+        if (count == 0) {
+            return tail;
+        }
+        
+        // 反向扫描只读取文件末尾，按随机访问映射，不为整个文件安排预读
+        MappedFile mapped;
+        const bool mappedOk = filename != "-" && mapped.open(filename, MappedFile::Access::RANDOM);
+        if (mappedOk && !CompressedInput::isCompressed(mapped.view())) {
+            // 从文件末尾反向逐行扫描；结尾的换行符属于最后一行
+            const char* data = mapped.data();
+            size_t lineEnd = mapped.size();
+            if (lineEnd > 0 && data[lineEnd - 1] == '\n') {
+                --lineEnd;
+            }
+            
+            // 扫描位置越过已预读的窗口时，再预读它前面的一个窗口
+            size_t prefetched = mapped.size();
+            auto prefetchBefore = [&](size_t position) {
+                while (prefetched > 0 && position < prefetched) {
+                    size_t start = prefetched > TAIL_PREFETCH_BYTES ? prefetched - TAIL_PREFETCH_BYTES : 0;
+                    mapped.prefetch(start, prefetched - start);
+                    prefetched = start;
+                }
+            };
+            bool more = mapped.size() > 0;
+            PerformanceMonitor::Timer timer(Stage::PARSE);
+            size_t lines = 0;
+            
+            // 扫描过的行先解析到可重置的临时内存池，只把保留的消息拷贝到调用方的内存池，
+            // 过滤条件很稀疏时内存也只与 N 有关
+            MessageArena& target = MessageArena::current();
+            MessageArena scratch;
+            MessageArena::Scope scope(scratch);
+            while (more && tail.size() < count) {
+                prefetchBefore(lineEnd);
+                size_t lineStart = lineEnd;
+                while (lineStart > 0 && data[lineStart - 1] != '\n') {
+                    --lineStart;
+                    if (lineStart < prefetched) {
+                        prefetchBefore(lineStart);
+                    }
+                }
+                
+                LogEntry entry;
+                if (parseLine(std::string_view(data + lineStart, lineEnd - lineStart), entry) &&
+                    (!filter || filter(entry))) {
+                    tail.push_back(LogEntry::fromStored(entry.getTimestamp(), entry.getLevel(), entry.getSourceId(),
+                                                        target.store(entry.getMessage())));
+                }
+                if (scratch.bytesUsed() >= MessageArena::DEFAULT_BLOCK_SIZE) {
+                    scratch.reset();
+                }
+                
+                more = lineStart > 0;
+                lineEnd = more ? lineStart - 1 : 0;
+                ++lines;
+            }
+            timer.setVolume(mapped.size() - (more ? lineEnd + 1 : 0), lines);
+            std::reverse(tail.begin(), tail.end());
+            return tail;
+        }
+        
+        // 压缩文件无法反向读取，与流式输入一样顺序解析
+        std::ifstream file;
+        if (filename != "-" && !mappedOk) {
+            file.open(filename);
+            if (!file.is_open()) {
+                throw std::runtime_error("无法打开文件: " + filename);
+            }
+        }
+        std::istream& input = filename == "-" ? std::cin : file;
+        
+        // 顺序读取：环形缓冲区只保留最后 N 条，消息先写入可重置的临时内存池
+        struct TailSlot {
+            LogEntry entry;
+            std::string message;
+        };
+        std::deque<TailSlot> ring;
+        MessageArena scratch;
+        {
+            MessageArena::Scope scope(scratch);
+            auto keep = [&](const LogEntry& entry) {
+                if (!filter || filter(entry)) {
+                    ring.push_back({entry, std::string(entry.getMessage())});
+                    if (ring.size() > count) {
+                        ring.pop_front();
+                    }
+                }
+                if (scratch.bytesUsed() >= MessageArena::DEFAULT_BLOCK_SIZE) {
+                    scratch.reset();
+                }
+            };
+            if (mappedOk) {
+                mapped.prefetch(0, mapped.size());
+                forEachDecompressedLines(mapped.view(), [&](std::string_view lines) {
+                    parseBuffer(lines, keep);
+                });
+            } else {
+                parseStream(input, keep);
+            }
+        }
+        
+        tail.reserve(ring.size());
+        for (auto& slot : ring) {
+            slot.entry.setMessage(slot.message);
+            tail.push_back(slot.entry);
+        }
+        return tail;
+    }
+
+    // 多个文件合并后的最后 N 条日志
+    std::vector<LogEntry> LogParser::parseFilesTail(const std::vector<std::string>& filenames,
+                                                    size_t count, const EntryFilter& filter) {
+        std::vector<std::vector<LogEntry>> runs;
+        
+        for (const auto& filename : filenames) {
+            try {
+                runs.push_back(parseTail(filename, count, filter));
+                if (!std::is_sorted(runs.back().begin(), runs.back().end())) {
+                    std::stable_sort(runs.back().begin(), runs.back().end());
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "解析文件 " << filename << " 时发生错误: " << e.what() << std::endl;
+            }
+        }
+        
+        auto merged = mergeSortedRuns(runs);
+        if (merged.size() > count) {
+            merged.erase(merged.begin(), merged.end() - static_cast<std::ptrdiff_t>(count));
+        }
+        return merged;
+    }
+
+    // 可以映射且未压缩的文件才建立索引
+    bool LogParser::supportsIndex(const std::string& filename) {
+        // 只读取开头的魔数，不预读整个文件
+        MappedFile mapped;
+        return filename != "-" && mapped.open(filename, MappedFile::Access::RANDOM) &&
+               !CompressedInput::isCompressed(mapped.view());
+    }
+    
+    // 只解析时间范围内的日志
+    std::vector<LogEntry> LogParser::parseFileRange(const std::string& filename,
+                                                    const std::chrono::system_clock::time_point& begin,
+                                                    const std::chrono::system_clock::time_point& end) {
+        auto outOfRange = [&](const LogEntry& entry) {
+            return entry.getTimestamp() < begin || entry.getTimestamp() >= end;
+        };
+        
+        std::vector<LogEntry> entries;
+        MappedFile mapped;
+        if (filename != "-" && mapped.open(filename, MappedFile::Access::RANDOM) &&
+            !CompressedInput::isCompressed(mapped.view())) {
+            // 这里只探测了压缩魔数，随后只映射并预读时间范围对应的字节区间
+            // 建立索引的扫描使用独立的工作解析器，不计入本解析器的统计
+            mapped.close();
+            auto indexer = createWorker();
+            indexer->setFieldMask(FIELD_ALL);
+            indexer->sketches_.reset();
+            indexer->templateMiner_.reset();
+            TimeIndex index = TimeIndex::loadOrBuild(filename, *indexer);
+            auto range = index.byteRange(begin, end);
+            
+            size_t length = static_cast<size_t>(std::min<std::uint64_t>(range.second - range.first, SIZE_MAX));
+            if (!mapped.openRange(filename, static_cast<size_t>(range.first), length)) {
+                throw std::runtime_error("无法打开文件: " + filename);
+            }
+            entries = parseBuffer(mapped.view());
+        } else {
+            entries = parseFile(filename);
+        }
+        
+        // 边界时间桶中可能混有范围外的行
+        entries.erase(std::remove_if(entries.begin(), entries.end(), outOfRange), entries.end());
+        return entries;
+    }
+
+    // 多个文件中时间范围内的日志
+    std::vector<LogEntry> LogParser::parseFilesInRange(const std::vector<std::string>& filenames,
+                                                       const std::chrono::system_clock::time_point& begin,
+                                                       const std::chrono::system_clock::time_point& end) {
+        std::vector<std::vector<LogEntry>> runs;
+        
+        for (const auto& filename : filenames) {
+            try {
+                runs.push_back(parseFileRange(filename, begin, end));
+                if (!std::is_sorted(runs.back().begin(), runs.back().end())) {
+                    std::stable_sort(runs.back().begin(), runs.back().end());
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "解析文件 " << filename << " 时发生错误: " << e.what() << std::endl;
+            }
+        }
+        
+        return mergeSortedRuns(runs);
+    }
+
+    // 只解析满足关键词查询的日志
+    std::vector<LogEntry> LogParser::parseFileMatching(const std::string& filename, const KeywordQuery& query) {
+        std::vector<LogEntry> entries;
+        MappedFile mapped;
+        if (filename != "-" && mapped.open(filename, MappedFile::Access::RANDOM) &&
+            !CompressedInput::isCompressed(mapped.view())) {
+            // 倒排表给出的候选行分散在整个文件中，按随机访问映射，只读取命中的页
+            // 建立索引的扫描使用独立的工作解析器，不计入本解析器的统计
+            auto indexer = createWorker();
+            indexer->setFieldMask(FIELD_ALL);
+            indexer->sketches_.reset();
+            indexer->templateMiner_.reset();
+            KeywordIndex index = KeywordIndex::loadOrBuild(filename, *indexer);
+            
+            const char* data = mapped.data();
+            const size_t size = mapped.size();
+            {
+                PerformanceMonitor::Timer timer(Stage::PARSE);
+                auto offsets = index.lookup(query);
+                for (std::uint64_t offset : offsets) {
+                    if (offset >= size) {
+                        break;
+                    }
+                    const char* lineStart = data + offset;
+                    const char* newline = static_cast<const char*>(
+                        std::memchr(lineStart, '\n', size - static_cast<size_t>(offset)));
+                    const char* lineEnd = newline ? newline : data + size;
+                    
+                    // 倒排表只给出候选行，再用原消息确认一次
+                    LogEntry entry;
+                    if (parseLine(std::string_view(lineStart, static_cast<size_t>(lineEnd - lineStart)), entry) &&
+                        query.matches(entry.getMessage())) {
+                        entries.push_back(entry);
+                    }
+                }
+                timer.setVolume(0, offsets.size());
+            }
+            
+            // 尚未写完的最后半行不在索引中，直接检查
+            if (index.indexedBytes() < size) {
+                const size_t indexed = static_cast<size_t>(index.indexedBytes());
+                mapped.prefetch(indexed, size - indexed);
+                std::string_view rest(data + indexed, size - indexed);
+                parseBuffer(rest, [&](const LogEntry& entry) {
+                    if (query.matches(entry.getMessage())) {
+                        entries.push_back(entry);
+                    }
+                });
+            }
+            return entries;
+        }
+        
+        entries = parseFile(filename);
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [&query](const LogEntry& entry) { return !query.matches(entry.getMessage()); }),
+                      entries.end());
+        return entries;
+    }
+
+    // 多个文件中满足关键词查询的日志
+    std::vector<LogEntry> LogParser::parseFilesMatching(const std::vector<std::string>& filenames,
+                                                        const KeywordQuery& query) {
+        std::vector<std::vector<LogEntry>> runs;
+        
+        for (const auto& filename : filenames) {
+            try {
+                runs.push_back(parseFileMatching(filename, query));
+                if (!std::is_sorted(runs.back().begin(), runs.back().end())) {
+                    std::stable_sort(runs.back().begin(), runs.back().end());
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "解析文件 " << filename << " 时发生错误: " << e.what() << std::endl;
+            }
+        }
+        
+        return mergeSortedRuns(runs);
+    }
+
+    // 只解析包含任一签名的行
+    std::vector<LogEntry> LogParser::parseFileMatching(const std::string& filename,
+                                                       const MultiPatternMatcher& matcher,
+                                                       std::vector<size_t>& hitCounts,
+                                                       const EntryFilter& filter) {
+        MappedFile mapped;
+        if (filename != "-" && mapped.open(filename)) {
+            if (!CompressedInput::isCompressed(mapped.view())) {
+                return parseBufferMatching(mapped.view(), matcher, hitCounts, filter);
+            }
+            
+            // 签名不跨行，按解压出的完整行分段匹配
+            std::vector<LogEntry> entries;
+            forEachDecompressedLines(mapped.view(), [&](std::string_view lines) {
+                auto part = parseBufferMatching(lines, matcher, hitCounts, filter);
+                entries.insert(entries.end(), part.begin(), part.end());
+            });
+            return entries;
+        }
+        
+        std::ifstream file;
+        if (filename != "-") {
+            file.open(filename);
+            if (!file.is_open()) {
+                throw std::runtime_error("无法打开文件: " + filename);
+            }
+        }
+        std::istream& input = filename == "-" ? std::cin : file;
+        
+        // 与解压路径一样按整行分段匹配，内存只与单段大小有关，与输入总量无关
+        std::vector<LogEntry> entries;
+        auto matchLines = [&](std::string_view lines) {
+            auto part = parseBufferMatching(lines, matcher, hitCounts, filter);
+            entries.insert(entries.end(), part.begin(), part.end());
+        };
+        std::string pending;   // 上一段末尾未结束的行
+        std::vector<char> chunk(STREAM_CHUNK_BYTES);
+        while (input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || input.gcount() > 0) {
+            std::string_view block(chunk.data(), static_cast<size_t>(input.gcount()));
+            size_t lastNewline = block.rfind('\n');
+            if (lastNewline == std::string_view::npos) {
+                pending.append(block);
+                continue;
+            }
+            
+            // 先补完跨段的那一行，其余完整行直接从读入的块中匹配
+            size_t begin = 0;
+            if (!pending.empty()) {
+                size_t firstNewline = block.find('\n');
+                pending.append(block.substr(0, firstNewline + 1));
+                matchLines(pending);
+                begin = firstNewline + 1;
+            }
+            if (begin <= lastNewline) {
+                matchLines(block.substr(begin, lastNewline + 1 - begin));
+            }
+            pending.assign(block.substr(lastNewline + 1));
+        }
+        if (!pending.empty()) {
+            matchLines(pending);
+        }
+        return entries;
+    }
+
+    // 在缓冲区中查找包含任一签名的行
+    std::vector<LogEntry> LogParser::parseBufferMatching(std::string_view buffer,
+                                                         const MultiPatternMatcher& matcher,
+                                                         std::vector<size_t>& hitCounts,
+                                                         const EntryFilter& filter) {
+        if (hitCounts.size() < matcher.patternCount()) {
+            hitCounts.resize(matcher.patternCount(), 0);
+        }
+        
+        // 签名扫描与命中行的解析一并计入解析阶段
+        PerformanceMonitor::Timer timer(Stage::PARSE, buffer.size());
+        std::vector<LogEntry> entries;
+        std::vector<size_t> linePatterns;   // 当前行命中的签名（去重）
+        size_t lineStart = 0;
+        size_t lineEnd = 0;
+        
+        // 当前行的所有命中收集完后解析一次
+        auto finishLine = [&]() {
+            if (linePatterns.empty()) {
+                return;
+            }
+            LogEntry entry;
+            if (parseLine(buffer.substr(lineStart, lineEnd - lineStart), entry) && (!filter || filter(entry))) {
+                entries.push_back(entry);
+                for (size_t pattern : linePatterns) {
+                    hitCounts[pattern]++;
+                }
+            }
+            linePatterns.clear();
+        };
+        
+        // 签名不含换行符，每次匹配都完整落在一行之内
+        matcher.scan(buffer, [&](size_t pattern, size_t end) {
+            size_t position = end - 1;
+            if (linePatterns.empty() || position >= lineEnd) {
+                finishLine();
+                lineStart = position;
+                while (lineStart > 0 && buffer[lineStart - 1] != '\n') {
+                    --lineStart;
+                }
+                lineEnd = buffer.find('\n', position);
+                if (lineEnd == std::string_view::npos) {
+                    lineEnd = buffer.size();
+                }
+            }
+            if (std::find(linePatterns.begin(), linePatterns.end(), pattern) == linePatterns.end()) {
+                linePatterns.push_back(pattern);
+            }
+        });
+        finishLine();
+        timer.setVolume(buffer.size(), entries.size());
+        
+        return entries;
+    }
+
+    // 多个文件中包含任一签名的行
+    std::vector<LogEntry> LogParser::parseFilesMatching(const std::vector<std::string>& filenames,
+                                                        const MultiPatternMatcher& matcher,
+                                                        std::vector<size_t>& hitCounts,
+                                                        const EntryFilter& filter) {
+        std::vector<std::vector<LogEntry>> runs;
+        
+        for (const auto& filename : filenames) {
+            try {
+                runs.push_back(parseFileMatching(filename, matcher, hitCounts, filter));
+                if (!std::is_sorted(runs.back().begin(), runs.back().end())) {
+                    std::stable_sort(runs.back().begin(), runs.back().end());
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "解析文件 " << filename << " 时发生错误: " << e.what() << std::endl;
+            }
+        }
+        
+        return mergeSortedRuns(runs);
+    }
+
+    // 并行解析缓冲区
+    std::vector<LogEntry> LogParser::parseBufferParallel(std::string_view buffer, unsigned threads) {
+        // 按字节均分后把每个切分点推进到下一行的行首
+        std::vector<size_t> bounds(threads + 1, buffer.size());
+        bounds[0] = 0;
+        for (unsigned i = 1; i < threads; ++i) {
+            size_t pos = std::max(bounds[i - 1], buffer.size() / threads * i);
+            size_t newline = buffer.find('\n', pos);
+            bounds[i] = newline == std::string_view::npos ? buffer.size() : newline + 1;
+        }
+        
+        std::vector<std::unique_ptr<LogParser>> workers;
+        std::vector<std::vector<LogEntry>> results(threads);
+        std::vector<std::exception_ptr> errors(threads);
+        std::deque<MessageArena> arenas(threads);
+        std::vector<std::thread> pool;
+        
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.push_back(createWorker());
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            pool.emplace_back([&, i]() {
+                MessageArena::Scope scope(arenas[i]);
+                try {
+                    results[i] = workers[i]->parseBuffer(
+                        buffer.substr(bounds[i], bounds[i + 1] - bounds[i]));
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        for (auto& arena : arenas) {
+            arena.releaseTo(MessageArena::current());
+        }
+        
+        for (unsigned i = 0; i < threads; ++i) {
+            if (errors[i]) {
+                std::rethrow_exception(errors[i]);
+            }
+            mergeStats(*workers[i]);
+        }
+        
+        // 按文件顺序拼接各区间的结果
+        size_t total = 0;
+        for (const auto& part : results) {
+            total += part.size();
+        }
+        std::vector<LogEntry> entries;
+        entries.reserve(total);
+        for (auto& part : results) {
+            entries.insert(entries.end(),
+                           std::make_move_iterator(part.begin()),
+                           std::make_move_iterator(part.end()));
         }
         
         return entries;
@@ -191,6 +1152,14 @@ namespace LogAnalyzer {
         totalLines_ = 0;
         parsedLines_ = 0;
         errorLines_ = 0;
+        customMatches_ = 0;
+        formatMatches_.fill(0);
+        if (sketches_) {
+            sketches_ = std::make_unique<LogSketches>(sketches_->options());
+        }
+        if (templateMiner_) {
+            templateMiner_ = std::make_unique<TemplateMiner>(templateMiner_->options());
+        }
     }
 
     // 获取统计报告
@@ -202,11 +1171,33 @@ namespace LogAnalyzer {
             << "  解析失败: " << errorLines_ << "\n"
             << "  成功率: " << std::fixed << std::setprecision(2) 
             << getParseSuccessRate() << "%";
+        
+        // 按格式的匹配行数
+        if (parsedLines_ > 0) {
+            oss << "\n  按格式匹配:";
+            if (customMatches_ > 0) {
+                oss << "\n    自定义模式: " << customMatches_;
+            }
+            for (size_t i = 0; i < LOG_FORMAT_COUNT; ++i) {
+                if (formatMatches_[i] > 0) {
+                    oss << "\n    " << logFormatName(static_cast<LogFormat>(i)) << ": " << formatMatches_[i];
+                }
+            }
+        }
         return oss.str();
     }
 
     // 工具函数实现
     std::string detectLogFormat(const std::string& filename) {
+        MappedFile mapped;
+        if (mapped.open(filename, MappedFile::Access::RANDOM)) {
+            Compression compression = CompressedInput::detect(mapped.view());
+            if (compression != Compression::NONE) {
+                return std::string(CompressedInput::name(compression)) + " 压缩文件" +
+                       (CompressedInput::isSupported(compression) ? "" : "（当前构建不支持）");
+            }
+        }
+        
         std::ifstream file(filename);
         if (!file.is_open()) {
             return "文件无法读取";
@@ -0,0 +1,111 @@
+/*
+ * LogPipeline.cpp
+ * LogPipeline 类的实现
+ */
+
+#include "LogPipeline.h"
+#include "PerformanceMonitor.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace LogAnalyzer {
+
+    // 构造函数
+    LogPipeline::LogPipeline(LogParser& parser, size_t batchSize)
+        : parser_(parser), batchSize_(batchSize), parsedEntries_(0), passedEntries_(0) {
+        if (batchSize == 0) {
+            throw std::invalid_argument("批次大小必须为正数");
+        }
+    }
+
+    // 按代价插入，同类阶段保持添加顺序
+    LogPipeline& LogPipeline::addFilter(FilterStage stage) {
+        auto position = std::upper_bound(filters_.begin(), filters_.end(), stage.kind(),
+            [](FilterKind kind, const FilterStage& other) { return kind < other.kind(); });
+        filters_.insert(position, std::move(stage));
+        return *this;
+    }
+
+    LogPipeline& LogPipeline::addSink(BatchSink sink) {
+        sinks_.push_back(std::move(sink));
+        return *this;
+    }
+
+    bool LogPipeline::matches(const LogEntry& entry) const {
+        for (const auto& stage : filters_) {
+            if (!stage.matches(entry)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 融合过滤：一次遍历检查全部条件，保留的条目原地前移
+    size_t LogPipeline::filter(std::vector<LogEntry>& batch) const {
+        if (filters_.empty()) {
+            return batch.size();
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (matches(batch[i])) {
+                if (kept != i) {
+                    batch[kept] = batch[i];
+                }
+                ++kept;
+            }
+        }
+        batch.resize(kept);
+        return kept;
+    }
+
+    EntryFilter LogPipeline::entryFilter() const {
+        if (filters_.empty()) {
+            return EntryFilter();
+        }
+        return [filters = filters_](const LogEntry& entry) {
+            for (const auto& stage : filters) {
+                if (!stage.matches(entry)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+    }
+
+    void LogPipeline::process(std::vector<LogEntry>& batch) {
+        parsedEntries_ += batch.size();
+        if (!filters_.empty()) {
+            PerformanceMonitor::Timer timer(Stage::FILTER, 0, batch.size());
+            filter(batch);
+        }
+        passedEntries_ += batch.size();
+        if (batch.empty()) {
+            return;
+        }
+        for (const auto& sink : sinks_) {
+            sink(batch);
+        }
+    }
+
+    // 逐个文件解析成批次并推入流水线
+    void LogPipeline::run(const std::vector<std::string>& filenames) {
+        for (const auto& filename : filenames) {
+            bool inStages = false;
+            try {
+                parser_.parseFileBatches(filename, batchSize_, [&](std::vector<LogEntry>& batch) {
+                    inStages = true;
+                    process(batch);
+                    inStages = false;
+                });
+            } catch (const std::exception& e) {
+                // 过滤或接收阶段的错误与单个文件无关，交给调用方
+                if (inStages) {
+                    throw;
+                }
+                std::cerr << "解析文件 " << filename << " 时发生错误: " << e.what() << std::endl;
+            }
+        }
+    }
+
+} // namespace LogAnalyzer
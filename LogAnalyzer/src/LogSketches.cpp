@@ -0,0 +1,171 @@
+/*
+ * LogSketches.cpp
+ * LogSketches 类的实现
+ */
+
+#include "LogSketches.h"
+#include "LogStore.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        // 高频项标签的最大字节数
+        constexpr size_t MAX_LABEL_BYTES = 160;
+
+        // 来源编号的哈希种子，与消息哈希区分开
+        constexpr std::uint64_t SOURCE_SEED = 0x6c62272e07bb0142ull;
+
+        bool isDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        // 模板哈希：按模板文本逐字节计算 FNV-1a，不生成模板字符串
+        std::uint64_t templateHash(std::string_view message) {
+            std::uint64_t hash = 0xcbf29ce484222325ull;
+            for (size_t i = 0; i < message.size(); ++i) {
+                char c = message[i];
+                if (isDigit(c)) {
+                    while (i + 1 < message.size() && isDigit(message[i + 1])) {
+                        ++i;
+                    }
+                    c = '#';
+                }
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 0x100000001b3ull;
+            }
+            return mixHash(hash);
+        }
+
+        // 截断到不超过上限的完整 UTF-8 字符
+        void assignLabel(std::string& label, std::string_view text) {
+            if (text.size() > MAX_LABEL_BYTES) {
+                size_t cut = MAX_LABEL_BYTES;
+                while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) {
+                    --cut;
+                }
+                label.assign(text.substr(0, cut));
+                label += "...";
+            } else {
+                label.assign(text);
+            }
+        }
+
+    } // namespace
+
+    // 构造函数
+    LogSketches::LogSketches(const SketchOptions& options)
+        : options_(options), entries_(0),
+          distinctMessages_(options.hllPrecision),
+          distinctTemplates_(options.hllPrecision),
+          distinctSources_(options.hllPrecision),
+          sourceFrequency_(options.cmsError, 1.0 - options.cmsConfidence),
+          templateFrequency_(options.cmsError, 1.0 - options.cmsConfidence),
+          topSources_(options.capacity),
+          topTemplates_(options.capacity) {
+    }
+
+    // 计入一条日志：每个草图的更新都是常数时间，标签只在值新进入高频表时生成
+    void LogSketches::add(std::uint32_t sourceId, std::string_view message) {
+        ++entries_;
+
+        std::uint64_t sourceHash = mixHash(sourceId ^ SOURCE_SEED);
+        distinctSources_.add(sourceHash);
+        sourceFrequency_.add(sourceHash);
+        if (std::string* label = topSources_.add(sourceHash)) {
+            assignLabel(*label, SourceTable::name(sourceId));
+        }
+
+        distinctMessages_.add(mixHash(std::hash<std::string_view>()(message)));
+
+        std::uint64_t shapeHash = templateHash(message);
+        distinctTemplates_.add(shapeHash);
+        templateFrequency_.add(shapeHash);
+        if (std::string* label = topTemplates_.add(shapeHash)) {
+            assignLabel(*label, messageTemplate(message));
+        }
+    }
+
+    void LogSketches::addRange(const LogStore& store, size_t begin, size_t end) {
+        auto sourceIds = store.sourceIds();
+        end = std::min(end, store.size());
+        for (size_t i = begin; i < end; ++i) {
+            add(sourceIds[i], store.messageAt(i));
+        }
+    }
+
+    // 合并
+    void LogSketches::merge(const LogSketches& other) {
+        if (other.options_.capacity != options_.capacity) {
+            throw std::invalid_argument("无法合并精度设置不同的近似统计");
+        }
+        distinctMessages_.merge(other.distinctMessages_);
+        distinctTemplates_.merge(other.distinctTemplates_);
+        distinctSources_.merge(other.distinctSources_);
+        sourceFrequency_.merge(other.sourceFrequency_);
+        templateFrequency_.merge(other.templateFrequency_);
+        topSources_.merge(other.topSources_);
+        topTemplates_.merge(other.topTemplates_);
+        entries_ += other.entries_;
+    }
+
+    // 消息模板
+    std::string LogSketches::messageTemplate(std::string_view message) {
+        std::string result;
+        result.reserve(message.size());
+        for (size_t i = 0; i < message.size(); ++i) {
+            if (isDigit(message[i])) {
+                while (i + 1 < message.size() && isDigit(message[i + 1])) {
+                    ++i;
+                }
+                result += '#';
+            } else {
+                result += message[i];
+            }
+        }
+        return result;
+    }
+
+    // 两个上界取较小值；Space-Saving 的 count - error 是下界
+    std::vector<LogSketches::HeavyHitter> LogSketches::heavyHitters(const SpaceSaving& candidates,
+                                                                    const CountMinSketch& frequency, size_t count) {
+        std::vector<HeavyHitter> result;
+        for (const auto& counter : candidates.top(candidates.size())) {
+            std::uint64_t estimate = std::min(counter.count, frequency.estimate(counter.hash));
+            result.push_back({counter.label, estimate, std::min(estimate, counter.count - counter.error)});
+        }
+        std::stable_sort(result.begin(), result.end(), [](const HeavyHitter& a, const HeavyHitter& b) {
+            return a.estimate > b.estimate;
+        });
+        if (result.size() > count) {
+            result.resize(count);
+        }
+        return result;
+    }
+
+    std::vector<LogSketches::HeavyHitter> LogSketches::topSources(size_t count) const {
+        return heavyHitters(topSources_, sourceFrequency_, count);
+    }
+
+    std::vector<LogSketches::HeavyHitter> LogSketches::topTemplates(size_t count) const {
+        return heavyHitters(topTemplates_, templateFrequency_, count);
+    }
+
+    // 频次上界与真实值之差的上限：Space-Saving 保证不超过 总数 / 容量，Count-Min 以给定概率不超过 ε × 总数
+    std::uint64_t LogSketches::frequencyErrorBound() const {
+        double fraction = std::min(options_.cmsError, 1.0 / static_cast<double>(options_.capacity));
+        return static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(entries_)));
+    }
+
+    size_t LogSketches::memoryBytes() const {
+        return distinctMessages_.memoryBytes() + distinctTemplates_.memoryBytes() + distinctSources_.memoryBytes() +
+               sourceFrequency_.memoryBytes() + templateFrequency_.memoryBytes() +
+               topSources_.memoryBytes() + topTemplates_.memoryBytes();
+    }
+
+} // namespace LogAnalyzer
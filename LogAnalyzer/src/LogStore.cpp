@@ -0,0 +1,463 @@
+/*
+ * LogStore.cpp
+ * LogStore 类的实现
+ */
+
+#include "LogStore.h"
+#include "FileSignature.h"
+#include "LevelKernels.h"
+#include "MappedFile.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        inline std::int64_t toNanos(const std::chrono::system_clock::time_point& tp) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+        }
+
+        // 空存储的消息偏移列：只有一个 0
+        const std::uint64_t EMPTY_OFFSETS[1] = {0};
+
+        // ===== 快照文件格式 =====
+        // 文件头之后依次是来源字典、时间戳列、级别列、来源列、消息偏移列和消息内容，
+        // 每一段都从 SECTION_ALIGNMENT 的整数倍处开始，映射后可以直接按列类型访问。
+        // 来源字典的每一项为 u32 长度 + 内容，第 i 项是保存时编号为 i 的来源。
+
+        const char SNAPSHOT_MAGIC[8] = {'L', 'A', 'S', 'N', 'A', 'P', '0', '1'};
+        constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+        constexpr std::uint64_t SECTION_ALIGNMENT = 64;
+        constexpr std::uint32_t SNAPSHOT_SORTED = 1;
+
+        struct SnapshotHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t flags;
+            std::uint64_t entryCount;
+            std::uint64_t sourceCount;
+            std::uint64_t sourceOffset;
+            std::uint64_t sourceBytes;
+            std::uint64_t timestampOffset;
+            std::uint64_t levelOffset;
+            std::uint64_t sourceIdOffset;
+            std::uint64_t messageOffsetOffset;
+            std::uint64_t messageDataOffset;
+            std::uint64_t messageBytes;
+        };
+        static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "快照文件头必须可以按字节读写");
+
+        std::uint64_t alignSection(std::uint64_t offset) {
+            return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        }
+
+        // 写入零字节直到 position 到达 target
+        void padTo(std::ostream& out, std::uint64_t& position, std::uint64_t target) {
+            static const char zeros[SECTION_ALIGNMENT] = {};
+            out.write(zeros, static_cast<std::streamsize>(target - position));
+            position = target;
+        }
+
+        void writeSection(std::ostream& out, std::uint64_t& position, std::uint64_t offset,
+                          const void* data, std::uint64_t bytes) {
+            padTo(out, position, offset);
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            position += bytes;
+        }
+
+        // 段 [offset, offset + count * width) 是否完整落在文件内
+        bool sectionFits(std::uint64_t offset, std::uint64_t count, std::uint64_t width, std::uint64_t fileSize) {
+            return offset % SECTION_ALIGNMENT == 0 && offset <= fileSize &&
+                   count <= (fileSize - offset) / width;
+        }
+
+        [[noreturn]] void corruptSnapshot(const std::string& filename) {
+            throw std::runtime_error("快照文件已损坏: " + filename);
+        }
+
+    } // namespace
+
+    // 构造函数
+    LogStore::LogStore()
+        : timestampColumn_(nullptr), levelColumn_(nullptr), sourceIdColumn_(nullptr),
+          offsetColumn_(EMPTY_OFFSETS), messageColumn_(nullptr), size_(0), sorted_(true) {
+    }
+
+    LogStore::LogStore(const LogStore& other)
+        : timestamps_(other.timestamps_), levels_(other.levels_), sourceIds_(other.sourceIds_),
+          messageOffsets_(other.messageOffsets_), messageData_(other.messageData_), snapshot_(other.snapshot_),
+          timestampColumn_(other.timestampColumn_), levelColumn_(other.levelColumn_),
+          sourceIdColumn_(other.sourceIdColumn_), offsetColumn_(other.offsetColumn_),
+          messageColumn_(other.messageColumn_), size_(other.size_), sorted_(other.sorted_) {
+        bindColumns();
+    }
+
+    LogStore::LogStore(LogStore&& other) noexcept
+        : timestamps_(std::move(other.timestamps_)), levels_(std::move(other.levels_)),
+          sourceIds_(std::move(other.sourceIds_)), messageOffsets_(std::move(other.messageOffsets_)),
+          messageData_(std::move(other.messageData_)), snapshot_(std::move(other.snapshot_)),
+          timestampColumn_(other.timestampColumn_), levelColumn_(other.levelColumn_),
+          sourceIdColumn_(other.sourceIdColumn_), offsetColumn_(other.offsetColumn_),
+          messageColumn_(other.messageColumn_), size_(other.size_), sorted_(other.sorted_) {
+        bindColumns();
+        other.clear();
+    }
+
+    LogStore& LogStore::operator=(const LogStore& other) {
+        if (this != &other) {
+            LogStore copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    LogStore& LogStore::operator=(LogStore&& other) noexcept {
+        if (this != &other) {
+            timestamps_ = std::move(other.timestamps_);
+            levels_ = std::move(other.levels_);
+            sourceIds_ = std::move(other.sourceIds_);
+            messageOffsets_ = std::move(other.messageOffsets_);
+            messageData_ = std::move(other.messageData_);
+            snapshot_ = std::move(other.snapshot_);
+            timestampColumn_ = other.timestampColumn_;
+            levelColumn_ = other.levelColumn_;
+            sourceIdColumn_ = other.sourceIdColumn_;
+            offsetColumn_ = other.offsetColumn_;
+            messageColumn_ = other.messageColumn_;
+            size_ = other.size_;
+            sorted_ = other.sorted_;
+            bindColumns();
+            other.clear();
+        }
+        return *this;
+    }
+
+    // 列指针指向自有数据
+    void LogStore::bindColumns() {
+        if (snapshot_) {
+            // 快照中只有重映射后的来源列是自有的
+            if (!sourceIds_.empty()) {
+                sourceIdColumn_ = sourceIds_.data();
+            }
+            return;
+        }
+        timestampColumn_ = timestamps_.data();
+        levelColumn_ = levels_.data();
+        sourceIdColumn_ = sourceIds_.data();
+        offsetColumn_ = messageOffsets_.empty() ? EMPTY_OFFSETS : messageOffsets_.data();
+        messageColumn_ = messageData_.data();
+        size_ = levels_.size();
+    }
+
+    // 拷贝快照数据
+    void LogStore::detachSnapshot() {
+        if (!snapshot_) {
+            return;
+        }
+        timestamps_.assign(timestampColumn_, timestampColumn_ + size_);
+        levels_.assign(levelColumn_, levelColumn_ + size_);
+        if (sourceIds_.empty()) {
+            sourceIds_.assign(sourceIdColumn_, sourceIdColumn_ + size_);
+        }
+        messageOffsets_.assign(offsetColumn_, offsetColumn_ + size_ + 1);
+        messageData_.assign(messageColumn_, static_cast<size_t>(offsetColumn_[size_]));
+        snapshot_.reset();
+        bindColumns();
+    }
+
+    // 由日志条目构造
+    LogStore LogStore::fromEntries(const std::vector<LogEntry>& entries) {
+        size_t messageBytes = 0;
+        for (const auto& entry : entries) {
+            messageBytes += entry.getMessage().size();
+        }
+
+        LogStore store;
+        store.reserve(entries.size(), messageBytes);
+        for (const auto& entry : entries) {
+            store.append(entry);
+        }
+        return store;
+    }
+
+    // 预留容量
+    void LogStore::reserve(size_t entries, size_t messageBytes) {
+        detachSnapshot();
+        timestamps_.reserve(entries);
+        levels_.reserve(entries);
+        sourceIds_.reserve(entries);
+        messageOffsets_.reserve(entries + 1);
+        messageData_.reserve(messageBytes);
+        bindColumns();
+    }
+
+    // 追加一条日志
+    void LogStore::append(const LogEntry& entry) {
+        detachSnapshot();
+        std::int64_t nanos = toNanos(entry.getTimestamp());
+        if (!timestamps_.empty() && nanos < timestamps_.back()) {
+            sorted_ = false;
+        }
+        if (messageOffsets_.empty()) {
+            messageOffsets_.push_back(0);
+        }
+
+        timestamps_.push_back(nanos);
+        levels_.push_back(static_cast<std::uint8_t>(entry.getLevel()));
+        sourceIds_.push_back(entry.getSourceId());
+
+        std::string_view message = entry.getMessage();
+        messageData_.append(message.data(), message.size());
+        messageOffsets_.push_back(messageData_.size());
+        bindColumns();
+    }
+
+    // 清空
+    void LogStore::clear() {
+        timestamps_.clear();
+        levels_.clear();
+        sourceIds_.clear();
+        messageOffsets_.clear();
+        messageData_.clear();
+        snapshot_.reset();
+        sorted_ = true;
+        bindColumns();
+    }
+
+    // 单行访问器
+    LogStore::TimePoint LogStore::timestampAt(size_t index) const {
+        return TimePoint(std::chrono::duration_cast<TimePoint::duration>(
+            std::chrono::nanoseconds(timestampColumn_[index])));
+    }
+
+    std::string_view LogStore::messageAt(size_t index) const {
+        // 快照载入时不逐行校验偏移列，在这里检查：逆序或越界的偏移（损坏的快照）按空消息处理
+        std::uint64_t begin = offsetColumn_[index];
+        std::uint64_t end = offsetColumn_[index + 1];
+        if (begin > end || end > offsetColumn_[size_]) {
+            return std::string_view();
+        }
+        return std::string_view(messageColumn_ + begin, static_cast<size_t>(end - begin));
+    }
+
+    // 统计各级别数量（SIMD 直方图内核）
+    std::array<size_t, LOG_LEVEL_COUNT> LogStore::countByLevel() const {
+        return levelHistogram(levelColumn_, size_);
+    }
+
+    // 按级别选行（SIMD 位图内核）
+    std::vector<size_t> LogStore::selectByLevel(LogLevel level) const {
+        return bitmapToIndices(levelSelectBitmap(levelColumn_, size_, level), size_);
+    }
+
+    // 按时间范围选行
+    std::vector<size_t> LogStore::selectTimeRange(const TimePoint& begin, const TimePoint& end) const {
+        std::vector<size_t> indices;
+        const std::int64_t lo = toNanos(begin);
+        const std::int64_t hi = toNanos(end);
+        const std::int64_t* first = timestampColumn_;
+        const std::int64_t* last = timestampColumn_ + size_;
+
+        if (sorted_) {
+            auto from = std::lower_bound(first, last, lo);
+            auto to = std::lower_bound(from, last, hi);
+            indices.reserve(static_cast<size_t>(to - from));
+            for (auto it = from; it != to; ++it) {
+                indices.push_back(static_cast<size_t>(it - first));
+            }
+            return indices;
+        }
+
+        for (size_t i = 0; i < size_; ++i) {
+            if (timestampColumn_[i] >= lo && timestampColumn_[i] < hi) {
+                indices.push_back(i);
+            }
+        }
+        return indices;
+    }
+
+    // 按来源分组计数
+    std::unordered_map<std::uint32_t, size_t> LogStore::countBySource() const {
+        std::unordered_map<std::uint32_t, size_t> counts;
+        for (size_t i = 0; i < size_; ++i) {
+            counts[sourceIdColumn_[i]]++;
+        }
+        return counts;
+    }
+
+    // 按行号抽取
+    LogStore LogStore::select(const std::vector<size_t>& indices) const {
+        size_t messageBytes = 0;
+        for (size_t i : indices) {
+            messageBytes += messageAt(i).size();
+        }
+
+        LogStore result;
+        result.reserve(indices.size(), messageBytes);
+        result.messageOffsets_.push_back(0);
+        for (size_t i : indices) {
+            if (!result.timestamps_.empty() && timestampColumn_[i] < result.timestamps_.back()) {
+                result.sorted_ = false;
+            }
+            result.timestamps_.push_back(timestampColumn_[i]);
+            result.levels_.push_back(levelColumn_[i]);
+            result.sourceIds_.push_back(sourceIdColumn_[i]);
+            std::string_view message = messageAt(i);
+            result.messageData_.append(message.data(), message.size());
+            result.messageOffsets_.push_back(result.messageData_.size());
+        }
+        result.bindColumns();
+        return result;
+    }
+
+    // 保存快照
+    void LogStore::saveSnapshot(const std::string& filename) const {
+        // 来源字典保存整个 SourceTable，来源列中的编号无需改写
+        const size_t sourceCount = SourceTable::size();
+        std::uint64_t sourceBytes = 0;
+        for (size_t id = 0; id < sourceCount; ++id) {
+            sourceBytes += sizeof(std::uint32_t) + SourceTable::name(static_cast<std::uint32_t>(id)).size();
+        }
+
+        SnapshotHeader header = {};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        header.version = SNAPSHOT_VERSION;
+        header.flags = sorted_ ? SNAPSHOT_SORTED : 0;
+        header.entryCount = size_;
+        header.sourceCount = sourceCount;
+        header.sourceOffset = alignSection(sizeof(SnapshotHeader));
+        header.sourceBytes = sourceBytes;
+        header.timestampOffset = alignSection(header.sourceOffset + sourceBytes);
+        header.levelOffset = alignSection(header.timestampOffset + size_ * sizeof(std::int64_t));
+        header.sourceIdOffset = alignSection(header.levelOffset + size_ * sizeof(std::uint8_t));
+        header.messageOffsetOffset = alignSection(header.sourceIdOffset + size_ * sizeof(std::uint32_t));
+        header.messageDataOffset = alignSection(header.messageOffsetOffset + (size_ + 1) * sizeof(std::uint64_t));
+        header.messageBytes = offsetColumn_[size_];
+
+        const std::string tempPath = filename + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                throw std::runtime_error("无法写入快照文件: " + filename);
+            }
+
+            writeBinary(out, header);
+            std::uint64_t position = sizeof(SnapshotHeader);
+            padTo(out, position, header.sourceOffset);
+            for (size_t id = 0; id < sourceCount; ++id) {
+                const std::string& name = SourceTable::name(static_cast<std::uint32_t>(id));
+                writeBinary(out, static_cast<std::uint32_t>(name.size()));
+                out.write(name.data(), static_cast<std::streamsize>(name.size()));
+                position += sizeof(std::uint32_t) + name.size();
+            }
+            writeSection(out, position, header.timestampOffset, timestampColumn_, size_ * sizeof(std::int64_t));
+            writeSection(out, position, header.levelOffset, levelColumn_, size_ * sizeof(std::uint8_t));
+            writeSection(out, position, header.sourceIdOffset, sourceIdColumn_, size_ * sizeof(std::uint32_t));
+            writeSection(out, position, header.messageOffsetOffset, offsetColumn_,
+                         (size_ + 1) * sizeof(std::uint64_t));
+            writeSection(out, position, header.messageDataOffset, messageColumn_, header.messageBytes);
+
+            if (!out) {
+                std::remove(tempPath.c_str());
+                throw std::runtime_error("无法写入快照文件: " + filename);
+            }
+        }
+        if (std::rename(tempPath.c_str(), filename.c_str()) != 0) {
+            std::remove(tempPath.c_str());
+            throw std::runtime_error("无法写入快照文件: " + filename);
+        }
+    }
+
+    // 载入快照
+    LogStore LogStore::loadSnapshot(const std::string& filename) {
+        auto mapped = std::make_shared<MappedFile>();
+        if (!mapped->open(filename)) {
+            throw std::runtime_error("无法打开快照文件: " + filename);
+        }
+
+        SnapshotHeader header;
+        const std::uint64_t fileSize = mapped->size();
+        if (fileSize < sizeof(header)) {
+            throw std::runtime_error("不是有效的快照文件: " + filename);
+        }
+        std::memcpy(&header, mapped->data(), sizeof(header));
+        if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+            throw std::runtime_error("不是有效的快照文件: " + filename);
+        }
+        if (header.version != SNAPSHOT_VERSION) {
+            throw std::runtime_error("快照文件版本不受支持: " + filename);
+        }
+
+        const std::uint64_t count = header.entryCount;
+        if (count >= fileSize ||
+            !sectionFits(header.sourceOffset, header.sourceBytes, 1, fileSize) ||
+            !sectionFits(header.timestampOffset, count, sizeof(std::int64_t), fileSize) ||
+            !sectionFits(header.levelOffset, count, sizeof(std::uint8_t), fileSize) ||
+            !sectionFits(header.sourceIdOffset, count, sizeof(std::uint32_t), fileSize) ||
+            !sectionFits(header.messageOffsetOffset, count + 1, sizeof(std::uint64_t), fileSize) ||
+            !sectionFits(header.messageDataOffset, header.messageBytes, 1, fileSize)) {
+            corruptSnapshot(filename);
+        }
+
+        const char* base = mapped->data();
+        const auto* sourceIds = reinterpret_cast<const std::uint32_t*>(base + header.sourceIdOffset);
+        const auto* levels = reinterpret_cast<const std::uint8_t*>(base + header.levelOffset);
+        const auto* offsets = reinterpret_cast<const std::uint64_t*>(base + header.messageOffsetOffset);
+
+        // 来源字典登记到当前进程；通常进程中还没有其他来源，编号与保存时一致
+        std::vector<std::uint32_t> idMap;
+        idMap.reserve(static_cast<size_t>(std::min<std::uint64_t>(header.sourceCount, header.sourceBytes)));
+        bool identity = true;
+        const char* cursor = base + header.sourceOffset;
+        const char* dictionaryEnd = cursor + header.sourceBytes;
+        for (std::uint64_t id = 0; id < header.sourceCount; ++id) {
+            std::uint32_t length = 0;
+            if (static_cast<size_t>(dictionaryEnd - cursor) < sizeof(length)) {
+                corruptSnapshot(filename);
+            }
+            std::memcpy(&length, cursor, sizeof(length));
+            cursor += sizeof(length);
+            if (static_cast<size_t>(dictionaryEnd - cursor) < length) {
+                corruptSnapshot(filename);
+            }
+            std::uint32_t localId = SourceTable::intern(std::string_view(cursor, length));
+            identity = identity && localId == id;
+            idMap.push_back(localId);
+            cursor += length;
+        }
+
+        // 载入只做与行数无关的校验，不逐行扫描各列：
+        //   - 偏移列的首尾在这里校验，单行偏移由 messageAt 在访问时检查；
+        //   - 级别列的每个使用方都会跳过超出 LOG_LEVEL_COUNT 的值；
+        //   - 来源编号只用于查 SourceTable::name，无效编号得到空字符串；重映射时超出字典的编号记为 0
+        if (offsets[0] != 0 || offsets[count] != header.messageBytes) {
+            corruptSnapshot(filename);
+        }
+
+        LogStore store;
+        store.timestampColumn_ = reinterpret_cast<const std::int64_t*>(base + header.timestampOffset);
+        store.levelColumn_ = levels;
+        store.sourceIdColumn_ = sourceIds;
+        store.offsetColumn_ = offsets;
+        store.messageColumn_ = base + header.messageDataOffset;
+        store.size_ = static_cast<size_t>(count);
+        store.sorted_ = (header.flags & SNAPSHOT_SORTED) != 0;
+        store.snapshot_ = std::move(mapped);
+
+        if (!identity) {
+            store.sourceIds_.resize(store.size_);
+            for (size_t i = 0; i < store.size_; ++i) {
+                store.sourceIds_[i] = sourceIds[i] < idMap.size() ? idMap[sourceIds[i]] : 0;
+            }
+        }
+        store.bindColumns();
+        return store;
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,181 @@
+/*
+ * LogWriter.cpp
+ * LogWriter 类的实现
+ */
+
+#include "LogWriter.h"
+#include "LogStore.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace LogAnalyzer {
+
+    // 构造函数
+    LogWriter::LogWriter(int fd, size_t bufferSize)
+        : fd_(fd), bufferSize_(bufferSize), allocated_(1), writing_(false), stop_(false), error_(0),
+          bytesWritten_(0), cachedSecond_(std::numeric_limits<std::int64_t>::min()), cachedTime_{},
+          cachedTimeLength_(0) {
+        if (bufferSize == 0) {
+            throw std::invalid_argument("输出缓冲区大小必须为正数");
+        }
+        current_.data.reset(new char[bufferSize]);
+        thread_ = std::thread(&LogWriter::run, this);
+    }
+
+    // 析构函数：剩余内容交给写线程，等它写完退出
+    LogWriter::~LogWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (current_.size > 0) {
+                full_.push_back(std::move(current_));
+            }
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    // 写线程：按提交顺序逐块写出；失败后丢弃后续内容，避免渲染方一直等待
+    void LogWriter::run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this]() { return stop_ || !full_.empty(); });
+            if (full_.empty()) {
+                break;
+            }
+            Buffer buffer = std::move(full_.front());
+            full_.pop_front();
+            writing_ = true;
+            const bool skip = error_ != 0;
+            lock.unlock();
+
+            int error = skip ? 0 : writeAll(buffer.data.get(), buffer.size);
+
+            lock.lock();
+            if (error != 0) {
+                error_ = error;
+            } else if (!skip) {
+                bytesWritten_ += buffer.size;
+            }
+            buffer.size = 0;
+            free_.push_back(std::move(buffer));
+            writing_ = false;
+            cv_.notify_all();
+        }
+    }
+
+    int LogWriter::writeAll(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t written = ::write(fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return errno;
+            }
+            if (written == 0) {
+                return EIO;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return 0;
+    }
+
+    // 提交当前缓冲区；缓冲区未达到上限时新分配，否则等写线程归还一块
+    void LogWriter::submit() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        full_.push_back(std::move(current_));
+        cv_.notify_all();
+        if (free_.empty() && allocated_ < BUFFER_COUNT) {
+            ++allocated_;
+            lock.unlock();
+            current_.data.reset(new char[bufferSize_]);
+        } else {
+            cv_.wait(lock, [this]() { return !free_.empty(); });
+            current_ = std::move(free_.back());
+            free_.pop_back();
+        }
+        current_.size = 0;
+    }
+
+    void LogWriter::appendSlow(std::string_view text) {
+        while (!text.empty()) {
+            if (current_.size == bufferSize_) {
+                submit();
+            }
+            size_t chunk = std::min(text.size(), bufferSize_ - current_.size);
+            std::char_traits<char>::copy(current_.data.get() + current_.size, text.data(), chunk);
+            current_.size += chunk;
+            text.remove_prefix(chunk);
+        }
+    }
+
+    // 与 LogEntry::getFormattedTimestamp 相同：秒数向零取整后按本地时间格式化
+    std::string_view LogWriter::formattedTime(std::int64_t timestampNanos) {
+        const std::int64_t second = timestampNanos / 1000000000;
+        if (second != cachedSecond_) {
+            cachedSecond_ = second;
+            std::time_t time = static_cast<std::time_t>(second);
+            std::tm local;
+            cachedTimeLength_ = ::localtime_r(&time, &local)
+                ? std::strftime(cachedTime_, sizeof(cachedTime_), "%Y-%m-%d %H:%M:%S", &local)
+                : 0;
+        }
+        return std::string_view(cachedTime_, cachedTimeLength_);
+    }
+
+    // 写入一条日志
+    void LogWriter::writeEntry(std::int64_t timestampNanos, LogLevel level, std::uint32_t sourceId,
+                               std::string_view message) {
+        append("[");
+        append(formattedTime(timestampNanos));
+        append("] [");
+        append(logLevelName(level));
+        append("] [");
+        append(SourceTable::name(sourceId));
+        append("] ");
+        append(message);
+        append("\n");
+    }
+
+    void LogWriter::writeEntry(const LogEntry& entry) {
+        writeEntry(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       entry.getTimestamp().time_since_epoch()).count(),
+                   entry.getLevel(), entry.getSourceId(), entry.getMessage());
+    }
+
+    void LogWriter::writeRange(const LogStore& store, size_t begin, size_t end) {
+        auto timestamps = store.timestamps();
+        auto levels = store.levels();
+        auto sourceIds = store.sourceIds();
+        end = std::min(end, store.size());
+        for (size_t i = begin; i < end; ++i) {
+            writeEntry(timestamps[i], static_cast<LogLevel>(levels[i]), sourceIds[i], store.messageAt(i));
+        }
+    }
+
+    // 写出全部内容并等待完成
+    void LogWriter::flush() {
+        if (current_.size > 0) {
+            submit();
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return full_.empty() && !writing_; });
+        if (error_ != 0) {
+            throw std::runtime_error(std::string("写入输出失败: ") + std::strerror(error_));
+        }
+    }
+
+    std::uint64_t LogWriter::bytesWritten() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bytesWritten_;
+    }
+
+} // namespace LogAnalyzer
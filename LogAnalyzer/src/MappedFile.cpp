@@ -0,0 +1,143 @@
+/*
+ * MappedFile.cpp
+ * MappedFile 类的实现
+ */
+
+#include "MappedFile.h"
+#include <utility>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace LogAnalyzer {
+
+    // 构造函数
+    MappedFile::MappedFile()
+        : data_(nullptr), size_(0), mapBase_(nullptr), mapLength_(0), open_(false) {
+    }
+
+    // 移动构造
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          mapBase_(std::exchange(other.mapBase_, nullptr)),
+          mapLength_(std::exchange(other.mapLength_, 0)),
+          open_(std::exchange(other.open_, false)) {
+    }
+
+    // 移动赋值
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mapBase_ = std::exchange(other.mapBase_, nullptr);
+            mapLength_ = std::exchange(other.mapLength_, 0);
+            open_ = std::exchange(other.open_, false);
+        }
+        return *this;
+    }
+
+    // 析构函数
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    // 映射文件
+    bool MappedFile::open(const std::string& filename, Access access) {
+        return openRange(filename, 0, static_cast<size_t>(-1), access);
+    }
+
+    // 映射文件中的一段区间
+    bool MappedFile::openRange(const std::string& filename, size_t offset, size_t length, Access access) {
+        close();
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        // 只映射普通文件，管道和设备交给流式读取
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+
+        size_t fileSize = static_cast<size_t>(st.st_size);
+        offset = std::min(offset, fileSize);
+        size_ = std::min(length, fileSize - offset);
+        if (size_ > 0) {
+            // mmap 的偏移必须按页对齐
+            size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            size_t alignedOffset = offset / pageSize * pageSize;
+            mapLength_ = size_ + (offset - alignedOffset);
+            void* addr = ::mmap(nullptr, mapLength_, PROT_READ, MAP_PRIVATE, fd,
+                                static_cast<off_t>(alignedOffset));
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                size_ = 0;
+                mapLength_ = 0;
+                return false;
+            }
+            mapBase_ = addr;
+            data_ = static_cast<const char*>(addr) + (offset - alignedOffset);
+
+            if (access == Access::SEQUENTIAL) {
+                // 告诉内核按顺序读取，加大预读并尽早回收已读页
+                ::madvise(addr, mapLength_, MADV_SEQUENTIAL);
+                ::madvise(addr, mapLength_, MADV_WILLNEED);
+            } else {
+                // 只访问少量页：关闭预读，避免为整个大文件安排 I/O
+                ::madvise(addr, mapLength_, MADV_RANDOM);
+            }
+        }
+
+        // 映射建立后即可关闭文件描述符
+        ::close(fd);
+        open_ = true;
+        return true;
+    }
+
+    // 对区间设置顺序访问提示并预读，区间向外扩展到页边界
+    void MappedFile::prefetch(size_t offset, size_t length) {
+        if (mapBase_ == nullptr || offset >= size_) {
+            return;
+        }
+        size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t base = static_cast<size_t>(data_ - static_cast<const char*>(mapBase_));
+        size_t begin = (base + offset) / pageSize * pageSize;
+        size_t end = base + offset + std::min(length, size_ - offset);
+        char* start = static_cast<char*>(mapBase_) + begin;
+        ::madvise(start, end - begin, MADV_SEQUENTIAL);
+        ::madvise(start, end - begin, MADV_WILLNEED);
+    }
+
+    // 只丢弃完整落在 offset 之前的页
+    void MappedFile::discardBefore(size_t offset) {
+        if (mapBase_ == nullptr) {
+            return;
+        }
+        size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t end = static_cast<size_t>(data_ - static_cast<const char*>(mapBase_)) + std::min(offset, size_);
+        end = end / pageSize * pageSize;
+        if (end > 0) {
+            ::madvise(mapBase_, end, MADV_DONTNEED);
+        }
+    }
+
+    // 解除映射
+    void MappedFile::close() {
+        if (mapBase_ != nullptr) {
+            ::munmap(mapBase_, mapLength_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        mapBase_ = nullptr;
+        mapLength_ = 0;
+        open_ = false;
+    }
+
+} // namespace LogAnalyzer
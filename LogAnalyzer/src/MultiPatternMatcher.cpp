@@ -0,0 +1,312 @@
+/*
+ * MultiPatternMatcher.cpp
+ * MultiPatternMatcher 类的实现
+ */
+
+#include "MultiPatternMatcher.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LOGANALYZER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        enum class PrefilterLevel { SCALAR, SSE2, AVX2 };
+
+        // SSE2 预过滤最多同时比较的首字节数
+        constexpr size_t SSE2_MAX_FIRST_BYTES = 4;
+
+        PrefilterLevel selectPrefilter() {
+            const char* forced = std::getenv("LOGANALYZER_SIMD");
+            std::string wanted = forced ? forced : "";
+
+#ifdef LOGANALYZER_X86
+            __builtin_cpu_init();
+            bool hasAvx2 = __builtin_cpu_supports("avx2");
+            if (hasAvx2 && (wanted.empty() || wanted == "avx2")) {
+                return PrefilterLevel::AVX2;
+            }
+            if (wanted.empty() || wanted == "avx2" || wanted == "sse2") {
+                return PrefilterLevel::SSE2;
+            }
+#endif
+            return PrefilterLevel::SCALAR;
+        }
+
+        PrefilterLevel prefilterLevel() {
+            static const PrefilterLevel level = selectPrefilter();
+            return level;
+        }
+
+        // ===== 标量实现（也用于处理 SIMD 剩余的尾部） =====
+
+        size_t skipScalar(const char* data, size_t size, size_t from, const std::array<bool, 256>& table) {
+            for (size_t i = from; i < size; ++i) {
+                if (table[static_cast<unsigned char>(data[i])]) {
+                    return i;
+                }
+            }
+            return size;
+        }
+
+#ifdef LOGANALYZER_X86
+
+        // ===== SSE2 实现：与少量首字节逐一比较 =====
+
+        size_t skipSse2(const char* data, size_t size, size_t from,
+                        const std::vector<unsigned char>& firstBytes, const std::array<bool, 256>& table) {
+            __m128i needles[SSE2_MAX_FIRST_BYTES];
+            for (size_t k = 0; k < firstBytes.size(); ++k) {
+                needles[k] = _mm_set1_epi8(static_cast<char>(firstBytes[k]));
+            }
+
+            size_t i = from;
+            for (; i + 16 <= size; i += 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i hit = _mm_cmpeq_epi8(v, needles[0]);
+                for (size_t k = 1; k < firstBytes.size(); ++k) {
+                    hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, needles[k]));
+                }
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+                if (mask != 0) {
+                    return i + static_cast<size_t>(__builtin_ctz(mask));
+                }
+            }
+            return skipScalar(data, size, i, table);
+        }
+
+        // ===== AVX2 实现：nibble 查表判断字节是否属于首字节集合（仅 ASCII） =====
+        // 字节 b 是候选当且仅当 low[b & 0xF] & high[b >> 4] 非零
+
+        __attribute__((target("avx2")))
+        size_t skipAvx2(const char* data, size_t size, size_t from,
+                        const std::uint8_t* low, const std::uint8_t* high, const std::array<bool, 256>& table) {
+            const __m256i lowTable = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(low)));
+            const __m256i highTable = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(high)));
+            const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+            const __m256i zero = _mm256_setzero_si256();
+
+            size_t i = from;
+            for (; i + 32 <= size; i += 32) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i lo = _mm256_and_si256(v, nibbleMask);
+                __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibbleMask);
+                __m256i bits = _mm256_and_si256(_mm256_shuffle_epi8(lowTable, lo),
+                                                _mm256_shuffle_epi8(highTable, hi));
+                std::uint32_t mask = ~static_cast<std::uint32_t>(
+                    _mm256_movemask_epi8(_mm256_cmpeq_epi8(bits, zero)));
+                if (mask != 0) {
+                    return i + static_cast<size_t>(__builtin_ctz(mask));
+                }
+            }
+            return skipScalar(data, size, i, table);
+        }
+
+#endif
+
+    } // namespace
+
+    // 构造函数
+    MultiPatternMatcher::MultiPatternMatcher(const std::vector<std::string>& patterns)
+        : classCount_(1), asciiFirstBytes_(true) {
+        std::unordered_set<std::string> seen;
+        for (const auto& pattern : patterns) {
+            if (!pattern.empty() && seen.insert(pattern).second) {
+                patterns_.push_back(pattern);
+            }
+        }
+        build();
+    }
+
+    // 从文件读取签名
+    MultiPatternMatcher MultiPatternMatcher::fromFile(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("无法打开签名文件: " + filename);
+        }
+
+        std::vector<std::string> patterns;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty() && line[0] != '#') {
+                patterns.push_back(line);
+            }
+        }
+        return MultiPatternMatcher(patterns);
+    }
+
+    // 构建自动机
+    void MultiPatternMatcher::build() {
+        // 字节等价类：签名中出现过的每个字节一个类，其余字节共用类 0
+        byteClass_.fill(0);
+        for (const auto& pattern : patterns_) {
+            for (unsigned char c : pattern) {
+                if (byteClass_[c] == 0) {
+                    byteClass_[c] = static_cast<std::uint16_t>(classCount_++);
+                }
+            }
+        }
+
+        // 字典树
+        const size_t classes = classCount_;
+        transitions_.assign(classes, -1);
+        patternAt_.assign(1, -1);
+        for (size_t id = 0; id < patterns_.size(); ++id) {
+            size_t state = 0;
+            for (unsigned char c : patterns_[id]) {
+                std::int32_t& next = transitions_[state * classes + byteClass_[c]];
+                if (next < 0) {
+                    next = static_cast<std::int32_t>(patternAt_.size());
+                    transitions_.resize(transitions_.size() + classes, -1);
+                    patternAt_.push_back(-1);
+                }
+                state = static_cast<size_t>(transitions_[state * classes + byteClass_[c]]);
+            }
+            patternAt_[state] = static_cast<std::int32_t>(id);
+        }
+
+        // 按层次遍历补全失败转移，得到确定性自动机
+        const size_t states = patternAt_.size();
+        std::vector<std::int32_t> fail(states, 0);
+        outputLink_.assign(states, -1);
+        std::deque<size_t> queue;
+        for (size_t c = 0; c < classes; ++c) {
+            std::int32_t& next = transitions_[c];
+            if (next < 0) {
+                next = 0;
+            } else {
+                queue.push_back(static_cast<size_t>(next));
+            }
+        }
+        while (!queue.empty()) {
+            size_t state = queue.front();
+            queue.pop_front();
+            size_t failState = static_cast<size_t>(fail[state]);
+            for (size_t c = 0; c < classes; ++c) {
+                std::int32_t& next = transitions_[state * classes + c];
+                std::int32_t fallback = transitions_[failState * classes + c];
+                if (next < 0) {
+                    next = fallback;
+                    continue;
+                }
+                fail[next] = fallback;
+                outputLink_[next] = patternAt_[fallback] >= 0 ? fallback : outputLink_[fallback];
+                queue.push_back(static_cast<size_t>(next));
+            }
+        }
+
+        // 首字节集合与 nibble 查表
+        firstByte_.fill(false);
+        nibbleLow_.fill(0);
+        nibbleHigh_.fill(0);
+        for (unsigned char high = 0; high < 8; ++high) {
+            nibbleHigh_[high] = static_cast<std::uint8_t>(1u << high);
+        }
+        for (const auto& pattern : patterns_) {
+            unsigned char c = static_cast<unsigned char>(pattern[0]);
+            if (firstByte_[c]) {
+                continue;
+            }
+            firstByte_[c] = true;
+            firstBytes_.push_back(c);
+            if (c >= 0x80) {
+                asciiFirstBytes_ = false;
+            } else {
+                nibbleLow_[c & 0x0f] |= static_cast<std::uint8_t>(1u << (c >> 4));
+            }
+        }
+    }
+
+    // 首字节预过滤
+    size_t MultiPatternMatcher::skipToCandidate(const char* data, size_t size, size_t from) const {
+        if (firstBytes_.size() == 1) {
+            const void* hit = std::memchr(data + from, firstBytes_[0], size - from);
+            return hit ? static_cast<size_t>(static_cast<const char*>(hit) - data) : size;
+        }
+
+#ifdef LOGANALYZER_X86
+        PrefilterLevel level = prefilterLevel();
+        if (level == PrefilterLevel::AVX2 && asciiFirstBytes_) {
+            return skipAvx2(data, size, from, nibbleLow_.data(), nibbleHigh_.data(), firstByte_);
+        }
+        if (level != PrefilterLevel::SCALAR && firstBytes_.size() <= SSE2_MAX_FIRST_BYTES) {
+            return skipSse2(data, size, from, firstBytes_, firstByte_);
+        }
+#endif
+        return skipScalar(data, size, from, firstByte_);
+    }
+
+    // 运行自动机
+    template <typename OnMatch>
+    void MultiPatternMatcher::run(std::string_view text, OnMatch&& onMatch) const {
+        if (patterns_.empty()) {
+            return;
+        }
+
+        const char* data = text.data();
+        const size_t size = text.size();
+        size_t state = 0;
+        size_t i = 0;
+        while (i < size) {
+            if (state == 0) {
+                // 根状态下只有首字节能推进自动机，直接跳过其余字节
+                i = skipToCandidate(data, size, i);
+                if (i >= size) {
+                    break;
+                }
+            }
+            state = static_cast<size_t>(
+                transitions_[state * classCount_ + byteClass_[static_cast<unsigned char>(data[i])]]);
+            ++i;
+
+            std::int32_t output = patternAt_[state] >= 0 ? static_cast<std::int32_t>(state) : outputLink_[state];
+            for (; output >= 0; output = outputLink_[output]) {
+                if (!onMatch(static_cast<size_t>(patternAt_[output]), i)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // 扫描文本
+    void MultiPatternMatcher::scan(std::string_view text, const MatchCallback& callback) const {
+        run(text, [&callback](size_t pattern, size_t end) {
+            callback(pattern, end);
+            return true;
+        });
+    }
+
+    // 是否出现任一签名
+    bool MultiPatternMatcher::containsAny(std::string_view text) const {
+        bool found = false;
+        run(text, [&found](size_t, size_t) {
+            found = true;
+            return false;
+        });
+        return found;
+    }
+
+    const char* MultiPatternMatcher::prefilterName() {
+        switch (prefilterLevel()) {
+            case PrefilterLevel::AVX2: return "avx2";
+            case PrefilterLevel::SSE2: return "sse2";
+            default: return "scalar";
+        }
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,234 @@
+/*
+ * PerformanceMonitor.cpp
+ * PerformanceMonitor 与 ParseSampler 类的实现
+ */
+
+#include "PerformanceMonitor.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+        std::atomic<bool> monitorEnabled(false);
+        PerformanceMonitor::Clock::time_point monitorStart;
+
+        std::array<std::atomic<std::uint64_t>, STAGE_COUNT> stageNanos{};
+        std::array<std::atomic<std::uint64_t>, STAGE_COUNT> stageBytes{};
+        std::array<std::atomic<std::uint64_t>, STAGE_COUNT> stageItems{};
+
+        // 线程忙碌时间：主线程单独累计，其余线程（各处临时创建的工作线程）合计
+        std::atomic<std::uint64_t> mainBusyNanos(0);
+        std::atomic<std::uint64_t> totalBusyNanos(0);
+        thread_local bool isMainThread = false;
+
+        std::uint64_t nanosBetween(PerformanceMonitor::Clock::time_point from, PerformanceMonitor::Clock::time_point to) {
+            auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+            return nanos > 0 ? static_cast<std::uint64_t>(nanos) : 0;
+        }
+
+        double perSecond(std::uint64_t amount, std::uint64_t nanos) {
+            return nanos > 0 ? static_cast<double>(amount) * 1e9 / static_cast<double>(nanos) : 0.0;
+        }
+
+    } // namespace
+
+    // 区间计时器
+    PerformanceMonitor::Timer::Timer(Stage stage, std::uint64_t bytes, std::uint64_t items)
+        : stage_(stage), bytes_(bytes), items_(items), active_(PerformanceMonitor::enabled()) {
+        if (active_) {
+            start_ = Clock::now();
+        }
+    }
+
+    PerformanceMonitor::Timer::~Timer() {
+        stop();
+    }
+
+    void PerformanceMonitor::Timer::stop() {
+        if (active_) {
+            std::uint64_t nanos = nanosBetween(start_, Clock::now());
+            record(stage_, nanos, bytes_, items_);
+            recordBusy(nanos);
+            active_ = false;
+        }
+    }
+
+    // 开始统计
+    void PerformanceMonitor::enable() {
+        monitorStart = Clock::now();
+        isMainThread = true;
+        monitorEnabled.store(true, std::memory_order_release);
+    }
+
+    bool PerformanceMonitor::enabled() {
+        return monitorEnabled.load(std::memory_order_relaxed);
+    }
+
+    void PerformanceMonitor::record(Stage stage, std::uint64_t nanos, std::uint64_t bytes, std::uint64_t items) {
+        size_t index = static_cast<size_t>(stage);
+        stageNanos[index].fetch_add(nanos, std::memory_order_relaxed);
+        stageBytes[index].fetch_add(bytes, std::memory_order_relaxed);
+        stageItems[index].fetch_add(items, std::memory_order_relaxed);
+    }
+
+    void PerformanceMonitor::recordBusy(std::uint64_t nanos) {
+        if (isMainThread) {
+            mainBusyNanos.fetch_add(nanos, std::memory_order_relaxed);
+        }
+        totalBusyNanos.fetch_add(nanos, std::memory_order_relaxed);
+    }
+
+    PerformanceMonitor::StageStats PerformanceMonitor::stage(Stage stage) {
+        size_t index = static_cast<size_t>(stage);
+        return StageStats{stageNanos[index].load(std::memory_order_relaxed),
+                          stageBytes[index].load(std::memory_order_relaxed),
+                          stageItems[index].load(std::memory_order_relaxed)};
+    }
+
+    std::uint64_t PerformanceMonitor::mainThreadBusy() {
+        return mainBusyNanos.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t PerformanceMonitor::totalBusy() {
+        return totalBusyNanos.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t PerformanceMonitor::elapsedNanos() {
+        return enabled() ? nanosBetween(monitorStart, Clock::now()) : 0;
+    }
+
+    // Linux 上 ru_maxrss 的单位是 KB
+    std::uint64_t PerformanceMonitor::peakRssBytes() {
+        struct rusage usage;
+        if (::getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+        return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+    }
+
+    const char* PerformanceMonitor::stageName(Stage stage, bool json) {
+        static const char* const names[STAGE_COUNT] = {
+            "读取", "切分", "解析", "时间戳换算", "排序/归并", "列式存储", "过滤", "聚合", "输出"
+        };
+        static const char* const keys[STAGE_COUNT] = {
+            "read", "split", "parse", "timestamp", "sort_merge", "store", "filter", "aggregate", "output"
+        };
+        size_t index = static_cast<size_t>(stage);
+        return index < STAGE_COUNT ? (json ? keys[index] : names[index]) : "";
+    }
+
+    // 文本报告：数值列在前，阶段名在后，避免中文宽度影响对齐
+    std::string PerformanceMonitor::textReport(std::uint64_t allocations, std::uint64_t allocatedBytes) {
+        std::uint64_t wall = elapsedNanos();
+        std::uint64_t stageTotal = 0;
+        for (size_t i = 0; i < STAGE_COUNT; ++i) {
+            stageTotal += stage(static_cast<Stage>(i)).nanos;
+        }
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2)
+            << "=== 性能报告 ===\n"
+            << "总耗时: " << wall / 1e6 << " 毫秒\n"
+            << "峰值常驻内存: " << peakRssBytes() / BYTES_PER_MB << " MB\n"
+            << "堆分配: " << allocations << " 次，" << allocatedBytes / BYTES_PER_MB << " MB\n\n"
+            << std::right << std::setw(12) << "耗时(ms)" << std::setw(10) << "占比" << std::setw(12) << "条目数"
+            << std::setw(14) << "条目/秒" << std::setw(12) << "MB/秒" << "  阶段\n";
+        for (size_t i = 0; i < STAGE_COUNT; ++i) {
+            StageStats stats = stage(static_cast<Stage>(i));
+            if (stats.nanos == 0 && stats.items == 0) {
+                continue;
+            }
+            double share = stageTotal > 0 ? static_cast<double>(stats.nanos) * 100.0 / stageTotal : 0.0;
+            oss << std::setw(10) << stats.nanos / 1e6 << std::setw(9) << share << "%" << std::setw(12) << stats.items
+                << std::setw(12) << std::setprecision(0) << perSecond(stats.items, stats.nanos)
+                << std::setw(12) << std::setprecision(2) << perSecond(stats.bytes, stats.nanos) / BYTES_PER_MB
+                << "  " << stageName(static_cast<Stage>(i)) << "\n";
+        }
+        oss << "(切分/解析/时间戳换算按每 " << ParseSampler::SAMPLE_INTERVAL
+            << " 行抽样一行的比例分摊解析循环的实际耗时；多线程阶段为各线程耗时之和；"
+            << "mmap 按需读盘，缺页时间计入切分)\n";
+
+        std::uint64_t mainBusy = mainThreadBusy();
+        std::uint64_t busy = totalBusy();
+        oss << "\n线程利用率（忙碌时间 / 总耗时）:\n"
+            << "  主线程: " << mainBusy / 1e6 << " 毫秒，"
+            << (wall > 0 ? static_cast<double>(mainBusy) * 100.0 / wall : 0.0) << "%\n"
+            << "  全部线程合计: " << busy / 1e6 << " 毫秒，平均并行度 "
+            << (wall > 0 ? static_cast<double>(busy) / wall : 0.0) << "\n";
+        return oss.str();
+    }
+
+    std::string PerformanceMonitor::jsonReport(std::uint64_t allocations, std::uint64_t allocatedBytes) {
+        std::uint64_t wall = elapsedNanos();
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3)
+            << "{\"wall_ms\":" << wall / 1e6
+            << ",\"peak_rss_bytes\":" << peakRssBytes()
+            << ",\"allocations\":" << allocations
+            << ",\"allocated_bytes\":" << allocatedBytes
+            << ",\"sample_interval\":" << ParseSampler::SAMPLE_INTERVAL
+            << ",\"stages\":[";
+        for (size_t i = 0; i < STAGE_COUNT; ++i) {
+            StageStats stats = stage(static_cast<Stage>(i));
+            oss << (i > 0 ? "," : "") << "{\"name\":\"" << stageName(static_cast<Stage>(i), true) << "\""
+                << ",\"ms\":" << stats.nanos / 1e6
+                << ",\"bytes\":" << stats.bytes
+                << ",\"items\":" << stats.items
+                << ",\"items_per_sec\":" << perSecond(stats.items, stats.nanos)
+                << ",\"bytes_per_sec\":" << perSecond(stats.bytes, stats.nanos) << "}";
+        }
+        std::uint64_t mainBusy = mainThreadBusy();
+        std::uint64_t busy = totalBusy();
+        oss << "],\"threads\":{\"main_busy_ms\":" << mainBusy / 1e6
+            << ",\"main_utilization\":" << (wall > 0 ? static_cast<double>(mainBusy) / wall : 0.0)
+            << ",\"busy_ms\":" << busy / 1e6
+            << ",\"parallelism\":" << (wall > 0 ? static_cast<double>(busy) / wall : 0.0) << "}}";
+        return oss.str();
+    }
+
+    // 解析循环的抽样计时
+    ParseSampler::ParseSampler(ParseSampler*& slot)
+        : slot_(slot), previous_(slot), active_(PerformanceMonitor::enabled()), sampling_(false), counter_(0),
+          splitNanos_(0), scanNanos_(0), timestampNanos_(0), bytes_(0), lines_(0) {
+        if (active_) {
+            start_ = Clock::now();
+            slot_ = this;
+        }
+    }
+
+    void ParseSampler::endLine(Clock::time_point splitStart, Clock::time_point parseStart, Clock::time_point parseEnd) {
+        splitNanos_ += nanosBetween(splitStart, parseStart);
+        scanNanos_ += nanosBetween(parseStart, parseEnd);
+        sampling_ = false;
+    }
+
+    // 按抽样比例分摊循环的实际耗时
+    ParseSampler::~ParseSampler() {
+        if (!active_) {
+            return;
+        }
+        slot_ = previous_;
+
+        std::uint64_t total = nanosBetween(start_, Clock::now());
+        std::uint64_t timestamp = std::min(timestampNanos_, scanNanos_);
+        std::uint64_t scan = scanNanos_ - timestamp;
+        double sampled = static_cast<double>(splitNanos_ + scanNanos_);
+        std::uint64_t splitShare = sampled > 0 ? static_cast<std::uint64_t>(total * (splitNanos_ / sampled)) : 0;
+        std::uint64_t timestampShare = sampled > 0 ? static_cast<std::uint64_t>(total * (timestamp / sampled)) : 0;
+        std::uint64_t parseShare = sampled > 0 ? static_cast<std::uint64_t>(total * (scan / sampled)) : total;
+
+        PerformanceMonitor::record(Stage::SPLIT, splitShare, bytes_, lines_);
+        PerformanceMonitor::record(Stage::PARSE, parseShare, bytes_, lines_);
+        PerformanceMonitor::record(Stage::TIMESTAMP, timestampShare, 0, lines_);
+        PerformanceMonitor::recordBusy(total);
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,518 @@
+/*
+ * ReportWriter.cpp
+ * ReportWriter 类的实现
+ */
+
+#include "ReportWriter.h"
+#include "LogAggregator.h"
+#include "LogStore.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        // HTML 页面头部与内联样式
+        constexpr const char* HTML_HEAD =
+            "<!DOCTYPE html>\n<html lang=\"zh-CN\">\n<head>\n<meta charset=\"utf-8\">\n"
+            "<title>LogAnalyzer 报告</title>\n<style>\n"
+            "body{font-family:sans-serif;margin:2em;color:#222}\n"
+            "table{border-collapse:collapse;margin:1em 0}\n"
+            "th,td{border:1px solid #ccc;padding:2px 8px;text-align:left;vertical-align:top}\n"
+            "th{background:#f0f0f0}\n"
+            "td.n{text-align:right}\n"
+            "td.m{white-space:pre-wrap;word-break:break-all}\n"
+            "tr.WARN{background:#fff8e1}\n"
+            "tr.ERROR{background:#fdecea}\n"
+            "tr.FATAL{background:#f8d7da;font-weight:bold}\n"
+            "</style>\n</head>\n<body>\n<h1>LogAnalyzer 报告</h1>\n";
+
+        /**
+         * 从 p 开始的合法 UTF-8 字符的字节数（RFC 3629：拒绝超长编码、代理项和超出 U+10FFFF 的值）
+         * @return 1 到 4；不是合法字符时返回 0
+         */
+        size_t utf8Length(const unsigned char* p, const unsigned char* end) {
+            const unsigned char c = p[0];
+            if (c < 0x80) {
+                return 1;
+            }
+            size_t length;
+            unsigned char low = 0x80, high = 0xBF;   // 第二个字节的范围
+            if (c >= 0xC2 && c <= 0xDF) {
+                length = 2;
+            } else if (c == 0xE0) {
+                length = 3;
+                low = 0xA0;
+            } else if ((c >= 0xE1 && c <= 0xEC) || c == 0xEE || c == 0xEF) {
+                length = 3;
+            } else if (c == 0xED) {
+                length = 3;
+                high = 0x9F;
+            } else if (c == 0xF0) {
+                length = 4;
+                low = 0x90;
+            } else if (c >= 0xF1 && c <= 0xF3) {
+                length = 4;
+            } else if (c == 0xF4) {
+                length = 4;
+                high = 0x8F;
+            } else {
+                return 0;
+            }
+            if (static_cast<size_t>(end - p) < length || p[1] < low || p[1] > high) {
+                return 0;
+            }
+            for (size_t i = 2; i < length; ++i) {
+                if ((p[i] & 0xC0) != 0x80) {
+                    return 0;
+                }
+            }
+            return length;
+        }
+
+        std::int64_t toNanos(const std::chrono::system_clock::time_point& time) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        }
+
+        // 打开输出文件，"-" 表示标准输出
+        int openOutput(const std::string& path) {
+            if (path == "-") {
+                return STDOUT_FILENO;
+            }
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("无法创建报告文件 " + path + ": " + std::strerror(errno));
+            }
+            return fd;
+        }
+
+    } // namespace
+
+    // 构造函数
+    ReportWriter::ReportWriter(ReportFormat format, const std::string& path, std::vector<std::string> files)
+        : format_(format), fd_(openOutput(path)), ownsFd_(path != "-"), files_(std::move(files)), begun_(false) {
+        try {
+            out_ = std::make_unique<LogWriter>(fd_);
+        } catch (...) {
+            if (ownsFd_) {
+                ::close(fd_);
+            }
+            throw;
+        }
+    }
+
+    // 析构函数：先让输出器写完，再关闭文件
+    ReportWriter::~ReportWriter() {
+        out_.reset();
+        if (ownsFd_) {
+            ::close(fd_);
+        }
+    }
+
+    bool ReportWriter::parseFormat(std::string_view text, ReportFormat& format) {
+        std::string lower(text);
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+        if (lower == "json") {
+            format = ReportFormat::JSON;
+        } else if (lower == "csv") {
+            format = ReportFormat::CSV;
+        } else if (lower == "html") {
+            format = ReportFormat::HTML;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // JSON 字符串：转义引号、反斜杠和控制字符，无效的 UTF-8 字节替换为 U+FFFD
+    void ReportWriter::writeJsonString(std::string_view text) {
+        static const char HEX[] = "0123456789abcdef";
+        const auto* p = reinterpret_cast<const unsigned char*>(text.data());
+        const auto* end = p + text.size();
+        const auto* run = p;
+        auto flushRun = [&]() {
+            out_->write(std::string_view(reinterpret_cast<const char*>(run), static_cast<size_t>(p - run)));
+        };
+
+        out_->write("\"");
+        while (p < end) {
+            const unsigned char c = *p;
+            if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\') {
+                ++p;
+                continue;
+            }
+            if (c >= 0x80) {
+                size_t length = utf8Length(p, end);
+                if (length > 0) {
+                    p += length;
+                    continue;
+                }
+            }
+            flushRun();
+            switch (c) {
+                case '"':  out_->write("\\\""); break;
+                case '\\': out_->write("\\\\"); break;
+                case '\n': out_->write("\\n"); break;
+                case '\r': out_->write("\\r"); break;
+                case '\t': out_->write("\\t"); break;
+                case '\b': out_->write("\\b"); break;
+                case '\f': out_->write("\\f"); break;
+                default:
+                    if (c < 0x20) {
+                        const char escape[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0x0F]};
+                        out_->write(std::string_view(escape, sizeof(escape)));
+                    } else {
+                        out_->write("\\ufffd");
+                    }
+                    break;
+            }
+            run = ++p;
+        }
+        flushRun();
+        out_->write("\"");
+    }
+
+    // CSV 字段：含逗号、引号或换行时加引号，内部引号双写
+    void ReportWriter::writeCsvField(std::string_view text) {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out_->write(text);
+            return;
+        }
+        out_->write("\"");
+        size_t start = 0;
+        for (size_t quote = text.find('"'); quote != std::string_view::npos; quote = text.find('"', start)) {
+            out_->write(text.substr(start, quote + 1 - start));
+            out_->write("\"");
+            start = quote + 1;
+        }
+        out_->write(text.substr(start));
+        out_->write("\"");
+    }
+
+    // HTML 文本：转义 & < > " '
+    void ReportWriter::writeHtmlText(std::string_view text) {
+        size_t start = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            std::string_view escape;
+            switch (text[i]) {
+                case '&':  escape = "&amp;"; break;
+                case '<':  escape = "&lt;"; break;
+                case '>':  escape = "&gt;"; break;
+                case '"':  escape = "&quot;"; break;
+                case '\'': escape = "&#39;"; break;
+                default:   continue;
+            }
+            out_->write(text.substr(start, i - start));
+            out_->write(escape);
+            start = i + 1;
+        }
+        out_->write(text.substr(start));
+    }
+
+    void ReportWriter::writeNumber(std::uint64_t value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out_->write(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    }
+
+    void ReportWriter::writeDecimal(double value) {
+        char digits[32];
+        int length = std::snprintf(digits, sizeof(digits), "%.2f", value);
+        out_->write(std::string_view(digits, length > 0 ? static_cast<size_t>(length) : 0));
+    }
+
+    // 报告头
+    void ReportWriter::begin() {
+        if (begun_) {
+            return;
+        }
+        begun_ = true;
+        switch (format_) {
+            case ReportFormat::JSON:
+                out_->write("{\"files\":[");
+                for (size_t i = 0; i < files_.size(); ++i) {
+                    out_->write(i > 0 ? "," : "");
+                    writeJsonString(files_[i]);
+                }
+                out_->write("],\n\"entries\":[\n");
+                break;
+            case ReportFormat::CSV:
+                out_->write("timestamp,level,source,message\r\n");
+                break;
+            case ReportFormat::HTML:
+                out_->write(HTML_HEAD);
+                out_->write("<p>文件: ");
+                for (size_t i = 0; i < files_.size(); ++i) {
+                    out_->write(i > 0 ? ", " : "");
+                    writeHtmlText(files_[i]);
+                }
+                out_->write("</p>\n<p><a href=\"#summary\">摘要</a> · <a href=\"#aggregation\">聚合</a></p>\n"
+                            "<h2>日志条目</h2>\n<table>\n<thead><tr><th>时间</th><th>级别</th><th>来源</th>"
+                            "<th>消息</th></tr></thead>\n<tbody>\n");
+                break;
+        }
+    }
+
+    // 写入一条日志并计入摘要
+    void ReportWriter::writeEntry(std::int64_t timestampNanos, LogLevel level, std::uint32_t sourceId,
+                                  std::string_view message) {
+        begin();
+        if (summary_.entries == 0) {
+            summary_.firstTimestamp = summary_.lastTimestamp = timestampNanos;
+        } else {
+            summary_.firstTimestamp = std::min(summary_.firstTimestamp, timestampNanos);
+            summary_.lastTimestamp = std::max(summary_.lastTimestamp, timestampNanos);
+        }
+        if (static_cast<size_t>(level) < LOG_LEVEL_COUNT) {
+            ++summary_.levelCounts[static_cast<size_t>(level)];
+        }
+        const bool first = summary_.entries++ == 0;
+
+        const std::string_view levelName = logLevelName(level);
+        switch (format_) {
+            case ReportFormat::JSON:
+                out_->write(first ? "{\"timestamp\":\"" : ",\n{\"timestamp\":\"");
+                out_->write(out_->formattedTime(timestampNanos));
+                out_->write("\",\"level\":\"");
+                out_->write(levelName);
+                out_->write("\",\"source\":");
+                writeJsonString(SourceTable::name(sourceId));
+                out_->write(",\"message\":");
+                writeJsonString(message);
+                out_->write("}");
+                break;
+            case ReportFormat::CSV:
+                out_->write(out_->formattedTime(timestampNanos));
+                out_->write(",");
+                out_->write(levelName);
+                out_->write(",");
+                writeCsvField(SourceTable::name(sourceId));
+                out_->write(",");
+                writeCsvField(message);
+                out_->write("\r\n");
+                break;
+            case ReportFormat::HTML:
+                out_->write("<tr class=\"");
+                out_->write(levelName);
+                out_->write("\"><td>");
+                out_->write(out_->formattedTime(timestampNanos));
+                out_->write("</td><td>");
+                out_->write(levelName);
+                out_->write("</td><td>");
+                writeHtmlText(SourceTable::name(sourceId));
+                out_->write("</td><td class=\"m\">");
+                writeHtmlText(message);
+                out_->write("</td></tr>\n");
+                break;
+        }
+    }
+
+    void ReportWriter::writeEntry(const LogEntry& entry) {
+        writeEntry(toNanos(entry.getTimestamp()), entry.getLevel(), entry.getSourceId(), entry.getMessage());
+    }
+
+    void ReportWriter::writeRange(const LogStore& store, size_t begin, size_t end) {
+        auto timestamps = store.timestamps();
+        auto levels = store.levels();
+        auto sourceIds = store.sourceIds();
+        end = std::min(end, store.size());
+        for (size_t i = begin; i < end; ++i) {
+            writeEntry(timestamps[i], static_cast<LogLevel>(levels[i]), sourceIds[i], store.messageAt(i));
+        }
+    }
+
+    // JSON 的摘要与聚合部分
+    void ReportWriter::finishJson(const LogAggregator* aggregation, size_t topCount) {
+        out_->write(summary_.entries > 0 ? "\n],\n\"summary\":{" : "],\n\"summary\":{");
+        out_->write("\"total_lines\":");
+        writeNumber(summary_.totalLines);
+        out_->write(",\"error_lines\":");
+        writeNumber(summary_.errorLines);
+        out_->write(",\"entries\":");
+        writeNumber(summary_.entries);
+        if (summary_.entries > 0) {
+            out_->write(",\"first_timestamp\":\"");
+            out_->write(out_->formattedTime(summary_.firstTimestamp));
+            out_->write("\",\"last_timestamp\":\"");
+            out_->write(out_->formattedTime(summary_.lastTimestamp));
+            out_->write("\"");
+        }
+        out_->write(",\"levels\":{");
+        for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+            out_->write(level > 0 ? ",\"" : "\"");
+            out_->write(logLevelName(static_cast<LogLevel>(level)));
+            out_->write("\":");
+            writeNumber(summary_.levelCounts[level]);
+        }
+        out_->write("}},\n\"aggregation\":");
+        if (!aggregation) {
+            out_->write("null}\n");
+            return;
+        }
+
+        out_->write("{\"bucket_seconds\":");
+        writeNumber(static_cast<std::uint64_t>(aggregation->bucketWidth().count()));
+        out_->write(",\n\"timeline\":[");
+        bool first = true;
+        for (const auto& bucket : aggregation->timeline()) {
+            out_->write(first ? "\n{\"start\":\"" : ",\n{\"start\":\"");
+            first = false;
+            out_->write(out_->formattedTime(toNanos(aggregation->bucketStart(bucket.bucket))));
+            out_->write("\"");
+            for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                out_->write(",\"");
+                out_->write(logLevelName(static_cast<LogLevel>(level)));
+                out_->write("\":");
+                writeNumber(bucket.counts[level]);
+            }
+            out_->write("}");
+        }
+
+        auto writeSources = [&](const char* key, LogLevel minLevel) {
+            out_->write("],\n\"");
+            out_->write(key);
+            out_->write("\":[");
+            bool firstSource = true;
+            for (const auto& source : aggregation->topSources(minLevel, topCount)) {
+                out_->write(firstSource ? "{\"source\":" : ",{\"source\":");
+                firstSource = false;
+                writeJsonString(SourceTable::name(source.first));
+                out_->write(",\"count\":");
+                writeNumber(source.second);
+                out_->write("}");
+            }
+        };
+        writeSources("top_sources", LogLevel::DEBUG);
+        writeSources("top_error_sources", LogLevel::ERROR);
+
+        out_->write("],\n\"error_spikes\":[");
+        first = true;
+        for (const auto& spike : aggregation->findSpikes(LogLevel::ERROR, LogAggregator::DEFAULT_SPIKE_WINDOW,
+                                                         LogAggregator::DEFAULT_SPIKE_THRESHOLD)) {
+            out_->write(first ? "{\"start\":\"" : ",{\"start\":\"");
+            first = false;
+            out_->write(out_->formattedTime(toNanos(aggregation->bucketStart(spike.bucket))));
+            out_->write("\",\"count\":");
+            writeNumber(spike.count);
+            out_->write(",\"baseline\":");
+            writeDecimal(spike.baseline);
+            out_->write(",\"score\":");
+            writeDecimal(spike.score);
+            out_->write("}");
+        }
+        out_->write("]}}\n");
+    }
+
+    // HTML 的摘要与聚合部分
+    void ReportWriter::finishHtml(const LogAggregator* aggregation, size_t topCount) {
+        out_->write("</tbody>\n</table>\n<h2 id=\"summary\">摘要</h2>\n<table>\n<tr><th>总行数</th><td class=\"n\">");
+        writeNumber(summary_.totalLines);
+        out_->write("</td></tr>\n<tr><th>无法解析</th><td class=\"n\">");
+        writeNumber(summary_.errorLines);
+        out_->write("</td></tr>\n<tr><th>报告条目</th><td class=\"n\">");
+        writeNumber(summary_.entries);
+        out_->write("</td></tr>\n");
+        if (summary_.entries > 0) {
+            out_->write("<tr><th>最早</th><td>");
+            out_->write(out_->formattedTime(summary_.firstTimestamp));
+            out_->write("</td></tr>\n<tr><th>最晚</th><td>");
+            out_->write(out_->formattedTime(summary_.lastTimestamp));
+            out_->write("</td></tr>\n");
+        }
+        for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+            out_->write("<tr><th>");
+            out_->write(logLevelName(static_cast<LogLevel>(level)));
+            out_->write("</th><td class=\"n\">");
+            writeNumber(summary_.levelCounts[level]);
+            out_->write("</td></tr>\n");
+        }
+        out_->write("</table>\n<h2 id=\"aggregation\">聚合</h2>\n");
+        if (!aggregation) {
+            out_->write("<p>无</p>\n</body>\n</html>\n");
+            return;
+        }
+
+        out_->write("<h3>时间线（时间桶 ");
+        writeNumber(static_cast<std::uint64_t>(aggregation->bucketWidth().count()));
+        out_->write(" 秒）</h3>\n<table>\n<thead><tr><th>时间</th>");
+        for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+            out_->write("<th>");
+            out_->write(logLevelName(static_cast<LogLevel>(level)));
+            out_->write("</th>");
+        }
+        out_->write("</tr></thead>\n<tbody>\n");
+        for (const auto& bucket : aggregation->timeline()) {
+            out_->write("<tr><td>");
+            out_->write(out_->formattedTime(toNanos(aggregation->bucketStart(bucket.bucket))));
+            out_->write("</td>");
+            for (std::uint64_t count : bucket.counts) {
+                out_->write("<td class=\"n\">");
+                writeNumber(count);
+                out_->write("</td>");
+            }
+            out_->write("</tr>\n");
+        }
+        out_->write("</tbody>\n</table>\n");
+
+        auto writeSources = [&](const char* title, LogLevel minLevel) {
+            out_->write("<h3>");
+            out_->write(title);
+            out_->write("</h3>\n<table>\n<thead><tr><th>来源</th><th>条目数</th></tr></thead>\n<tbody>\n");
+            for (const auto& source : aggregation->topSources(minLevel, topCount)) {
+                out_->write("<tr><td>");
+                writeHtmlText(SourceTable::name(source.first));
+                out_->write("</td><td class=\"n\">");
+                writeNumber(source.second);
+                out_->write("</td></tr>\n");
+            }
+            out_->write("</tbody>\n</table>\n");
+        };
+        writeSources("条目最多的来源", LogLevel::DEBUG);
+        writeSources("ERROR 及以上最多的来源", LogLevel::ERROR);
+
+        out_->write("<h3>ERROR 及以上的突增</h3>\n<table>\n<thead><tr><th>时间</th><th>条目数</th><th>基线</th>"
+                    "<th>标准差倍数</th></tr></thead>\n<tbody>\n");
+        for (const auto& spike : aggregation->findSpikes(LogLevel::ERROR, LogAggregator::DEFAULT_SPIKE_WINDOW,
+                                                         LogAggregator::DEFAULT_SPIKE_THRESHOLD)) {
+            out_->write("<tr><td>");
+            out_->write(out_->formattedTime(toNanos(aggregation->bucketStart(spike.bucket))));
+            out_->write("</td><td class=\"n\">");
+            writeNumber(spike.count);
+            out_->write("</td><td class=\"n\">");
+            writeDecimal(spike.baseline);
+            out_->write("</td><td class=\"n\">");
+            writeDecimal(spike.score);
+            out_->write("</td></tr>\n");
+        }
+        out_->write("</tbody>\n</table>\n</body>\n</html>\n");
+    }
+
+    // 结束报告
+    void ReportWriter::finish(const LogAggregator* aggregation, size_t topCount) {
+        begin();
+        switch (format_) {
+            case ReportFormat::JSON:
+                finishJson(aggregation, topCount);
+                break;
+            case ReportFormat::CSV:
+                break;
+            case ReportFormat::HTML:
+                finishHtml(aggregation, topCount);
+                break;
+        }
+        out_->flush();
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,209 @@
+/*
+ * SpaceSaving.cpp
+ * SpaceSaving 类的实现
+ */
+
+#include "SpaceSaving.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        // 计数递减、相同时哈希递增
+        bool moreFrequent(const SpaceSaving::Counter& a, const SpaceSaving::Counter& b) {
+            return a.count != b.count ? a.count > b.count : a.hash < b.hash;
+        }
+
+    } // namespace
+
+    // 构造函数：开放寻址表的装载因子不超过 1/2
+    SpaceSaving::SpaceSaving(size_t capacity) : capacity_(capacity), total_(0) {
+        if (capacity == 0 || capacity > 0x7fffffff) {
+            throw std::invalid_argument("Space-Saving 的容量必须为正数");
+        }
+        size_t tableSize = 8;
+        while (tableSize < capacity * 2) {
+            tableSize <<= 1;
+        }
+        table_.assign(tableSize, 0);
+        mask_ = tableSize - 1;
+        counters_.reserve(capacity);
+    }
+
+    // 查找哈希所在的槽；不存在时返回应插入的空槽
+    size_t SpaceSaving::findSlot(std::uint64_t hash) const {
+        size_t slot = static_cast<size_t>(hash) & mask_;
+        while (table_[slot] != 0 && counters_[table_[slot] - 1].hash != hash) {
+            slot = (slot + 1) & mask_;
+        }
+        return slot;
+    }
+
+    void SpaceSaving::insertSlot(size_t index) {
+        size_t slot = findSlot(counters_[index].hash);
+        table_[slot] = static_cast<std::uint32_t>(index + 1);
+        counters_[index].slot = slot;
+    }
+
+    // 删除槽位并把后续探测链上的项前移（不使用墓碑）
+    void SpaceSaving::eraseSlot(size_t slot) {
+        table_[slot] = 0;
+        size_t hole = slot;
+        for (size_t i = (slot + 1) & mask_; table_[i] != 0; i = (i + 1) & mask_) {
+            size_t home = static_cast<size_t>(counters_[table_[i] - 1].hash) & mask_;
+            bool movable = hole <= i ? (home <= hole || home > i) : (home <= hole && home > i);
+            if (movable) {
+                table_[hole] = table_[i];
+                counters_[table_[hole] - 1].slot = hole;
+                table_[i] = 0;
+                hole = i;
+            }
+        }
+    }
+
+    void SpaceSaving::swapCounters(size_t a, size_t b) {
+        std::swap(counters_[a], counters_[b]);
+        table_[counters_[a].slot] = static_cast<std::uint32_t>(a + 1);
+        table_[counters_[b].slot] = static_cast<std::uint32_t>(b + 1);
+    }
+
+    void SpaceSaving::siftDown(size_t index) {
+        const size_t size = counters_.size();
+        while (true) {
+            size_t smallest = index;
+            size_t left = index * 2 + 1;
+            size_t right = left + 1;
+            if (left < size && counters_[left].count < counters_[smallest].count) {
+                smallest = left;
+            }
+            if (right < size && counters_[right].count < counters_[smallest].count) {
+                smallest = right;
+            }
+            if (smallest == index) {
+                return;
+            }
+            swapCounters(index, smallest);
+            index = smallest;
+        }
+    }
+
+    void SpaceSaving::siftUp(size_t index) {
+        while (index > 0) {
+            size_t parent = (index - 1) / 2;
+            if (counters_[parent].count <= counters_[index].count) {
+                return;
+            }
+            swapCounters(index, parent);
+            index = parent;
+        }
+    }
+
+    // 计入一个值
+    std::string* SpaceSaving::add(std::uint64_t hash, std::uint64_t count) {
+        total_ += count;
+        size_t slot = findSlot(hash);
+        if (table_[slot] != 0) {
+            size_t index = table_[slot] - 1;
+            counters_[index].count += count;
+            siftDown(index);
+            return nullptr;
+        }
+
+        if (counters_.size() < capacity_) {
+            counters_.push_back(Counter{hash, count, 0, std::string(), slot});
+            table_[slot] = static_cast<std::uint32_t>(counters_.size());
+            siftUp(counters_.size() - 1);
+            return &counters_[table_[slot] - 1].label;
+        }
+
+        // 表已满：替换计数最小的值（堆顶），继承它的计数作为误差
+        Counter& victim = counters_[0];
+        eraseSlot(victim.slot);
+        slot = findSlot(hash);
+        table_[slot] = 1;
+        victim.hash = hash;
+        victim.error = victim.count;
+        victim.count += count;
+        victim.slot = slot;
+        victim.label.clear();
+        siftDown(0);
+        return &counters_[table_[slot] - 1].label;
+    }
+
+    // 合并
+    void SpaceSaving::merge(const SpaceSaving& other) {
+        total_ += other.total_;
+        if (other.counters_.empty()) {
+            return;
+        }
+
+        // 表未满时没有被挤出的值，缺席即真实频次为 0
+        const std::uint64_t ownMin = counters_.size() == capacity_ ? counters_[0].count : 0;
+        const std::uint64_t otherMin = other.counters_.size() == other.capacity_ ? other.counters_[0].count : 0;
+
+        std::vector<Counter> combined(std::move(counters_));
+        const size_t ownCount = combined.size();
+        std::unordered_map<std::uint64_t, size_t> position;
+        for (size_t i = 0; i < ownCount; ++i) {
+            position.emplace(combined[i].hash, i);
+        }
+        std::vector<bool> matched(ownCount, false);
+        for (const Counter& counter : other.counters_) {
+            auto it = position.find(counter.hash);
+            if (it != position.end()) {
+                combined[it->second].count += counter.count;
+                combined[it->second].error += counter.error;
+                matched[it->second] = true;
+            } else {
+                combined.push_back(counter);
+                combined.back().count += ownMin;
+                combined.back().error += ownMin;
+            }
+        }
+        for (size_t i = 0; i < ownCount; ++i) {
+            if (!matched[i]) {
+                combined[i].count += otherMin;
+                combined[i].error += otherMin;
+            }
+        }
+
+        // 保留计数最大的 capacity 个，重建堆和寻址表
+        if (combined.size() > capacity_) {
+            std::nth_element(combined.begin(), combined.begin() + static_cast<std::ptrdiff_t>(capacity_) - 1,
+                             combined.end(), moreFrequent);
+            combined.resize(capacity_);
+        }
+        std::make_heap(combined.begin(), combined.end(), moreFrequent);
+        counters_ = std::move(combined);
+        counters_.reserve(capacity_);
+        std::fill(table_.begin(), table_.end(), 0);
+        for (size_t i = 0; i < counters_.size(); ++i) {
+            insertSlot(i);
+        }
+    }
+
+    // 计数最大的若干个值
+    std::vector<SpaceSaving::Counter> SpaceSaving::top(size_t count) const {
+        std::vector<Counter> result(counters_);
+        if (result.size() > count) {
+            std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(count), result.end(),
+                              moreFrequent);
+            result.resize(count);
+        } else {
+            std::sort(result.begin(), result.end(), moreFrequent);
+        }
+        return result;
+    }
+
+    size_t SpaceSaving::memoryBytes() const {
+        size_t bytes = counters_.capacity() * sizeof(Counter) + table_.size() * sizeof(std::uint32_t);
+        for (const Counter& counter : counters_) {
+            bytes += counter.label.capacity();
+        }
+        return bytes;
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,183 @@
+/*
+ * StringPool.cpp
+ * SourceTable 与 MessageArena 的实现
+ */
+
+#include "StringPool.h"
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <cstring>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        // 驻留表的全局状态：分段只分配不释放，已登记字符串的地址稳定。
+        // 登记时先写好字符串再以 release 语义增加 count，读取方以 acquire 读取 count 后无锁访问
+        struct SourceRegistry {
+            std::mutex mutex;
+            std::unordered_map<std::string_view, std::uint32_t> ids;
+            std::atomic<std::string*> segments[SourceTable::MAX_SEGMENTS];
+            std::atomic<std::uint32_t> count;
+
+            SourceRegistry() : count(0) {
+                for (auto& segment : segments) {
+                    segment.store(nullptr, std::memory_order_relaxed);
+                }
+                append(std::string_view());
+            }
+
+            // 追加一个字符串（调用方持有 mutex）；只剩保留编号时登记溢出来源并返回它
+            std::uint32_t append(std::string_view name) {
+                std::uint32_t id = count.load(std::memory_order_relaxed);
+                if (id > SourceTable::OVERFLOW_ID) {
+                    return SourceTable::OVERFLOW_ID;
+                }
+                if (id == SourceTable::OVERFLOW_ID) {
+                    std::cerr << "警告: 来源数量超出上限 " << SourceTable::OVERFLOW_ID
+                              << "，之后的新来源统一记为 " << SourceTable::OVERFLOW_NAME << std::endl;
+                    name = SourceTable::OVERFLOW_NAME;
+                }
+                const size_t segment = id / SourceTable::SEGMENT_SIZE;
+                std::string* slots = segments[segment].load(std::memory_order_relaxed);
+                if (slots == nullptr) {
+                    slots = new std::string[SourceTable::SEGMENT_SIZE];
+                    segments[segment].store(slots, std::memory_order_relaxed);
+                }
+                std::string& slot = slots[id % SourceTable::SEGMENT_SIZE];
+                slot.assign(name);
+                ids.emplace(std::string_view(slot), id);
+                count.store(id + 1, std::memory_order_release);
+                return id;
+            }
+
+            const std::string& at(std::uint32_t id) const {
+                return segments[id / SourceTable::SEGMENT_SIZE].load(std::memory_order_relaxed)
+                    [id % SourceTable::SEGMENT_SIZE];
+            }
+        };
+
+        // 有意不析构：其他静态对象析构时可能仍在读取来源名称
+        SourceRegistry& registry() {
+            static SourceRegistry* instance = new SourceRegistry();
+            return *instance;
+        }
+
+        thread_local MessageArena* currentArena = nullptr;
+
+    } // namespace
+
+    // ===== SourceTable =====
+
+    std::uint32_t SourceTable::intern(std::string_view name) {
+        // 线程本地缓存：键指向驻留表中的稳定字符串，命中时无需加锁
+        thread_local std::unordered_map<std::string_view, std::uint32_t> localIds;
+
+        auto local = localIds.find(name);
+        if (local != localIds.end()) {
+            return local->second;
+        }
+
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto it = reg.ids.find(name);
+        std::uint32_t id = it != reg.ids.end() ? it->second : reg.append(name);
+        // 溢出来源的原名没有登记，不能作为缓存的键
+        if (id != OVERFLOW_ID) {
+            const std::string& stored = reg.at(id);
+            localIds.emplace(std::string_view(stored), id);
+        }
+        return id;
+    }
+
+    // 无锁读取：编号小于已发布的数量时，对应字符串已经写好且不再改变
+    const std::string& SourceTable::name(std::uint32_t id) {
+        const auto& reg = registry();
+        return id < reg.count.load(std::memory_order_acquire) ? reg.at(id) : reg.at(0);
+    }
+
+    size_t SourceTable::size() {
+        return registry().count.load(std::memory_order_acquire);
+    }
+
+    // ===== MessageArena =====
+
+    MessageArena::MessageArena(size_t blockSize)
+        : cursor_(nullptr), remaining_(0), bytesUsed_(0), blockSize_(blockSize) {
+    }
+
+    void MessageArena::grow() {
+        blocks_.emplace_back(new char[blockSize_]);
+        cursor_ = blocks_.back().get();
+        remaining_ = blockSize_;
+    }
+
+    std::string_view MessageArena::store(std::string_view text) {
+        if (text.empty()) {
+            return std::string_view();
+        }
+
+        char* dest;
+        if (text.size() > blockSize_ / 4) {
+            // 大消息单独占一个块，当前块的剩余空间继续使用
+            largeBlocks_.emplace_back(new char[text.size()]);
+            dest = largeBlocks_.back().get();
+        } else {
+            if (remaining_ < text.size()) {
+                grow();
+            }
+            dest = cursor_;
+            cursor_ += text.size();
+            remaining_ -= text.size();
+        }
+
+        std::memcpy(dest, text.data(), text.size());
+        bytesUsed_ += text.size();
+        return std::string_view(dest, text.size());
+    }
+
+    void MessageArena::reset() {
+        // 保留第一个标准块供下一批复用，其余全部释放
+        if (blocks_.size() > 1) {
+            blocks_.resize(1);
+        }
+        largeBlocks_.clear();
+        cursor_ = blocks_.empty() ? nullptr : blocks_.front().get();
+        remaining_ = blocks_.empty() ? 0 : blockSize_;
+        bytesUsed_ = 0;
+    }
+
+    void MessageArena::releaseTo(MessageArena& target) {
+        for (auto& block : blocks_) {
+            target.largeBlocks_.push_back(std::move(block));
+        }
+        for (auto& block : largeBlocks_) {
+            target.largeBlocks_.push_back(std::move(block));
+        }
+        target.bytesUsed_ += bytesUsed_;
+        blocks_.clear();
+        largeBlocks_.clear();
+        cursor_ = nullptr;
+        remaining_ = 0;
+        bytesUsed_ = 0;
+    }
+
+    MessageArena& MessageArena::current() {
+        if (currentArena != nullptr) {
+            return *currentArena;
+        }
+        thread_local MessageArena threadArena;
+        return threadArena;
+    }
+
+    MessageArena::Scope::Scope(MessageArena& arena)
+        : previous_(currentArena) {
+        currentArena = &arena;
+    }
+
+    MessageArena::Scope::~Scope() {
+        currentArena = previous_;
+    }
+
+} // namespace LogAnalyzer
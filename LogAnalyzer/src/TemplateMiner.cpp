@@ -0,0 +1,192 @@
+/*
+ * TemplateMiner.cpp
+ * TemplateMiner 类的实现
+ */
+
+#include "TemplateMiner.h"
+#include "LogStore.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        // 参数（通配符）
+        constexpr std::string_view WILDCARD = "<*>";
+
+        // 示例消息的最大字节数
+        constexpr size_t MAX_EXAMPLE_BYTES = 200;
+
+        bool hasDigit(std::string_view token) {
+            return std::any_of(token.begin(), token.end(), [](char c) { return c >= '0' && c <= '9'; });
+        }
+
+        bool isSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        // 按空白切分，词视图指向消息本身
+        void tokenize(std::string_view message, std::vector<std::string_view>& tokens) {
+            tokens.clear();
+            size_t i = 0;
+            while (i < message.size()) {
+                while (i < message.size() && isSpace(message[i])) {
+                    ++i;
+                }
+                size_t start = i;
+                while (i < message.size() && !isSpace(message[i])) {
+                    ++i;
+                }
+                if (i > start) {
+                    tokens.push_back(message.substr(start, i - start));
+                }
+            }
+        }
+
+        // 截断到不超过上限的完整 UTF-8 字符
+        std::string_view truncateExample(std::string_view text) {
+            if (text.size() <= MAX_EXAMPLE_BYTES) {
+                return text;
+            }
+            size_t cut = MAX_EXAMPLE_BYTES;
+            while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) {
+                --cut;
+            }
+            return text.substr(0, cut);
+        }
+
+    } // namespace
+
+    // 构造函数
+    TemplateMiner::TemplateMiner(const TemplateMinerOptions& options) : options_(options), total_(0) {
+        if (options.prefixTokens == 0 || options.maxChildren == 0 ||
+            !(options.similarity >= 0.0 && options.similarity <= 1.0)) {
+            throw std::invalid_argument("模板挖掘参数无效：前导词数和子节点上限必须为正数，相似度必须在 0 到 1 之间");
+        }
+    }
+
+    // 第一层按词数，之后每层按一个前导词；含数字的词和超出子节点上限的词走通配分支
+    TemplateMiner::Node& TemplateMiner::leafFor(const std::vector<std::string_view>& tokens) {
+        Node* node = &lengthNodes_[tokens.size()];
+        const size_t levels = std::min(options_.prefixTokens, tokens.size());
+        for (size_t i = 0; i < levels; ++i) {
+            std::string_view key = hasDigit(tokens[i]) ? WILDCARD : tokens[i];
+            auto child = node->children.find(key);
+            if (child == node->children.end() && node->children.size() >= options_.maxChildren) {
+                key = WILDCARD;
+                child = node->children.find(key);
+            }
+            if (child == node->children.end()) {
+                child = node->children.emplace(std::string(key), std::make_unique<Node>()).first;
+            }
+            node = child->second.get();
+        }
+        return *node;
+    }
+
+    // 归入最相似的模板或新建模板
+    void TemplateMiner::insert(const std::vector<std::string_view>& tokens, std::uint64_t count,
+                               std::string_view example) {
+        Node& leaf = leafFor(tokens);
+        total_ += count;
+
+        // 相似度 = 相同位置的比例；模板中的参数位置与含数字的词视为相同。
+        // 相似度相同时选参数较多（更一般）的模板
+        Cluster* best = nullptr;
+        double bestSimilarity = -1.0;
+        size_t bestParameters = 0;
+        for (std::uint32_t id : leaf.clusters) {
+            Cluster& cluster = clusters_[id];
+            size_t same = 0;
+            size_t parameters = 0;
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                const std::string& token = cluster.tokens[i];
+                if (token == WILDCARD) {
+                    ++parameters;
+                    if (tokens[i] == WILDCARD || hasDigit(tokens[i])) {
+                        ++same;
+                    }
+                } else if (token == tokens[i]) {
+                    ++same;
+                }
+            }
+            double similarity = tokens.empty() ? 1.0 : static_cast<double>(same) / static_cast<double>(tokens.size());
+            if (similarity > bestSimilarity || (similarity == bestSimilarity && parameters > bestParameters)) {
+                best = &cluster;
+                bestSimilarity = similarity;
+                bestParameters = parameters;
+            }
+        }
+
+        if (best && bestSimilarity >= options_.similarity) {
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                if (best->tokens[i] != WILDCARD && best->tokens[i] != tokens[i]) {
+                    best->tokens[i].assign(WILDCARD);
+                }
+            }
+            best->count += count;
+            return;
+        }
+
+        Cluster cluster;
+        cluster.tokens.reserve(tokens.size());
+        for (std::string_view token : tokens) {
+            cluster.tokens.emplace_back(hasDigit(token) ? WILDCARD : token);
+        }
+        cluster.count = count;
+        cluster.example.assign(truncateExample(example));
+        leaf.clusters.push_back(static_cast<std::uint32_t>(clusters_.size()));
+        clusters_.push_back(std::move(cluster));
+    }
+
+    // 计入一条消息
+    void TemplateMiner::add(std::string_view message) {
+        tokenize(message, tokens_);
+        insert(tokens_, 1, message);
+    }
+
+    void TemplateMiner::addRange(const LogStore& store, size_t begin, size_t end) {
+        end = std::min(end, store.size());
+        for (size_t i = begin; i < end; ++i) {
+            add(store.messageAt(i));
+        }
+    }
+
+    // 合并：把另一棵树的模板按建立顺序逐个归并
+    void TemplateMiner::merge(const TemplateMiner& other) {
+        if (other.options_.prefixTokens != options_.prefixTokens ||
+            other.options_.similarity != options_.similarity ||
+            other.options_.maxChildren != options_.maxChildren) {
+            throw std::invalid_argument("无法合并参数不同的模板挖掘结果");
+        }
+        std::vector<std::string_view> tokens;
+        for (const Cluster& cluster : other.clusters_) {
+            tokens.assign(cluster.tokens.begin(), cluster.tokens.end());
+            insert(tokens, cluster.count, cluster.example);
+        }
+    }
+
+    // 全部模板
+    std::vector<TemplateMiner::Template> TemplateMiner::templates() const {
+        std::vector<Template> result;
+        result.reserve(clusters_.size());
+        for (const Cluster& cluster : clusters_) {
+            Template entry;
+            for (size_t i = 0; i < cluster.tokens.size(); ++i) {
+                if (i > 0) {
+                    entry.text += ' ';
+                }
+                entry.text += cluster.tokens[i];
+            }
+            entry.count = cluster.count;
+            entry.example = cluster.example;
+            result.push_back(std::move(entry));
+        }
+        std::sort(result.begin(), result.end(), [](const Template& a, const Template& b) {
+            return a.count != b.count ? a.count > b.count : a.text < b.text;
+        });
+        return result;
+    }
+
+} // namespace LogAnalyzer
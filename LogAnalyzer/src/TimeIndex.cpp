@@ -0,0 +1,216 @@
+/*
+ * TimeIndex.cpp
+ * TimeIndex 类的实现
+ */
+
+#include "TimeIndex.h"
+#include "LogParser.h"
+#include "MappedFile.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        const char INDEX_MAGIC[8] = {'L', 'A', 'T', 'I', 'D', 'X', '0', '1'};
+        constexpr std::uint32_t INDEX_VERSION = 3;
+
+        inline std::int64_t floorDiv(std::int64_t a, std::int64_t b) {
+            std::int64_t q = a / b;
+            return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+        }
+
+        // 时间点向下 / 向上取整到秒
+        inline std::int64_t floorSeconds(const std::chrono::system_clock::time_point& tp) {
+            auto secs = std::chrono::floor<std::chrono::seconds>(tp.time_since_epoch());
+            return secs.count();
+        }
+
+        inline std::int64_t ceilSeconds(const std::chrono::system_clock::time_point& tp) {
+            auto secs = std::chrono::ceil<std::chrono::seconds>(tp.time_since_epoch());
+            return secs.count();
+        }
+
+    } // namespace
+
+    // 构造函数
+    TimeIndex::TimeIndex(const std::string& filename, std::uint32_t bucketSeconds)
+        : filename_(filename), indexedBytes_(0), bucketSeconds_(bucketSeconds), sorted_(true) {
+    }
+
+    std::string TimeIndex::indexPath(const std::string& filename) {
+        return filename + ".tidx";
+    }
+
+    // 加载、校验、增量扩展或重建
+    TimeIndex TimeIndex::loadOrBuild(const std::string& filename, LogParser& parser) {
+        // 索引可直接使用时只读取文件开头算签名，不为整个文件安排预读；需要扫描的区间再单独预读
+        MappedFile mapped;
+        if (!mapped.open(filename, MappedFile::Access::RANDOM)) {
+            throw std::runtime_error("无法打开文件: " + filename);
+        }
+        FileSignature current = FileSignature::capture(filename, mapped, parser.getPatternHash());
+
+        TimeIndex index(filename);
+        bool loaded = index.load();
+        if (loaded && index.signature_.matches(current)) {
+            return index;
+        }
+
+        if (loaded && index.signature_.isPrefixOf(current, mapped)) {
+            // 只在末尾追加：从上次索引到的位置继续
+            mapped.prefetch(static_cast<size_t>(index.indexedBytes_),
+                            static_cast<size_t>(current.size - index.indexedBytes_));
+            index.scan(mapped.data(), index.indexedBytes_, current.size, parser);
+        } else {
+            index = TimeIndex(filename);
+            mapped.prefetch(0, static_cast<size_t>(current.size));
+            index.scan(mapped.data(), 0, current.size, parser);
+        }
+        index.signature_ = current;
+
+        // 写不进去（例如只读目录）时索引仍可在本次查询中使用
+        index.save();
+        return index;
+    }
+
+    // 扫描完整的行并记录每个时间桶的第一行
+    void TimeIndex::scan(const char* data, std::uint64_t from, std::uint64_t to, LogParser& parser) {
+        // 扫描期间的消息写入临时内存池，定期重置
+        MessageArena scratch;
+        MessageArena::Scope scope(scratch);
+        LogEntry entry;
+
+        std::uint64_t cursor = from;
+        while (cursor < to) {
+            const char* newline = static_cast<const char*>(
+                std::memchr(data + cursor, '\n', static_cast<size_t>(to - cursor)));
+            if (newline == nullptr) {
+                break;  // 末尾的半行等写完后再索引
+            }
+            std::uint64_t lineEnd = static_cast<std::uint64_t>(newline - data);
+
+            if (parser.parseLine(std::string_view(data + cursor, static_cast<size_t>(lineEnd - cursor)), entry)) {
+                std::int64_t bucket = floorDiv(floorSeconds(entry.getTimestamp()), bucketSeconds_);
+                if (buckets_.empty() || bucket > buckets_.back().bucket) {
+                    buckets_.push_back({bucket, cursor});
+                } else if (bucket < buckets_.back().bucket) {
+                    sorted_ = false;
+                }
+            }
+
+            cursor = lineEnd + 1;
+            indexedBytes_ = cursor;
+            if (scratch.bytesUsed() >= MessageArena::DEFAULT_BLOCK_SIZE) {
+                scratch.reset();
+            }
+        }
+    }
+
+    // 读取索引文件；索引损坏或截断时返回 false，由调用方重建，而不是让异常跳过整个日志文件
+    bool TimeIndex::load() {
+        try {
+            if (loadFrom(indexPath(filename_))) {
+                return true;
+            }
+        } catch (const std::exception&) {
+        }
+        buckets_.clear();
+        return false;
+    }
+
+    bool TimeIndex::loadFrom(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            return false;
+        }
+
+        char magic[sizeof(INDEX_MAGIC)];
+        std::uint32_t version = 0;
+        std::uint8_t sorted = 0;
+        std::uint64_t count = 0;
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+            !readBinary(in, version) || version != INDEX_VERSION ||
+            !readBinary(in, bucketSeconds_) || bucketSeconds_ == 0 ||
+            !signature_.read(in) || !readBinary(in, indexedBytes_) ||
+            !readBinary(in, sorted) || !readBinary(in, count)) {
+            return false;
+        }
+        sorted_ = sorted != 0;
+
+        // 每个桶占 16 字节；数量超过文件剩余内容说明索引已损坏
+        const std::uint64_t bucketBytes = sizeof(Bucket::bucket) + sizeof(Bucket::offset);
+        if (count > remainingBytes(in) / bucketBytes) {
+            return false;
+        }
+
+        buckets_.resize(static_cast<size_t>(count));
+        for (auto& bucket : buckets_) {
+            if (!readBinary(in, bucket.bucket) || !readBinary(in, bucket.offset)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 写入索引文件
+    bool TimeIndex::save() const {
+        const std::string path = indexPath(filename_);
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+
+            out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+            writeBinary(out, INDEX_VERSION);
+            writeBinary(out, bucketSeconds_);
+            signature_.write(out);
+            writeBinary(out, indexedBytes_);
+            writeBinary(out, static_cast<std::uint8_t>(sorted_ ? 1 : 0));
+            writeBinary(out, static_cast<std::uint64_t>(buckets_.size()));
+            for (const auto& bucket : buckets_) {
+                writeBinary(out, bucket.bucket);
+                writeBinary(out, bucket.offset);
+            }
+            if (!out) {
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+        return std::rename(tempPath.c_str(), path.c_str()) == 0;
+    }
+
+    // 时间范围对应的字节区间
+    std::pair<std::uint64_t, std::uint64_t> TimeIndex::byteRange(const TimePoint& begin,
+                                                                 const TimePoint& end) const {
+        const std::uint64_t toEof = std::numeric_limits<std::uint64_t>::max();
+        if (!sorted_ || buckets_.empty()) {
+            return {0, toEof};
+        }
+
+        auto byBucket = [](const Bucket& b, std::int64_t value) { return b.bucket < value; };
+
+        // 起点：包含 begin 的桶（或之前最近的桶）的第一行
+        std::int64_t firstBucket = floorDiv(floorSeconds(begin), bucketSeconds_);
+        auto startIt = std::upper_bound(buckets_.begin(), buckets_.end(), firstBucket,
+                                        [](std::int64_t value, const Bucket& b) { return value < b.bucket; });
+        std::uint64_t start = startIt == buckets_.begin() ? 0 : std::prev(startIt)->offset;
+
+        // 终点：第一个起始时间不早于 end 的桶，之后的行都不在范围内
+        std::int64_t endSeconds = ceilSeconds(end);
+        std::int64_t endBucket = floorDiv(endSeconds + bucketSeconds_ - 1, bucketSeconds_);
+        auto endIt = std::lower_bound(buckets_.begin(), buckets_.end(), endBucket, byBucket);
+        std::uint64_t finish = endIt == buckets_.end() ? toEof : endIt->offset;
+
+        return {start, std::max(start, finish)};
+    }
+
+} // namespace LogAnalyzer
@@ -0,0 +1,236 @@
+/*
+ * TimestampParser.cpp
+ * TimestampParser 类的实现
+ */
+
+#include "TimestampParser.h"
+#include <cstring>
+#include <ctime>
+#include <sstream>
+#include <iomanip>
+#include <string>
+
+namespace LogAnalyzer {
+
+    namespace {
+
+        // 慢速路径依次尝试的格式
+        const char* const GENERIC_FORMATS[] = {
+            "%Y-%m-%d %H:%M:%S",           // 2024-01-15 14:30:45
+            "%Y-%m-%dT%H:%M:%S",           // 2024-01-15T14:30:45
+            "%b %d %H:%M:%S"               // Jan 15 14:30:45
+        };
+
+        const char MONTH_NAMES[12][4] = {
+            "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+            "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+        };
+
+        inline bool isDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        // 读取两位数字
+        inline bool readTwoDigits(const char* p, unsigned& value) {
+            if (!isDigit(p[0]) || !isDigit(p[1])) return false;
+            value = static_cast<unsigned>((p[0] - '0') * 10 + (p[1] - '0'));
+            return true;
+        }
+
+        // 向下取整除法（1900 年等早于纪元的时间为负数）
+        inline std::int64_t floorDiv(std::int64_t a, std::int64_t b) {
+            std::int64_t q = a / b;
+            return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+        }
+
+        /**
+         * 解析秒之后的部分：空、[,.]小数、可选的 Z
+         * 小数最多保留 9 位（纳秒），多余的位被截断
+         */
+        bool parseFraction(std::string_view rest, std::int64_t& nanos) {
+            nanos = 0;
+            size_t pos = 0;
+            if (pos < rest.size() && (rest[pos] == ',' || rest[pos] == '.')) {
+                ++pos;
+                size_t digits = 0;
+                while (pos < rest.size() && isDigit(rest[pos])) {
+                    if (digits < 9) {
+                        nanos = nanos * 10 + (rest[pos] - '0');
+                    }
+                    ++digits;
+                    ++pos;
+                }
+                if (digits == 0) return false;
+                for (size_t i = digits; i < 9; ++i) {
+                    nanos *= 10;
+                }
+            }
+            if (pos < rest.size() && rest[pos] == 'Z') {
+                ++pos;
+            }
+            return pos == rest.size();
+        }
+
+        // 时分秒的范围与 std::get_time 一致（秒允许闰秒 60）
+        inline bool validTime(unsigned hour, unsigned minute, unsigned second) {
+            return hour <= 23 && minute <= 59 && second <= 60;
+        }
+
+        inline std::int64_t civilSeconds(std::int64_t year, unsigned month, unsigned day,
+                                         unsigned hour, unsigned minute, unsigned second) {
+            return TimestampParser::daysFromCivil(year, month, day) * 86400 +
+                   hour * 3600 + minute * 60 + second;
+        }
+
+    } // namespace
+
+    // 构造函数
+    TimestampParser::TimestampParser()
+        : cachedText_(), cachedLength_(0), cachedSeconds_(0),
+          cachedHour_(INT64_MIN), cachedOffset_(0) {
+    }
+
+    // 公历日期到天数（Howard Hinnant 的 days_from_civil 算法）
+    std::int64_t TimestampParser::daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+        year -= month <= 2;
+        const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(year - era * 400);
+        const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+    }
+
+    // 解析时间戳
+    bool TimestampParser::parse(std::string_view text, TimePoint& result) {
+        std::int64_t nanos = 0;
+
+        // 同一秒的连续时间戳：秒级文本相同，直接复用上次的换算结果
+        size_t secondsLength = (text.size() >= 19 && text[4] == '-') ? 19 : text.size();
+        if (secondsLength == cachedLength_ && cachedLength_ > 0 &&
+            std::memcmp(text.data(), cachedText_, secondsLength) == 0 &&
+            parseFraction(text.substr(secondsLength), nanos)) {
+            result = TimePoint(std::chrono::seconds(cachedSeconds_)) +
+                     std::chrono::duration_cast<TimePoint::duration>(std::chrono::nanoseconds(nanos));
+            return true;
+        }
+
+        std::int64_t localSeconds = 0;
+        if (parseFixed(text, localSeconds, nanos, secondsLength)) {
+            std::int64_t utcSeconds = localToUtc(localSeconds);
+            if (secondsLength <= sizeof(cachedText_)) {
+                std::memcpy(cachedText_, text.data(), secondsLength);
+                cachedLength_ = secondsLength;
+                cachedSeconds_ = utcSeconds;
+            }
+            result = TimePoint(std::chrono::seconds(utcSeconds)) +
+                     std::chrono::duration_cast<TimePoint::duration>(std::chrono::nanoseconds(nanos));
+            return true;
+        }
+
+        if (parseGeneric(text, localSeconds)) {
+            result = TimePoint(std::chrono::seconds(localToUtc(localSeconds)));
+            return true;
+        }
+
+        return false;
+    }
+
+    // 快速路径：定长布局的数字运算
+    bool TimestampParser::parseFixed(std::string_view text, std::int64_t& localSeconds,
+                                     std::int64_t& nanos, size_t& secondsLength) const {
+        const char* p = text.data();
+        unsigned century, yy, month, day, hour, minute, second;
+
+        // YYYY-MM-DD[ T]hh:mm:ss
+        if (text.size() >= 19 && p[4] == '-') {
+            if (!readTwoDigits(p, century) || !readTwoDigits(p + 2, yy) ||
+                p[7] != '-' || (p[10] != ' ' && p[10] != 'T') || p[13] != ':' || p[16] != ':' ||
+                !readTwoDigits(p + 5, month) || !readTwoDigits(p + 8, day) ||
+                !readTwoDigits(p + 11, hour) || !readTwoDigits(p + 14, minute) ||
+                !readTwoDigits(p + 17, second)) {
+                return false;
+            }
+            if (month < 1 || month > 12 || day < 1 || day > 31 || !validTime(hour, minute, second)) {
+                return false;
+            }
+            if (!parseFraction(text.substr(19), nanos)) {
+                return false;
+            }
+            secondsLength = 19;
+            localSeconds = civilSeconds(century * 100 + yy, month, day, hour, minute, second);
+            return true;
+        }
+
+        // Mon D hh:mm:ss / Mon DD hh:mm:ss（syslog 没有年份，与 std::get_time 一样按 1900 年处理）
+        if (text.size() == 14 || text.size() == 15) {
+            month = 0;
+            for (unsigned i = 0; i < 12; ++i) {
+                if (std::memcmp(p, MONTH_NAMES[i], 3) == 0) {
+                    month = i + 1;
+                    break;
+                }
+            }
+            if (month == 0 || p[3] != ' ' || !isDigit(p[4])) {
+                return false;
+            }
+            const char* t = p + 5;
+            day = static_cast<unsigned>(p[4] - '0');
+            if (text.size() == 15) {
+                if (!isDigit(p[5])) return false;
+                day = day * 10 + static_cast<unsigned>(p[5] - '0');
+                ++t;
+            }
+            if (t[0] != ' ' || t[3] != ':' || t[6] != ':' ||
+                !readTwoDigits(t + 1, hour) || !readTwoDigits(t + 4, minute) ||
+                !readTwoDigits(t + 7, second)) {
+                return false;
+            }
+            if (day < 1 || day > 31 || !validTime(hour, minute, second)) {
+                return false;
+            }
+            nanos = 0;
+            secondsLength = text.size();
+            localSeconds = civilSeconds(1900, month, day, hour, minute, second);
+            return true;
+        }
+
+        return false;
+    }
+
+    // 慢速路径：std::get_time（用于自定义模式产生的非常规时间戳）
+    bool TimestampParser::parseGeneric(std::string_view text, std::int64_t& localSeconds) const {
+        std::istringstream ss{std::string(text)};
+
+        for (const char* format : GENERIC_FORMATS) {
+            std::tm tm = {};
+            ss.clear();
+            ss.seekg(0);
+            ss >> std::get_time(&tm, format);
+            if (!ss.fail()) {
+                localSeconds = civilSeconds(tm.tm_year + 1900, static_cast<unsigned>(tm.tm_mon + 1),
+                                            static_cast<unsigned>(tm.tm_mday),
+                                            static_cast<unsigned>(tm.tm_hour),
+                                            static_cast<unsigned>(tm.tm_min),
+                                            static_cast<unsigned>(tm.tm_sec));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 本地时间转 UTC：每个本地小时只查询一次时区偏移
+    std::int64_t TimestampParser::localToUtc(std::int64_t localSeconds) {
+        std::int64_t hour = floorDiv(localSeconds, 3600);
+        if (hour != cachedHour_) {
+            std::tm tm = {};
+            std::time_t probe = static_cast<std::time_t>(localSeconds);
+            localtime_r(&probe, &tm);
+            probe = static_cast<std::time_t>(localSeconds - tm.tm_gmtoff);
+            localtime_r(&probe, &tm);
+            cachedOffset_ = tm.tm_gmtoff;
+            cachedHour_ = hour;
+        }
+        return localSeconds - cachedOffset_;
+    }
+
+} // namespace LogAnalyzer
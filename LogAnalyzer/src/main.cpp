@@ -5,86 +5,383 @@
 
 #include "LogEntry.h"
 #include "LogParser.h"
+#include "LogPipeline.h"
+#include "LogStore.h"
+#include "LogAggregator.h"
+#include "LevelKernels.h"
+#include "LogSketches.h"
+#include "PerformanceMonitor.h"
+#include "LogFollower.h"
+#include "LogWriter.h"
+#include "ReportWriter.h"
+#include "TimestampParser.h"
+#include "AllocationCounter.h"
+#include "StringPool.h"
 #include <iostream>
+#include <fstream>
 #include <vector>
+#include <array>
 #include <string>
-#include <map>
 #include <algorithm>
 #include <iomanip>
+#include <atomic>
+#include <csignal>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <ctime>
+#include <unistd.h>
 
 using namespace LogAnalyzer;
 
+// 跟踪模式的停止标志，由 SIGINT/SIGTERM 设置
+static std::atomic<bool> stopRequested(false);
+
+static void handleStopSignal(int) {
+    stopRequested = true;
+}
+
 /**
  * 显示使用帮助信息
  */
 void showHelp(const std::string& programName) {
     std::cout << "LogAnalyzer - C++ 日志分析工具\n"
-              << "用法: " << programName << " [选项] <日志文件...>\n\n"
+              << "用法: " << programName << " [选项] <日志文件...>\n"
+              << "      日志文件为 - 时从标准输入读取\n"
+              << "      gzip/zstd/lz4 压缩文件按文件头自动识别并边解压边解析；\n"
+              << "      标准输入不识别压缩格式，压缩数据需先解压再传入（如 zcat app.log.gz | " << programName << " -）\n\n"
               << "选项:\n"
               << "  -h, --help          显示此帮助信息\n"
               << "  -s, --stats         显示统计信息\n"
               << "  -l, --level <级别>  过滤指定级别的日志 (DEBUG|INFO|WARN|ERROR|FATAL)\n"
               << "  -f, --format        检测日志文件格式\n"
-              << "  -c, --count         统计各级别日志数量\n"
-              << "  -r, --recent <N>    显示最近的 N 条日志\n"
-              << "  -p, --pattern <正则> 添加自定义解析模式\n\n"
+              << "  -c, --count         统计各级别日志数量和条目最多的来源\n"
+              << "  -r, --recent <N>    显示最近的 N 条日志（从文件末尾反向读取）\n"
+              << "  -k, --search <关键词> 只分析消息包含关键词的日志 (空格分隔为 AND，| 分隔为 OR)\n"
+              << "  -m, --search-file <文件> 一次扫描匹配文件中的全部签名 (每行一个字面量)，按签名报告命中数\n"
+              << "  -a, --after <时间>  只分析不早于该时间的日志 (如 \"2024-11-01\" 或 \"2024-11-01 08:00:00\")\n"
+              << "  -b, --before <时间> 只分析早于该时间的日志\n"
+              << "  -F, --follow        持续跟踪文件新增的日志，支持日志轮转 (Ctrl-C 退出)\n"
+              << "  -p, --pattern <正则> 添加自定义解析模式\n"
+              << "  -j, --threads <N>   使用 N 个线程并行解析大文件 (0 表示全部核心)\n"
+              << "  -A, --aggregate     按时间桶统计各级别数量，报告 ERROR 及以上最多的来源和突增\n"
+              << "      --bucket <秒>   聚合时间桶宽度 (默认 60)\n"
+              << "      --top <N>       来源统计、聚合报告和近似统计中列出的条目数 (默认 10)\n"
+              << "      --sketch        以固定内存近似统计不同消息/模板/来源数和最常见的来源与消息模板\n"
+              << "                      (只统计通过级别、时间和关键词过滤的日志；指定 -m 时只含命中签名的行)\n"
+              << "      --hll-precision <P> 不同值计数的精度 4-18，误差约 1.04/sqrt(2^P) (默认 14)\n"
+              << "      --cms-error <ε> 频次估计的误差上限占总条数的比例 (默认 0.001)\n"
+              << "      --sketch-capacity <N> 高频项统计跟踪的候选数 (默认 256)\n"
+              << "  -T, --templates     挖掘消息模板 (如 \"user <*> logged in\")，按条目数列出最多的模板\n"
+              << "                      (统计范围同 --sketch)\n"
+              << "      --template-depth <N> 模板树按前 N 个词分支 (默认 2)\n"
+              << "      --template-similarity <S> 归入已有模板所需的相同词比例 0-1 (默认 0.4)\n"
+              << "      --performance   结束时输出各阶段耗时、吞吐量、峰值内存、堆分配和线程利用率\n"
+              << "      --performance-json <文件> 把性能报告以 JSON 写入文件 (- 表示标准输出)\n"
+              << "      --save-snapshot <文件> 把解析结果保存为二进制列式快照\n"
+              << "      --load-snapshot <文件> 从快照载入日志代替解析日志文件\n"
+              << "      --report <格式>  生成报告 (json|csv|html)：过滤后的日志条目，以及摘要和聚合结果 (CSV 只含条目)\n"
+              << "                      边解析边写出，内存占用与日志大小无关\n"
+              << "  -o, --output <文件> 报告的输出文件 (默认 - 表示标准输出，此时进度信息写到标准错误)\n\n"
               << "示例:\n"
               << "  " << programName << " app.log\n"
               << "  " << programName << " --stats --count app.log\n"
               << "  " << programName << " --level ERROR error.log\n"
+              << "  " << programName << " --follow --recent 20 app.log\n"
+              << "  " << programName << " --search \"database timeout|refused\" app.log\n"
+              << "  " << programName << " --search-file sigs.txt --level ERROR app.log\n"
+              << "  " << programName << " --after \"2024-11-01\" --before \"2024-11-02\" app.log\n"
+              << "  " << programName << " --aggregate --bucket 300 app.log\n"
+              << "  " << programName << " --sketch --hll-precision 16 --top 20 app-*.log\n"
+              << "  " << programName << " --templates --level ERROR -j 4 app.log\n"
+              << "  " << programName << " --count --performance --performance-json perf.json -j 4 big.log\n"
+              << "  " << programName << " --stats --save-snapshot day.snap app.log\n"
+              << "  " << programName << " --level ERROR --load-snapshot day.snap\n"
+              << "  " << programName << " --report html -o report.html --bucket 300 app.log\n"
+              << "  " << programName << " --report csv --level ERROR app.log.gz > errors.csv\n"
               << std::endl;
 }
 
 /**
- * 统计各级别日志数量
+ * 显示各级别日志数量
+ */
+void showLevelStatistics(const std::array<size_t, LOG_LEVEL_COUNT>& levelCounts, size_t total) {
+    std::cout << "\n=== 日志级别统计 ===\n";
+    for (size_t level = 0; level < levelCounts.size(); ++level) {
+        if (levelCounts[level] == 0) {
+            continue;
+        }
+        std::cout << std::left << std::setw(8) << logLevelToString(static_cast<LogLevel>(level)) 
+                  << ": " << levelCounts[level] << " 条\n";
+    }
+    std::cout << "总计: " << total << " 条\n";
+}
+
+/**
+ * 按条目数从多到少显示前 topCount 个来源
  */
-void showLevelStatistics(const std::vector<LogEntry>& entries) {
-    std::map<LogLevel, size_t> levelCounts;
+void showSourceStatistics(const std::unordered_map<std::uint32_t, size_t>& sourceCounts, size_t topCount) {
+    std::vector<std::pair<std::uint32_t, size_t>> sources(sourceCounts.begin(), sourceCounts.end());
+    auto more = [](const std::pair<std::uint32_t, size_t>& a, const std::pair<std::uint32_t, size_t>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    size_t shown = std::min(topCount, sources.size());
+    std::partial_sort(sources.begin(), sources.begin() + static_cast<std::ptrdiff_t>(shown), sources.end(), more);
     
-    for (const auto& entry : entries) {
-        levelCounts[entry.getLevel()]++;
+    std::cout << "\n=== 来源统计（共 " << sources.size() << " 个来源）===\n";
+    for (size_t i = 0; i < shown; ++i) {
+        const std::string& name = SourceTable::name(sources[i].first);
+        std::cout << std::right << std::setw(10) << sources[i].second << " 条  "
+                  << (name.empty() ? "(无来源)" : name) << "\n";
     }
+}
+
+/**
+ * 统计各级别和各来源的日志数量（只扫描级别列和来源列）
+ */
+void showLevelStatistics(const LogStore& store, size_t topCount) {
+    showLevelStatistics(store.countByLevel(), store.size());
+    showSourceStatistics(store.countBySource(), topCount);
+}
+
+/**
+ * 按命中行数从多到少显示每个签名的命中情况
+ */
+void showSignatureHits(const MultiPatternMatcher& matcher, const std::vector<size_t>& hitCounts) {
+    std::vector<size_t> order(matcher.patternCount());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&hitCounts](size_t a, size_t b) {
+        return hitCounts[a] > hitCounts[b];
+    });
     
-    std::cout << "\n=== 日志级别统计 ===\n";
-    for (const auto& pair : levelCounts) {
-        std::cout << std::left << std::setw(8) << logLevelToString(pair.first) 
-                  << ": " << pair.second << " 条\n";
+    std::cout << "\n=== 签名命中统计 ===\n";
+    size_t missed = 0;
+    for (size_t pattern : order) {
+        if (hitCounts[pattern] == 0) {
+            ++missed;
+            continue;
+        }
+        std::cout << std::right << std::setw(8) << hitCounts[pattern] << " 条  "
+                  << matcher.getPatterns()[pattern] << "\n";
     }
-    std::cout << "总计: " << entries.size() << " 条\n";
+    std::cout << "未命中的签名: " << missed << " 个\n";
 }
 
 /**
- * 根据级别过滤日志
+ * 显示解析阶段的堆分配次数
  */
-std::vector<LogEntry> filterByLevel(const std::vector<LogEntry>& entries, LogLevel level) {
-    std::vector<LogEntry> filtered;
-    std::copy_if(entries.begin(), entries.end(), std::back_inserter(filtered),
-                 [level](const LogEntry& entry) {
-                     return entry.getLevel() == level;
-                 });
-    return filtered;
+void showAllocationStats(std::uint64_t allocations, size_t lines) {
+    std::cout << "解析期间堆分配: " << allocations << " 次";
+    if (lines > 0) {
+        std::cout << "（每百万行 " << std::fixed << std::setprecision(1)
+                  << static_cast<double>(allocations) * 1e6 / static_cast<double>(lines) << " 次）";
+    }
+    std::cout << "\n";
 }
 
 /**
- * 显示最近的 N 条日志
+ * 格式化时间桶的起始时间（本地时间）
  */
-void showRecentLogs(const std::vector<LogEntry>& entries, size_t count) {
-    size_t startIndex = entries.size() > count ? entries.size() - count : 0;
+std::string formatBucketTime(const std::chrono::system_clock::time_point& time) {
+    std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    std::tm tm = {};
+    localtime_r(&seconds, &tm);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+    return buffer;
+}
+
+/**
+ * 显示聚合报告：时间线、ERROR 及以上最多的来源、突增
+ */
+void showAggregation(const LogAggregator& aggregator, size_t topCount) {
+    constexpr size_t SPIKE_WINDOW = LogAggregator::DEFAULT_SPIKE_WINDOW;
+    constexpr double SPIKE_THRESHOLD = LogAggregator::DEFAULT_SPIKE_THRESHOLD;
+    
+    std::cout << "\n=== 聚合报告（时间桶 " << aggregator.bucketWidth().count() << " 秒，"
+              << aggregator.groupCount() << " 个分组）===\n";
     
-    std::cout << "\n=== 最近 " << (entries.size() - startIndex) << " 条日志 ===\n";
-    for (size_t i = startIndex; i < entries.size(); ++i) {
-        std::cout << entries[i] << "\n";
+    std::cout << "\n时间线:\n" << std::left << std::setw(23) << "时间";
+    for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+        std::cout << std::right << std::setw(9) << logLevelToString(static_cast<LogLevel>(level));
+    }
+    std::cout << "\n";
+    for (const auto& bucket : aggregator.timeline()) {
+        std::cout << std::left << std::setw(21) << formatBucketTime(aggregator.bucketStart(bucket.bucket));
+        for (std::uint64_t count : bucket.counts) {
+            std::cout << std::right << std::setw(9) << count;
+        }
+        std::cout << "\n";
+    }
+    
+    std::cout << "\nERROR 及以上最多的来源:\n";
+    auto sources = aggregator.topSources(LogLevel::ERROR, topCount);
+    if (sources.empty()) {
+        std::cout << "  无\n";
+    }
+    for (const auto& source : sources) {
+        std::cout << std::right << std::setw(10) << source.second << " 条  " << SourceTable::name(source.first) << "\n";
+    }
+    
+    std::cout << "\nERROR 及以上的突增（与前 " << SPIKE_WINDOW << " 个桶相比超过 "
+              << std::fixed << std::setprecision(1) << SPIKE_THRESHOLD << " 倍标准差）:\n";
+    auto spikes = aggregator.findSpikes(LogLevel::ERROR, SPIKE_WINDOW, SPIKE_THRESHOLD);
+    if (spikes.empty()) {
+        std::cout << "  无\n";
+    }
+    for (const auto& spike : spikes) {
+        std::cout << "  " << formatBucketTime(aggregator.bucketStart(spike.bucket)) << "  " << spike.count
+                  << " 条（基线 " << spike.baseline << "，" << spike.score << " 倍标准差）\n";
     }
 }
 
 /**
- * 显示所有日志条目
+ * 显示近似统计：不同值个数和高频项
  */
-void showAllLogs(const std::vector<LogEntry>& entries) {
-    std::cout << "\n=== 所有日志条目 ===\n";
-    for (const auto& entry : entries) {
-        std::cout << entry << "\n";
+void showSketches(const LogSketches& sketches, size_t topCount) {
+    const auto& options = sketches.options();
+    std::cout << "\n=== 近似统计（" << sketches.entries() << " 条，草图共 "
+              << (sketches.memoryBytes() + 1023) / 1024 << " KB）===\n";
+    
+    std::cout << std::fixed << std::setprecision(0)
+              << "不同消息数: 约 " << sketches.distinctMessages() << "\n"
+              << "不同消息模板数: 约 " << sketches.distinctTemplates() << "\n"
+              << "不同来源数: 约 " << sketches.distinctSources() << "\n"
+              << std::setprecision(2) << "  (HyperLogLog 精度 " << options.hllPrecision << "，相对误差约 "
+              << sketches.distinctError() * 100.0 << "%)\n";
+    
+    auto showHitters = [&](const char* title, const std::vector<LogSketches::HeavyHitter>& hitters) {
+        std::cout << "\n" << title << ":\n";
+        for (const auto& hitter : hitters) {
+            std::cout << std::right << std::setw(10) << hitter.estimate << " 条";
+            if (hitter.lowerBound != hitter.estimate) {
+                std::cout << "（至少 " << hitter.lowerBound << "）";
+            }
+            std::cout << "  " << hitter.label << "\n";
+        }
+    };
+    showHitters("最常见的来源", sketches.topSources(topCount));
+    showHitters("最常见的消息模板", sketches.topTemplates(topCount));
+    std::cout << "  (计数为上界，超出真实值不超过 " << sketches.frequencyErrorBound() << " 条；Count-Min ε="
+              << std::setprecision(4) << options.cmsError << "，Space-Saving 候选 " << options.capacity << " 个)\n";
+}
+
+/**
+ * 显示条目数最多的消息模板及示例
+ */
+void showMessageTemplates(const TemplateMiner& miner, size_t topCount) {
+    auto templates = miner.templates();
+    std::cout << "\n=== 消息模板（" << templates.size() << " 个，共 " << miner.total() << " 条）===\n";
+    for (size_t i = 0; i < templates.size() && i < topCount; ++i) {
+        double percentage = miner.total() > 0 ? templates[i].count * 100.0 / miner.total() : 0.0;
+        std::cout << std::right << std::setw(10) << templates[i].count << " 条 " << std::setw(6) << std::fixed
+                  << std::setprecision(2) << percentage << "%  "
+                  << (templates[i].text.empty() ? "(空消息)" : templates[i].text) << "\n"
+                  << std::setw(22) << "" << "例: " << templates[i].example << "\n";
+    }
+}
+
+/**
+ * 显示快照载入耗时与堆分配次数
+ */
+void showSnapshotStats(const std::string& filename, size_t entries, double milliseconds, std::uint64_t allocations) {
+    std::cout << "快照: " << filename << "\n"
+              << "  条目数: " << entries << "\n"
+              << "  载入耗时: " << std::fixed << std::setprecision(2) << milliseconds << " 毫秒\n"
+              << "  载入期间堆分配: " << allocations << " 次\n";
+}
+
+/**
+ * 在快照中选出满足时间范围、关键词、签名和级别条件的行
+ * 快照不保存原始行，签名在来源和消息中查找；签名命中数只统计最终保留的行
+ */
+LogStore filterSnapshot(const LogStore& store, bool hasTimeRange,
+                        const std::chrono::system_clock::time_point& afterTime,
+                        const std::chrono::system_clock::time_point& beforeTime,
+                        const KeywordQuery* query, const MultiPatternMatcher* matcher,
+                        const LogLevel* level, std::vector<size_t>& signatureHits) {
+    if (!hasTimeRange && !query && !matcher) {
+        return level ? store.select(store.selectByLevel(*level)) : store;
     }
+    
+    std::vector<size_t> candidates;
+    if (hasTimeRange) {
+        candidates = store.selectTimeRange(afterTime, beforeTime);
+    } else {
+        candidates.resize(store.size());
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            candidates[i] = i;
+        }
+    }
+    
+    // 来源种类很少，每个来源命中的签名只计算一次
+    std::unordered_map<std::uint32_t, std::vector<size_t>> sourcePatterns;
+    auto collect = [](std::vector<size_t>& patterns) {
+        return [&patterns](size_t pattern, size_t) {
+            if (std::find(patterns.begin(), patterns.end(), pattern) == patterns.end()) {
+                patterns.push_back(pattern);
+            }
+        };
+    };
+    
+    std::vector<size_t> selected;
+    std::vector<size_t> linePatterns;
+    for (size_t i : candidates) {
+        if (level && store.levelAt(i) != *level) {
+            continue;
+        }
+        if (query && !query->matches(store.messageAt(i))) {
+            continue;
+        }
+        if (matcher) {
+            auto source = sourcePatterns.find(store.sourceIdAt(i));
+            if (source == sourcePatterns.end()) {
+                source = sourcePatterns.emplace(store.sourceIdAt(i), std::vector<size_t>()).first;
+                matcher->scan(SourceTable::name(store.sourceIdAt(i)), collect(source->second));
+            }
+            linePatterns = source->second;
+            matcher->scan(store.messageAt(i), collect(linePatterns));
+            if (linePatterns.empty()) {
+                continue;
+            }
+            for (size_t pattern : linePatterns) {
+                signatureHits[pattern]++;
+            }
+        }
+        selected.push_back(i);
+    }
+    return store.select(selected);
+}
+
+/**
+ * 根据级别过滤日志（只扫描级别列选出行号，再抽取选中的行）
+ */
+LogStore filterByLevel(const LogStore& store, LogLevel level) {
+    return store.select(store.selectByLevel(level));
+}
+
+/**
+ * 显示最近的 N 条日志（经 LogWriter 批量写出）
+ */
+void showRecentLogs(const LogStore& store, size_t count) {
+    size_t startIndex = store.size() > count ? store.size() - count : 0;
+    
+    std::cout << "\n=== 最近 " << (store.size() - startIndex) << " 条日志 ===" << std::endl;
+    LogWriter writer(STDOUT_FILENO);
+    writer.writeRange(store, startIndex, store.size());
+    writer.flush();
+}
+
+/**
+ * 显示所有日志条目（经 LogWriter 批量写出）
+ */
+void showAllLogs(const LogStore& store) {
+    std::cout << "\n=== 所有日志条目 ===" << std::endl;
+    LogWriter writer(STDOUT_FILENO);
+    writer.writeRange(store, 0, store.size());
+    writer.flush();
 }
 
 /**
@@ -99,6 +396,62 @@ void showFormatInfo(const std::vector<std::string>& filenames) {
     }
 }
 
+/**
+ * 跟踪模式：先显示最近 N 条，再持续输出新追加的日志直到收到中断信号
+ */
+int followLogs(LogParser& parser, const std::vector<std::string>& filenames,
+               size_t recentCount, const EntryFilter& filter, bool showStats) {
+    for (const auto& filename : filenames) {
+        if (filename == "-") {
+            std::cerr << "错误: --follow 不支持标准输入\n";
+            return 1;
+        }
+    }
+    
+    if (recentCount > 0) {
+        showRecentLogs(LogStore::fromEntries(parser.parseFilesTail(filenames, recentCount, filter)),
+                       recentCount);
+    }
+    
+    LogFollower follower(parser);
+    for (const auto& filename : filenames) {
+        if (!follower.addFile(filename)) {
+            std::cerr << "警告: 文件 " << filename << " 暂时无法打开，等待其出现\n";
+        }
+    }
+    
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    
+    // 新行经 LogWriter 渲染，每轮读完所有文件后刷新一次，而不是逐行刷新 std::cout
+    std::cout << "\n=== 跟踪新日志 (Ctrl-C 退出) ===" << std::endl;
+    {
+        LogWriter writer(STDOUT_FILENO);
+        follower.run([&filter, &writer](const LogEntry& entry) {
+            if (!filter || filter(entry)) {
+                writer.writeEntry(entry);
+            }
+        }, stopRequested, [&writer]() {
+            writer.flush();
+        });
+        writer.flush();
+    }
+    
+    if (showStats) {
+        std::cout << "\n" << parser.getStatsReport() << "\n";
+    }
+    return 0;
+}
+
+/**
+ * 解析 --after / --before 的时间参数，只给日期时表示当天零点
+ */
+bool parseTimeArgument(const std::string& text, std::chrono::system_clock::time_point& result) {
+    TimestampParser timestampParser;
+    std::string value = text.size() == 10 ? text + " 00:00:00" : text;
+    return timestampParser.parse(value, result);
+}
+
 /**
  * 主函数
  */
@@ -113,9 +466,31 @@ int main(int argc, char* argv[]) {
     bool showStats = false;
     bool showCount = false;
     bool showFormat = false;
+    bool showAggregate = false;
+    unsigned bucketSeconds = 60;
+    size_t topCount = 10;
+    bool showSketch = false;
+    SketchOptions sketchOptions;
+    bool showTemplates = false;
+    bool showPerformance = false;
+    std::string performanceJsonFile;
+    TemplateMinerOptions templateOptions;
     LogLevel filterLevel = LogLevel::INFO;
     bool hasLevelFilter = false;
     size_t recentCount = 0;
+    bool follow = false;
+    auto afterTime = std::chrono::system_clock::time_point::min();
+    auto beforeTime = std::chrono::system_clock::time_point::max();
+    bool hasTimeRange = false;
+    std::string searchText;
+    bool hasSearch = false;
+    std::string signatureFile;
+    std::string saveSnapshotFile;
+    std::string loadSnapshotFile;
+    bool hasReport = false;
+    ReportFormat reportFormat = ReportFormat::JSON;
+    std::string reportFile = "-";
+    unsigned threadCount = 1;
     std::vector<std::string> customPatterns;
     
     for (int i = 1; i < argc; ++i) {
@@ -152,6 +527,145 @@ int main(int argc, char* argv[]) {
                 std::cerr << "错误: --recent 需要一个参数\n";
                 return 1;
             }
+        } else if (arg == "-a" || arg == "--after" || arg == "-b" || arg == "--before") {
+            bool isAfter = arg == "-a" || arg == "--after";
+            const char* optionName = isAfter ? "--after" : "--before";
+            if (i + 1 < argc) {
+                if (!parseTimeArgument(argv[++i], isAfter ? afterTime : beforeTime)) {
+                    std::cerr << "错误: " << optionName << " 需要一个有效的时间参数\n";
+                    return 1;
+                }
+                hasTimeRange = true;
+            } else {
+                std::cerr << "错误: " << optionName << " 需要一个参数\n";
+                return 1;
+            }
+        } else if (arg == "-k" || arg == "--search") {
+            if (i + 1 < argc) {
+                searchText = argv[++i];
+                hasSearch = true;
+            } else {
+                std::cerr << "错误: --search 需要一个参数\n";
+                return 1;
+            }
+        } else if (arg == "-m" || arg == "--search-file") {
+            if (i + 1 < argc) {
+                signatureFile = argv[++i];
+            } else {
+                std::cerr << "错误: --search-file 需要一个参数\n";
+                return 1;
+            }
+        } else if (arg == "--save-snapshot" || arg == "--load-snapshot") {
+            if (i + 1 < argc) {
+                (arg == "--save-snapshot" ? saveSnapshotFile : loadSnapshotFile) = argv[++i];
+            } else {
+                std::cerr << "错误: " << arg << " 需要一个参数\n";
+                return 1;
+            }
+        } else if (arg == "-A" || arg == "--aggregate") {
+            showAggregate = true;
+        } else if (arg == "--bucket" || arg == "--top") {
+            if (i + 1 < argc) {
+                try {
+                    unsigned long value = std::stoul(argv[++i]);
+                    if (value == 0) {
+                        throw std::invalid_argument(arg);
+                    }
+                    if (arg == "--bucket") {
+                        bucketSeconds = static_cast<unsigned>(value);
+                    } else {
+                        topCount = value;
+                    }
+                } catch (const std::exception&) {
+                    std::cerr << "错误: " << arg << " 需要一个正整数参数\n";
+                    return 1;
+                }
+            } else {
+                std::cerr << "错误: " << arg << " 需要一个参数\n";
+                return 1;
+            }
+        } else if (arg == "--sketch") {
+            showSketch = true;
+        } else if (arg == "--hll-precision" || arg == "--cms-error" || arg == "--sketch-capacity") {
+            if (i + 1 < argc) {
+                try {
+                    std::string value = argv[++i];
+                    if (arg == "--hll-precision") {
+                        sketchOptions.hllPrecision = static_cast<unsigned>(std::stoul(value));
+                    } else if (arg == "--cms-error") {
+                        sketchOptions.cmsError = std::stod(value);
+                    } else {
+                        sketchOptions.capacity = std::stoul(value);
+                    }
+                    LogSketches validate(sketchOptions);
+                } catch (const std::exception&) {
+                    std::cerr << "错误: " << arg << " 的参数无效\n";
+                    return 1;
+                }
+                showSketch = true;
+            } else {
+                std::cerr << "错误: " << arg << " 需要一个参数\n";
+                return 1;
+            }
+        } else if (arg == "-T" || arg == "--templates") {
+            showTemplates = true;
+        } else if (arg == "--template-depth" || arg == "--template-similarity") {
+            if (i + 1 < argc) {
+                try {
+                    std::string value = argv[++i];
+                    if (arg == "--template-depth") {
+                        templateOptions.prefixTokens = std::stoul(value);
+                    } else {
+                        templateOptions.similarity = std::stod(value);
+                    }
+                    TemplateMiner validate(templateOptions);
+                } catch (const std::exception&) {
+                    std::cerr << "错误: " << arg << " 的参数无效\n";
+                    return 1;
+                }
+                showTemplates = true;
+            } else {
+                std::cerr << "错误: " << arg << " 需要一个参数\n";
+                return 1;
+            }
+        } else if (arg == "--performance") {
+            showPerformance = true;
+        } else if (arg == "--performance-json") {
+            if (i + 1 < argc) {
+                performanceJsonFile = argv[++i];
+            } else {
+                std::cerr << "错误: --performance-json 需要一个参数\n";
+                return 1;
+            }
+        } else if (arg == "--report") {
+            if (i + 1 < argc && ReportWriter::parseFormat(argv[i + 1], reportFormat)) {
+                hasReport = true;
+                ++i;
+            } else {
+                std::cerr << "错误: --report 需要一个参数 (json|csv|html)\n";
+                return 1;
+            }
+        } else if (arg == "-o" || arg == "--output") {
+            if (i + 1 < argc) {
+                reportFile = argv[++i];
+            } else {
+                std::cerr << "错误: --output 需要一个参数\n";
+                return 1;
+            }
+        } else if (arg == "-F" || arg == "--follow") {
+            follow = true;
+        } else if (arg == "-j" || arg == "--threads") {
+            if (i + 1 < argc) {
+                try {
+                    threadCount = static_cast<unsigned>(std::stoul(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "错误: --threads 需要一个有效的数字参数\n";
+                    return 1;
+                }
+            } else {
+                std::cerr << "错误: --threads 需要一个参数\n";
+                return 1;
+            }
         } else if (arg == "-p" || arg == "--pattern") {
             if (i + 1 < argc) {
                 customPatterns.push_back(argv[++i]);
@@ -159,7 +673,7 @@ int main(int argc, char* argv[]) {
                 std::cerr << "错误: --pattern 需要一个参数\n";
                 return 1;
             }
-        } else if (arg[0] != '-') {
+        } else if (arg == "-" || arg[0] != '-') {
             filenames.push_back(arg);
         } else {
             std::cerr << "错误: 未知选项 " << arg << "\n";
@@ -168,12 +682,33 @@ int main(int argc, char* argv[]) {
         }
     }
     
-    if (filenames.empty()) {
+    if (!loadSnapshotFile.empty()) {
+        if (!filenames.empty() || follow || showFormat) {
+            std::cerr << "错误: --load-snapshot 不能与日志文件、--follow 或 --format 同时使用\n";
+            return 1;
+        }
+    } else if (filenames.empty()) {
         std::cerr << "错误: 请提供至少一个日志文件\n";
         showHelp(argv[0]);
         return 1;
     }
     
+    if (hasReport) {
+        if (follow || recentCount > 0 || showCount || showAggregate || showSketch || showTemplates ||
+            !saveSnapshotFile.empty() || !signatureFile.empty()) {
+            std::cerr << "错误: --report 不能与 --follow、--recent、--count、--aggregate、--sketch、--templates、"
+                      << "--save-snapshot 或 --search-file 同时使用\n";
+            return 1;
+        }
+        // 报告占用标准输出时，进度和统计信息改写到标准错误
+        if (reportFile == "-") {
+            std::cout.rdbuf(std::cerr.rdbuf());
+        }
+    } else if (reportFile != "-") {
+        std::cerr << "错误: --output 需要与 --report 同时使用\n";
+        return 1;
+    }
+    
     // 如果只需要格式检测，直接执行并返回
     if (showFormat) {
         showFormatInfo(filenames);
@@ -181,53 +716,463 @@ int main(int argc, char* argv[]) {
     }
     
     try {
+        // 性能统计从这里开始计时
+        const bool profiling = showPerformance || !performanceJsonFile.empty();
+        if (profiling) {
+            if (follow) {
+                std::cerr << "错误: --performance 不能与 --follow 同时使用\n";
+                return 1;
+            }
+            PerformanceMonitor::enable();
+        }
+        const std::uint64_t allocationsAtStart = AllocationCounter::count();
+        const std::uint64_t allocatedBytesAtStart = AllocationCounter::bytes();
+        auto reportPerformance = [&]() {
+            if (!profiling) {
+                return;
+            }
+            std::uint64_t allocations = AllocationCounter::count() - allocationsAtStart;
+            std::uint64_t allocatedBytes = AllocationCounter::bytes() - allocatedBytesAtStart;
+            if (showPerformance) {
+                std::cout << "\n" << PerformanceMonitor::textReport(allocations, allocatedBytes);
+            }
+            if (performanceJsonFile == "-") {
+                std::cout << PerformanceMonitor::jsonReport(allocations, allocatedBytes) << std::endl;
+            } else if (!performanceJsonFile.empty()) {
+                std::ofstream json(performanceJsonFile);
+                json << PerformanceMonitor::jsonReport(allocations, allocatedBytes) << "\n";
+                if (!json) {
+                    std::cerr << "警告: 无法写入性能报告: " << performanceJsonFile << "\n";
+                }
+            }
+        };
+        
         // 创建解析器并添加自定义模式
         LogParser parser;
+        parser.setThreadCount(threadCount);
         for (const auto& pattern : customPatterns) {
             if (!parser.addCustomPattern(pattern)) {
                 std::cerr << "警告: 添加自定义模式失败: " << pattern << "\n";
             }
         }
         
-        std::cout << "正在解析日志文件...\n";
+        KeywordQuery query(searchText);
+        if (hasSearch && query.empty()) {
+            std::cerr << "错误: --search 需要至少一个关键词\n";
+            return 1;
+        }
+        
+        std::unique_ptr<MultiPatternMatcher> matcher;
+        if (!signatureFile.empty()) {
+            matcher = std::make_unique<MultiPatternMatcher>(MultiPatternMatcher::fromFile(signatureFile));
+            if (matcher->patternCount() == 0) {
+                std::cerr << "错误: 签名文件中没有签名: " << signatureFile << "\n";
+                return 1;
+            }
+        }
+        
+        // 过滤条件组成流水线的过滤阶段；逐条处理的路径（跟踪、末尾读取、索引查询）使用组合后的谓词
+        LogPipeline pipeline(parser);
+        if (hasLevelFilter) {
+            pipeline.addFilter(FilterStage::level(filterLevel));
+        }
+        if (hasTimeRange) {
+            pipeline.addFilter(FilterStage::timeRange(afterTime, beforeTime));
+        }
+        if (hasSearch) {
+            pipeline.addFilter(FilterStage::keyword(query));
+        }
+        EntryFilter entryFilter = pipeline.entryFilter();
+        
+        // 字段投影：只统计时不解码用不到的字段
+        bool showsReport = showStats || showCount || showAggregate || showSketch || showTemplates;
+        bool observesParse = showSketch || showTemplates;
+        bool printsEntries = follow || recentCount > 0 || !showsReport;
+        unsigned fields = FIELD_LEVEL;
+        if (printsEntries || hasTimeRange || showAggregate) {
+            fields |= FIELD_TIMESTAMP;
+        }
+        if (printsEntries || showCount || showAggregate || showSketch) {
+            fields |= FIELD_SOURCE;
+        }
+        if (printsEntries || hasSearch || observesParse) {
+            fields |= FIELD_MESSAGE;
+        }
+        if (hasReport || !saveSnapshotFile.empty()) {
+            fields = FIELD_ALL;
+        }
+        parser.setFieldMask(fields);
+        if (showSketch) {
+            parser.enableSketches(sketchOptions);
+        }
+        if (showTemplates) {
+            parser.enableTemplateMining(templateOptions);
+        }
+        if (observesParse) {
+            parser.setObserveFilter(entryFilter);
+        }
+        
+        // 跟踪模式：不会一次性载入整个文件
+        if (follow) {
+            if (matcher || !saveSnapshotFile.empty() || observesParse) {
+                std::cerr << "错误: --search-file、--save-snapshot、--sketch 和 --templates 不能与 --follow 同时使用\n";
+                return 1;
+            }
+            return followLogs(parser, filenames, recentCount, entryFilter, showStats);
+        }
+        
+        // 报告：逐条解析、过滤后直接写出并计入聚合，不保存条目
+        if (hasReport && loadSnapshotFile.empty()) {
+            std::cout << "正在生成报告...\n";
+            ReportWriter report(reportFormat, reportFile, filenames);
+            LogAggregator aggregation{std::chrono::seconds(bucketSeconds)};
+            report.begin();
+            pipeline.addSink([&](const std::vector<LogEntry>& batch) {
+                for (const auto& entry : batch) {
+                    report.writeEntry(entry);
+                }
+            });
+            pipeline.addSink([&](const std::vector<LogEntry>& batch) {
+                aggregation.addBatch(batch);
+            });
+            pipeline.run(filenames);
+            report.summary().totalLines = parser.getTotalLines();
+            report.summary().errorLines = parser.getErrorLines();
+            {
+                PerformanceMonitor::Timer timer(Stage::OUTPUT, 0, report.summary().entries);
+                report.finish(&aggregation, topCount);
+            }
+            std::cout << "已写出 " << report.summary().entries << " 条日志条目到报告"
+                      << (reportFile == "-" ? "" : " " + reportFile) << "\n";
+            if (showStats) {
+                std::cout << "\n" << parser.getStatsReport() << "\n";
+            }
+            reportPerformance();
+            return 0;
+        }
+        
+        // 只显示统计、计数、聚合、近似统计和模板时按批流过流水线，不保存条目，内存只与批次大小有关
+        // （多线程时各窗口分块并行解析），关键词和时间范围由流水线的过滤阶段逐批检查；
+        // 例外是不做近似统计和模板、且全部输入都能建立索引时，关键词和时间范围查询走持久化索引，
+        // 只解析相关的行，仍使用下面的路径
+        const bool usesIndex = (hasSearch || hasTimeRange) && !observesParse &&
+                               std::all_of(filenames.begin(), filenames.end(), LogParser::supportsIndex);
+        const bool summaryOnly = showsReport && recentCount == 0 && !matcher && !usesIndex &&
+                                 saveSnapshotFile.empty() && loadSnapshotFile.empty();
+        if (summaryOnly) {
+            std::cout << "正在解析日志文件...\n";
+            std::array<size_t, LOG_LEVEL_COUNT> levelCounts{};
+            std::unordered_map<std::uint32_t, size_t> sourceCounts;
+            std::unique_ptr<LogAggregator> aggregation;
+            if (showAggregate) {
+                aggregation = std::make_unique<LogAggregator>(std::chrono::seconds(bucketSeconds));
+            }
+            // 每批先把级别收集成连续的字节，再交给 SIMD 直方图内核
+            std::vector<std::uint8_t> batchLevels;
+            pipeline.addSink([&](const std::vector<LogEntry>& batch) {
+                batchLevels.resize(batch.size());
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    batchLevels[i] = static_cast<std::uint8_t>(batch[i].getLevel());
+                }
+                auto histogram = levelHistogram(batchLevels.data(), batchLevels.size());
+                for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+                    levelCounts[level] += histogram[level];
+                }
+            });
+            if (showCount) {
+                pipeline.addSink([&](const std::vector<LogEntry>& batch) {
+                    for (const auto& entry : batch) {
+                        ++sourceCounts[entry.getSourceId()];
+                    }
+                });
+            }
+            if (aggregation) {
+                pipeline.addSink([&](const std::vector<LogEntry>& batch) {
+                    aggregation->addBatch(batch);
+                });
+            }
+            std::uint64_t allocationsBefore = AllocationCounter::count();
+            pipeline.run(filenames);
+            std::uint64_t pipelineAllocations = AllocationCounter::count() - allocationsBefore;
+            
+            auto showParseStats = [&]() {
+                std::cout << "\n" << parser.getStatsReport() << "\n";
+                showAllocationStats(pipelineAllocations, parser.getTotalLines());
+            };
+            if (pipeline.parsedEntries() == 0) {
+                std::cout << "未找到有效的日志条目\n";
+                if (showStats) {
+                    showParseStats();
+                }
+                reportPerformance();
+                return 0;
+            }
+            std::cout << "成功解析 " << pipeline.parsedEntries() << " 条日志条目\n";
+            if (pipeline.hasFilters()) {
+                std::cout << (hasSearch || hasTimeRange ? "过滤后剩余 " : "级别过滤后剩余 ")
+                          << pipeline.passedEntries() << " 条日志条目\n";
+            }
+            
+            PerformanceMonitor::Timer outputTimer(Stage::OUTPUT);
+            if (showStats) {
+                showParseStats();
+            }
+            if (showCount) {
+                showLevelStatistics(levelCounts, pipeline.passedEntries());
+                showSourceStatistics(sourceCounts, topCount);
+            }
+            if (aggregation) {
+                showAggregation(*aggregation, topCount);
+            }
+            if (showSketch) {
+                showSketches(*parser.getSketches(), topCount);
+            }
+            if (showTemplates) {
+                showMessageTemplates(*parser.getTemplateMiner(), topCount);
+            }
+            std::cout.flush();
+            outputTimer.stop();
+            reportPerformance();
+            return 0;
+        }
         
-        // 解析所有文件
-        auto entries = parser.parseFiles(filenames);
+        // 列出条目（可带级别、关键词和时间过滤）时同样按批流过流水线，由 LogWriter 直接写出，不保存条目。
+        // 流水线按文件内的原始顺序交付，不做跨文件的时间归并，因此只用于单个输入；
+        // 多个文件、末尾读取、签名扫描、可走索引的查询和快照仍使用下面先解析再转为列式存储的路径
+        const bool streamsListing = !showsReport && recentCount == 0 && !matcher && !usesIndex &&
+                                    saveSnapshotFile.empty() && loadSnapshotFile.empty() && filenames.size() == 1;
+        if (streamsListing) {
+            std::cout << "正在解析日志文件...\n";
+            std::unique_ptr<LogWriter> writer;
+            pipeline.addSink([&](const std::vector<LogEntry>& batch) {
+                PerformanceMonitor::Timer timer(Stage::OUTPUT, 0, batch.size());
+                if (!writer) {
+                    std::cout << "\n=== 所有日志条目 ===" << std::endl;
+                    writer = std::make_unique<LogWriter>(STDOUT_FILENO);
+                }
+                for (const auto& entry : batch) {
+                    writer->writeEntry(entry);
+                }
+            });
+            pipeline.run(filenames);
+            if (writer) {
+                PerformanceMonitor::Timer timer(Stage::OUTPUT);
+                writer->flush();
+                writer.reset();
+            }
+            
+            if (pipeline.parsedEntries() == 0) {
+                std::cout << "未找到有效的日志条目\n";
+            } else {
+                std::cout << "\n成功解析 " << pipeline.parsedEntries() << " 条日志条目\n";
+                if (pipeline.hasFilters()) {
+                    std::cout << (hasSearch || hasTimeRange ? "过滤后剩余 " : "级别过滤后剩余 ")
+                              << pipeline.passedEntries() << " 条日志条目\n";
+                }
+            }
+            std::cout.flush();
+            reportPerformance();
+            return 0;
+        }
+        
+        std::vector<size_t> signatureHits(matcher ? matcher->patternCount() : 0, 0);
+        LogStore entries;
+        std::unique_ptr<LogSketches> snapshotSketches;
+        std::unique_ptr<TemplateMiner> snapshotTemplates;
+        std::uint64_t loadAllocations = 0;
+        double loadMilliseconds = 0.0;
+        size_t snapshotRows = 0;
+        
+        if (!loadSnapshotFile.empty()) {
+            // 快照各列直接映射，只对需要的行做过滤
+            std::cout << "正在载入快照...\n";
+            std::uint64_t allocationsBefore = AllocationCounter::count();
+            auto loadStart = std::chrono::steady_clock::now();
+            {
+                PerformanceMonitor::Timer timer(Stage::READ);
+                entries = LogStore::loadSnapshot(loadSnapshotFile);
+                timer.setVolume(entries.messageData().size(), entries.size());
+            }
+            snapshotRows = entries.size();
+            loadMilliseconds = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - loadStart).count();
+            loadAllocations = AllocationCounter::count() - allocationsBefore;
+            PerformanceMonitor::Timer filterTimer(Stage::FILTER, 0, entries.size());
+            entries = filterSnapshot(entries, hasTimeRange, afterTime, beforeTime,
+                                     hasSearch ? &query : nullptr, matcher.get(),
+                                     hasLevelFilter ? &filterLevel : nullptr, signatureHits);
+        } else {
+            std::cout << "正在解析日志文件...\n";
+            
+            // 解析出的消息写入本次解析的内存池，转为列式存储后随内存池一并释放
+            MessageArena parseArena;
+            MessageArena::Scope parseScope(parseArena);
+            
+            // 只需要最近 N 条时从文件末尾反向读取，内存只与 N 有关
+            if (recentCount > 0 && !showsReport && !matcher && saveSnapshotFile.empty()) {
+                LogStore tail = LogStore::fromEntries(parser.parseFilesTail(filenames, recentCount, entryFilter));
+                {
+                    PerformanceMonitor::Timer timer(Stage::OUTPUT, 0, tail.size());
+                    showRecentLogs(tail, recentCount);
+                    std::cout.flush();
+                }
+                reportPerformance();
+                return 0;
+            }
+            
+            // 解析所有文件再转为列式存储。fromEntries 把消息拷贝进存储，拷贝期间内存池中的消息仍然存在，
+            // 峰值内存约为消息数据的两倍；转换完成后条目向量和内存池才一并释放；
+            // 指定签名时一次扫描原始字节只解析命中的行（其余条件在解析后一并过滤）；
+            // 指定关键词或时间范围时借助持久化索引只解析相关的行（近似统计和模板挖掘只观察满足过滤条件的行，结果相同）
+            std::uint64_t allocationsBefore = AllocationCounter::count();
+            std::vector<LogEntry> parsed;
+            if (matcher) {
+                parsed = parser.parseFilesMatching(filenames, *matcher, signatureHits, entryFilter);
+            } else if (hasSearch) {
+                parsed = parser.parseFilesMatching(filenames, query);
+                if (hasTimeRange) {
+                    PerformanceMonitor::Timer timer(Stage::FILTER, 0, parsed.size());
+                    parsed.erase(std::remove_if(parsed.begin(), parsed.end(), [&](const LogEntry& entry) {
+                        return entry.getTimestamp() < afterTime || entry.getTimestamp() >= beforeTime;
+                    }), parsed.end());
+                }
+            } else if (hasTimeRange) {
+                parsed = parser.parseFilesInRange(filenames, afterTime, beforeTime);
+            } else {
+                parsed = parser.parseFiles(filenames);
+            }
+            loadAllocations = AllocationCounter::count() - allocationsBefore;
+            PerformanceMonitor::Timer storeTimer(Stage::STORE, 0, parsed.size());
+            entries = LogStore::fromEntries(parsed);
+            std::vector<LogEntry>().swap(parsed);
+        }
+        
+        // 快照的报告：过滤后的各列直接写出
+        if (hasReport) {
+            ReportWriter report(reportFormat, reportFile, {loadSnapshotFile});
+            LogAggregator aggregation =
+                LogAggregator::aggregate(entries, std::chrono::seconds(bucketSeconds), threadCount);
+            {
+                PerformanceMonitor::Timer timer(Stage::OUTPUT, 0, entries.size());
+                report.writeRange(entries, 0, entries.size());
+                report.summary().totalLines = snapshotRows;
+                report.finish(&aggregation, topCount);
+            }
+            std::cout << "已写出 " << report.summary().entries << " 条日志条目到报告"
+                      << (reportFile == "-" ? "" : " " + reportFile) << "\n";
+            reportPerformance();
+            return 0;
+        }
+        
+        auto showLoadStats = [&]() {
+            if (!loadSnapshotFile.empty()) {
+                std::cout << "\n";
+                showSnapshotStats(loadSnapshotFile, snapshotRows, loadMilliseconds, loadAllocations);
+            } else {
+                std::cout << "\n" << parser.getStatsReport() << "\n";
+                showAllocationStats(loadAllocations, parser.getTotalLines());
+            }
+        };
+        
+        if (!saveSnapshotFile.empty()) {
+            entries.saveSnapshot(saveSnapshotFile);
+            std::cout << "已保存快照 " << saveSnapshotFile << "（" << entries.size() << " 条）\n";
+        }
         
         if (entries.empty()) {
             std::cout << "未找到有效的日志条目\n";
             if (showStats) {
-                std::cout << "\n" << parser.getStatsReport() << "\n";
+                showLoadStats();
             }
+            reportPerformance();
             return 0;
         }
         
-        std::cout << "成功解析 " << entries.size() << " 条日志条目\n";
+        // 快照的全部条件（含级别）已在载入时一并过滤
+        if (!loadSnapshotFile.empty()) {
+            std::cout << "成功载入 " << snapshotRows << " 条日志条目\n";
+            if (hasTimeRange || hasSearch || matcher) {
+                std::cout << "过滤后剩余 " << entries.size() << " 条日志条目\n";
+            } else if (hasLevelFilter) {
+                std::cout << "级别过滤后剩余 " << entries.size() << " 条日志条目\n";
+            }
+        } else {
+            std::cout << "成功解析 " << entries.size() << " 条日志条目\n";
+        }
         
         // 应用级别过滤
-        if (hasLevelFilter) {
+        if (hasLevelFilter && loadSnapshotFile.empty()) {
+            PerformanceMonitor::Timer timer(Stage::FILTER, 0, entries.size());
             entries = filterByLevel(entries, filterLevel);
             std::cout << "级别过滤后剩余 " << entries.size() << " 条日志条目\n";
         }
         
+        // 快照的近似统计和模板只看过滤后的行（解析时由解析器按同样的条件观察）
+        if (showSketch && !loadSnapshotFile.empty()) {
+            PerformanceMonitor::Timer timer(Stage::AGGREGATE, 0, entries.size());
+            snapshotSketches = std::make_unique<LogSketches>(sketchOptions);
+            snapshotSketches->addRange(entries, 0, entries.size());
+        }
+        if (showTemplates && !loadSnapshotFile.empty()) {
+            PerformanceMonitor::Timer timer(Stage::AGGREGATE, 0, entries.size());
+            snapshotTemplates = std::make_unique<TemplateMiner>(templateOptions);
+            snapshotTemplates->addRange(entries, 0, entries.size());
+        }
+        
+        // 聚合在输出之前完成，输出阶段只计打印
+        std::unique_ptr<LogAggregator> aggregation;
+        if (showAggregate) {
+            aggregation = std::make_unique<LogAggregator>(
+                LogAggregator::aggregate(entries, std::chrono::seconds(bucketSeconds), threadCount));
+        }
+        PerformanceMonitor::Timer outputTimer(Stage::OUTPUT);
+        
         // 显示统计信息
         if (showStats) {
-            std::cout << "\n" << parser.getStatsReport() << "\n";
+            showLoadStats();
         }
         
         // 显示级别统计
         if (showCount) {
-            showLevelStatistics(entries);
+            showLevelStatistics(entries, topCount);
+        }
+        
+        // 显示聚合报告
+        if (aggregation) {
+            showAggregation(*aggregation, topCount);
+        }
+        
+        // 显示近似统计
+        if (showSketch) {
+            showSketches(snapshotSketches ? *snapshotSketches : *parser.getSketches(), topCount);
+        }
+        
+        // 显示消息模板
+        if (showTemplates) {
+            showMessageTemplates(snapshotTemplates ? *snapshotTemplates : *parser.getTemplateMiner(), topCount);
+        }
+        
+        // 显示签名命中统计
+        if (matcher) {
+            showSignatureHits(*matcher, signatureHits);
         }
         
         // 显示日志条目
+        size_t printedEntries = 0;
         if (recentCount > 0) {
             showRecentLogs(entries, recentCount);
-        } else if (!showStats && !showCount) {
+            printedEntries = std::min(recentCount, entries.size());
+        } else if (!showsReport) {
             // 如果没有指定其他显示选项，显示所有日志
             showAllLogs(entries);
+            printedEntries = entries.size();
         }
         
+        std::cout.flush();
+        outputTimer.setVolume(0, printedEntries);
+        outputTimer.stop();
+        reportPerformance();
+        
     } catch (const std::exception& e) {
         std::cerr << "错误: " << e.what() << std::endl;
         return 1;
@@ -0,0 +1,299 @@
+/*
+ * CompressedInputTest.cpp
+ * CompressedInput 的测试：多成员 gzip 与多帧 zstd 在单线程和并行解压下的往返一致性、
+ * 压缩数据中的伪成员头、推测解压超出缓冲上限或失败后的回退，以及截断和尾部垃圾的报错
+ * 需要构建时找到对应的压缩库（LOGANALYZER_HAVE_ZLIB / _ZSTD），否则只运行格式识别的用例
+ */
+
+#include "TestSupport.h"
+#include "CompressedInput.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef LOGANALYZER_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef LOGANALYZER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    // 推测解压的单元最多缓冲的字节数（见 CompressedInput.cpp 的 SPECULATIVE_OUTPUT_LIMIT）
+    constexpr size_t SPECULATIVE_OUTPUT_LIMIT = 64u << 20;
+
+    // 覆盖单线程路径、只有一个工作线程、以及工作线程多于单元数的情况
+    const unsigned THREAD_COUNTS[] = {1, 2, 4, 16};
+
+    // 第 index 段日志文本，各段内容和长度都不同
+    std::string logText(size_t index, size_t lines) {
+        std::string text;
+        for (size_t i = 0; i < lines; ++i) {
+            text += "2024-01-15 10:00:00 [INFO] [svc] part " + std::to_string(index) + " line " +
+                    std::to_string(i) + "\n";
+        }
+        return text;
+    }
+
+    // 约 size 字节、超出推测缓冲上限也能快速压缩的重复文本
+    std::string largeText(size_t size) {
+        const std::string line = "2024-01-15 10:00:00 [DEBUG] [svc] heartbeat ok\n";
+        std::string text;
+        text.reserve(size + line.size());
+        while (text.size() < size) {
+            text += line;
+        }
+        return text;
+    }
+
+    std::string decompress(const std::string& data, unsigned threads) {
+        std::string output;
+        CompressedInput::decompress(data, threads, [&output](std::string_view block) {
+            output.append(block);
+        });
+        return output;
+    }
+
+    // 解压应当抛出异常；返回抛出前已经交付的数据
+    std::string decompressExpectingError(const std::string& data, unsigned threads, const std::string& label) {
+        std::string output;
+        try {
+            CompressedInput::decompress(data, threads, [&output](std::string_view block) {
+                output.append(block);
+            });
+            Testing::reportFailure(__FILE__, __LINE__, "没有抛出 std::runtime_error: " + label);
+        } catch (const std::runtime_error&) {
+        }
+        return output;
+    }
+
+    void expectRoundTrip(const std::string& compressed, const std::string& expected, const std::string& label) {
+        for (unsigned threads : THREAD_COUNTS) {
+            if (decompress(compressed, threads) != expected) {
+                Testing::reportFailure(__FILE__, __LINE__,
+                                       label + " 解压结果不一致（threads = " + std::to_string(threads) + "）");
+            }
+        }
+    }
+
+    void expectErrorAtEveryThreadCount(const std::string& compressed, const std::string& label) {
+        for (unsigned threads : THREAD_COUNTS) {
+            decompressExpectingError(compressed, threads, label + "（threads = " + std::to_string(threads) + "）");
+        }
+    }
+
+#ifdef LOGANALYZER_HAVE_ZLIB
+
+    // 压缩为一个 gzip 成员；level 为 0 时使用存储块，原文原样出现在压缩数据中
+    std::string gzipMember(const std::string& text, int level = Z_DEFAULT_COMPRESSION) {
+        z_stream stream{};
+        if (deflateInit2(&stream, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::runtime_error("无法初始化 gzip 压缩");
+        }
+        std::string member(deflateBound(&stream, static_cast<uLong>(text.size())), '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+        stream.avail_in = static_cast<uInt>(text.size());
+        stream.next_out = reinterpret_cast<Bytef*>(&member[0]);
+        stream.avail_out = static_cast<uInt>(member.size());
+        int result = deflate(&stream, Z_FINISH);
+        member.resize(stream.total_out);
+        deflateEnd(&stream);
+        if (result != Z_STREAM_END) {
+            throw std::runtime_error("gzip 压缩失败");
+        }
+        return member;
+    }
+
+#endif
+
+#ifdef LOGANALYZER_HAVE_ZSTD
+
+    // 压缩为一个 zstd 帧；recordSize 为 false 时帧头不记录内容长度（与流式压缩的输出相同）
+    std::string zstdFrame(const std::string& text, bool recordSize = true) {
+        ZSTD_CCtx* context = ZSTD_createCCtx();
+        ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, 1);
+        ZSTD_CCtx_setParameter(context, ZSTD_c_checksumFlag, 1);
+        ZSTD_CCtx_setParameter(context, ZSTD_c_contentSizeFlag, recordSize ? 1 : 0);
+        std::string frame(ZSTD_compressBound(text.size()), '\0');
+        size_t length = ZSTD_compress2(context, &frame[0], frame.size(), text.data(), text.size());
+        ZSTD_freeCCtx(context);
+        if (ZSTD_isError(length)) {
+            throw std::runtime_error(std::string("zstd 压缩失败: ") + ZSTD_getErrorName(length));
+        }
+        frame.resize(length);
+        return frame;
+    }
+
+    // 可跳过帧：魔数 0x184D2A50，4 字节小端长度，随后是任意内容
+    std::string skippableFrame(const std::string& payload) {
+        std::string frame("\x50\x2a\x4d\x18", 4);
+        for (int shift = 0; shift < 32; shift += 8) {
+            frame += static_cast<char>((payload.size() >> shift) & 0xff);
+        }
+        return frame + payload;
+    }
+
+#endif
+
+} // namespace
+
+TEST_CASE(detectRecognisesMagicNumbers) {
+    EXPECT_TRUE(CompressedInput::detect(std::string("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03", 10)) == Compression::GZIP);
+    EXPECT_TRUE(CompressedInput::detect(std::string("\x28\xb5\x2f\xfd", 4)) == Compression::ZSTD);
+    EXPECT_TRUE(CompressedInput::detect(std::string("\x04\x22\x4d\x18", 4)) == Compression::LZ4);
+
+    // 压缩方法不是 deflate、标志位的保留位非零或文件头不完整，都不是 gzip
+    EXPECT_TRUE(CompressedInput::detect(std::string("\x1f\x8b\x07\x00\x00\x00\x00\x00\x00\x03", 10)) == Compression::NONE);
+    EXPECT_TRUE(CompressedInput::detect(std::string("\x1f\x8b\x08\x20\x00\x00\x00\x00\x00\x03", 10)) == Compression::NONE);
+    EXPECT_TRUE(CompressedInput::detect(std::string("\x1f\x8b\x08\x00", 4)) == Compression::NONE);
+    EXPECT_TRUE(CompressedInput::detect("2024-01-15 10:00:00 [INFO] plain") == Compression::NONE);
+    EXPECT_TRUE(CompressedInput::detect("") == Compression::NONE);
+}
+
+#ifdef LOGANALYZER_HAVE_ZLIB
+
+TEST_CASE(gzipMembersRoundTrip) {
+    expectRoundTrip(gzipMember(logText(0, 500)), logText(0, 500), "单成员 gzip");
+
+    std::string compressed;
+    std::string expected;
+    for (size_t i = 0; i < 9; ++i) {
+        expected += logText(i, 100 + i * 37);
+        compressed += gzipMember(logText(i, 100 + i * 37));
+    }
+    // 空成员不产生输出，也不能打断成员链
+    compressed += gzipMember("");
+    compressed += gzipMember(logText(9, 3));
+    expected += logText(9, 3);
+    expectRoundTrip(compressed, expected, "多成员 gzip");
+
+    // 最后一个成员之后的零填充被忽略
+    expectRoundTrip(compressed + std::string(512, '\0'), expected, "带零填充的多成员 gzip");
+}
+
+TEST_CASE(gzipSpuriousMemberHeadersAreSkipped) {
+    // 存储块让完整的 gzip 成员原样嵌在外层成员的压缩数据里：
+    // 工作线程会把它当作候选成员并成功解压，但它不在成员链上，结果必须丢弃
+    const std::string embedded = gzipMember(logText(100, 20));
+    const std::string outer = "before " + embedded + " after\n";
+
+    std::string compressed;
+    std::string expected;
+    for (size_t i = 0; i < 4; ++i) {
+        compressed += gzipMember(logText(i, 50));
+        expected += logText(i, 50);
+        compressed += gzipMember(outer, 0);
+        expected += outer;
+    }
+    expectRoundTrip(compressed, expected, "含伪成员头的 gzip");
+
+    // 只有头部像成员、内容无法解压的伪候选
+    const std::string header("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03garbage", 17);
+    expectRoundTrip(gzipMember(header, 0) + gzipMember(logText(7, 10)) + gzipMember(header, 0),
+                    header + logText(7, 10) + header, "含无效伪成员头的 gzip");
+}
+
+TEST_CASE(gzipOversizedMemberFallsBackToStreaming) {
+    // 第二个成员解压后超出推测缓冲上限，工作线程放弃，轮到它时在调用线程上流式解压；
+    // 其后的成员仍然可以由工作线程推测解压
+    const std::string large = largeText(SPECULATIVE_OUTPUT_LIMIT + (1u << 20));
+    const std::string compressed = gzipMember(logText(0, 10)) + gzipMember(large, 1) +
+                                   gzipMember(logText(1, 10)) + gzipMember(logText(2, 10));
+    const std::string expected = logText(0, 10) + large + logText(1, 10) + logText(2, 10);
+    for (unsigned threads : {1u, 4u}) {
+        EXPECT_TRUE(decompress(compressed, threads) == expected);
+    }
+}
+
+TEST_CASE(gzipCorruptMemberFailsAfterEarlierMembers) {
+    // 中间成员的 CRC 损坏：工作线程推测解压失败后由调用线程重新解压并报错，
+    // 之前的成员已经按顺序交付
+    std::string corrupt = gzipMember(logText(1, 40));
+    corrupt[corrupt.size() - 6] ^= 0x5a;
+    const std::string compressed = gzipMember(logText(0, 40)) + corrupt + gzipMember(logText(2, 40));
+    for (unsigned threads : THREAD_COUNTS) {
+        std::string delivered = decompressExpectingError(compressed, threads, "CRC 损坏的 gzip 成员");
+        EXPECT_EQ(delivered.compare(0, logText(0, 40).size(), logText(0, 40)), 0);
+        EXPECT_TRUE(delivered.find("part 2 ") == std::string::npos);
+    }
+}
+
+TEST_CASE(gzipTruncatedOrTrailingGarbageFails) {
+    const std::string members = gzipMember(logText(0, 60)) + gzipMember(logText(1, 60)) + gzipMember(logText(2, 60));
+    const std::string last = gzipMember(logText(2, 60));
+
+    // 截断在最后一个成员的数据中、成员头中，以及只剩成员头
+    expectErrorAtEveryThreadCount(members.substr(0, members.size() - 20), "截断的 gzip");
+    expectErrorAtEveryThreadCount(members.substr(0, members.size() - last.size() + 5), "成员头被截断的 gzip");
+    expectErrorAtEveryThreadCount(members.substr(0, members.size() - last.size() + 10), "只剩成员头的 gzip");
+
+    // 成员之后的非零字节
+    expectErrorAtEveryThreadCount(members + "trailing garbage", "带尾部垃圾的 gzip");
+    expectErrorAtEveryThreadCount(members + std::string(16, '\0') + "x", "零填充后带垃圾的 gzip");
+}
+
+#endif
+
+#ifdef LOGANALYZER_HAVE_ZSTD
+
+TEST_CASE(zstdFramesRoundTrip) {
+    expectRoundTrip(zstdFrame(logText(0, 500)), logText(0, 500), "单帧 zstd");
+
+    std::string compressed;
+    std::string expected;
+    for (size_t i = 0; i < 9; ++i) {
+        expected += logText(i, 100 + i * 37);
+        compressed += zstdFrame(logText(i, 100 + i * 37), i % 2 == 0);
+        if (i == 4) {
+            // 可跳过帧不产生输出
+            compressed += skippableFrame("metadata");
+        }
+    }
+    compressed += zstdFrame("");
+    expectRoundTrip(compressed, expected, "多帧 zstd");
+    expectRoundTrip(compressed + std::string(512, '\0'), expected, "带零填充的多帧 zstd");
+}
+
+TEST_CASE(zstdOversizedFrameFallsBackToStreaming) {
+    // 超出推测缓冲上限的帧：帧头记录了内容长度时工作线程直接放弃，
+    // 没有记录时解压到上限才放弃；两种情况都在轮到它时由调用线程流式解压
+    const std::string large = largeText(SPECULATIVE_OUTPUT_LIMIT + (1u << 20));
+    for (bool recordSize : {true, false}) {
+        const std::string compressed = zstdFrame(logText(0, 10)) + zstdFrame(large, recordSize) +
+                                       zstdFrame(logText(1, 10)) + zstdFrame(logText(2, 10));
+        const std::string expected = logText(0, 10) + large + logText(1, 10) + logText(2, 10);
+        for (unsigned threads : {1u, 4u}) {
+            EXPECT_TRUE(decompress(compressed, threads) == expected);
+        }
+    }
+}
+
+TEST_CASE(zstdCorruptFrameFailsAfterEarlierFrames) {
+    // 中间帧的校验和损坏：帧仍能切分，但工作线程和调用线程解压时都会报错
+    std::string corrupt = zstdFrame(logText(1, 40));
+    corrupt[corrupt.size() - 1] ^= 0x5a;
+    const std::string compressed = zstdFrame(logText(0, 40)) + corrupt + zstdFrame(logText(2, 40));
+    for (unsigned threads : THREAD_COUNTS) {
+        std::string delivered = decompressExpectingError(compressed, threads, "校验和损坏的 zstd 帧");
+        EXPECT_EQ(delivered.compare(0, logText(0, 40).size(), logText(0, 40)), 0);
+        EXPECT_TRUE(delivered.find("part 2 ") == std::string::npos);
+    }
+}
+
+TEST_CASE(zstdTruncatedOrTrailingGarbageFails) {
+    const std::string frames = zstdFrame(logText(0, 60)) + zstdFrame(logText(1, 60)) + zstdFrame(logText(2, 60));
+
+    expectErrorAtEveryThreadCount(frames.substr(0, frames.size() - 20), "截断的 zstd");
+    expectErrorAtEveryThreadCount(frames.substr(0, frames.size() - 1), "缺少校验和的 zstd");
+    expectErrorAtEveryThreadCount(frames + "trailing garbage", "带尾部垃圾的 zstd");
+    expectErrorAtEveryThreadCount(frames + std::string(16, '\0') + "x", "零填充后带垃圾的 zstd");
+}
+
+#endif
+
+int main() {
+    return Testing::runAll();
+}
@@ -0,0 +1,243 @@
+/*
+ * KeywordIndexTest.cpp
+ * KeywordIndex 的测试：倒排表的差值编码与损坏检测、查询的解析与匹配语义、
+ * 索引查询与逐行匹配的一致性，以及损坏的 .kidx 被重建
+ */
+
+#include "TestSupport.h"
+#include "KeywordIndex.h"
+#include "LogParser.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    using Offsets = std::vector<std::uint64_t>;
+
+    // 索引文件头中词数量字段与第一个词的长度字段的偏移（magic 8 + 版本 4 + 签名 40 + 已索引字节 8）
+    constexpr size_t TERM_COUNT_FIELD = 60;
+    constexpr size_t FIRST_TERM_LENGTH_FIELD = TERM_COUNT_FIELD + sizeof(std::uint64_t);
+
+    std::string errorLine(const std::string& message) {
+        return "2024-01-15 10:00:00 [ERROR] [svc] " + message + "\n";
+    }
+
+    template <typename T>
+    void patch(std::string& bytes, size_t position, T value) {
+        std::memcpy(&bytes[position], &value, sizeof(value));
+    }
+
+    /**
+     * 临时日志文件，析构时连同 .kidx 一起删除
+     */
+    struct TempLog {
+        std::string path;
+
+        TempLog(const std::string& name, const std::string& content) : path(Testing::tempPath(name)) {
+            Testing::writeFile(path, content);
+        }
+
+        ~TempLog() {
+            std::remove(path.c_str());
+            std::remove(KeywordIndex::indexPath(path).c_str());
+        }
+    };
+
+    // 建立或加载的索引，以及本次扫描的行数
+    struct Indexed {
+        KeywordIndex index;
+        size_t scannedLines;
+    };
+
+    Indexed buildIndex(const std::string& path) {
+        LogParser parser;
+        KeywordIndex index = KeywordIndex::loadOrBuild(path, parser);
+        return Indexed{std::move(index), parser.getTotalLines()};
+    }
+
+    Offsets lookup(const KeywordIndex& index, const std::string& query) {
+        return index.lookup(KeywordQuery(query));
+    }
+
+} // namespace
+
+TEST_CASE(postingListRoundTripsDeltas) {
+    KeywordIndex::PostingList list;
+    for (std::uint64_t offset : {0ull, 5ull, 5ull, 300ull, 70000ull, 1ull << 40}) {
+        list.append(offset);
+    }
+    EXPECT_EQ(list.count, std::uint64_t(5));
+    EXPECT_EQ(list.last, std::uint64_t(1) << 40);
+    EXPECT_TRUE(list.decode() == (Offsets{0, 5, 300, 70000, 1ull << 40}));
+}
+
+TEST_CASE(corruptPostingBytesFailToDecode) {
+    Offsets offsets;
+
+    // 超过 64 位的 varint
+    KeywordIndex::PostingList overlong;
+    overlong.bytes.assign(12, 0xFF);
+    overlong.bytes.push_back(0x01);
+    overlong.count = 1;
+    EXPECT_TRUE(!overlong.decode(offsets));
+    EXPECT_TRUE(overlong.decode().empty());
+
+    // 以延续字节结尾、count 或 last 与编码不一致、重复偏移
+    KeywordIndex::PostingList valid;
+    valid.append(10);
+    valid.append(20);
+    EXPECT_TRUE(valid.decode(offsets));
+
+    KeywordIndex::PostingList truncated = valid;
+    truncated.bytes.push_back(0x80);
+    EXPECT_TRUE(!truncated.decode(offsets));
+
+    KeywordIndex::PostingList wrongCount = valid;
+    wrongCount.count = std::uint64_t(1) << 60;
+    EXPECT_TRUE(!wrongCount.decode(offsets));
+
+    KeywordIndex::PostingList wrongLast = valid;
+    wrongLast.last = 21;
+    EXPECT_TRUE(!wrongLast.decode(offsets));
+
+    KeywordIndex::PostingList repeated = valid;
+    repeated.bytes.push_back(0x00);
+    repeated.count = 3;
+    EXPECT_TRUE(!repeated.decode(offsets));
+}
+
+TEST_CASE(tokenizerLowercasesAndKeepsNonAsciiBytes) {
+    std::vector<std::string> tokens;
+    std::string buffer;
+    KeywordIndex::forEachToken("Disk_1 \xE6\xBB\xA1\xE4\xBA\x86, RETRY#2--", buffer, [&tokens](std::string_view token) {
+        tokens.emplace_back(token);
+    });
+    EXPECT_TRUE(tokens == (std::vector<std::string>{"disk_1", "\xE6\xBB\xA1\xE4\xBA\x86", "retry", "2"}));
+}
+
+TEST_CASE(queryParsesGroupsAndAlternatives) {
+    KeywordQuery query("Database timeout|REFUSED connection-reset");
+    const std::vector<std::vector<std::string>> expected = {
+        {"database"}, {"timeout", "refused"}, {"connection"}, {"reset"}};
+    EXPECT_TRUE(query.getGroups() == expected);
+
+    EXPECT_TRUE(KeywordQuery("   ").empty());
+    EXPECT_TRUE(KeywordQuery("a||b").getGroups() == (std::vector<std::vector<std::string>>{{"a", "b"}}));
+    EXPECT_THROWS(KeywordQuery("disk|connection-reset"), std::runtime_error);
+}
+
+TEST_CASE(queryMatchesWholeWordsIgnoringCase) {
+    KeywordQuery query("database timeout|refused");
+    EXPECT_TRUE(query.matches("DATABASE connection Timeout"));
+    EXPECT_TRUE(query.matches("refused by database"));
+    EXPECT_TRUE(!query.matches("database ok"));
+    EXPECT_TRUE(!query.matches("databases timeout"));
+    EXPECT_TRUE(!query.matches("timeout"));
+}
+
+TEST_CASE(lookupAgreesWithLineMatching) {
+    const std::vector<std::string> messages = {
+        "Database timeout on primary",
+        "database connection refused",
+        "cache timeout",
+        "connection-reset by peer",
+        "disk full on /var",
+    };
+    std::string content;
+    Offsets lineStarts;
+    for (const auto& message : messages) {
+        lineStarts.push_back(content.size());
+        content += errorLine(message);
+    }
+    content += "not a log line mentioning database\n";
+    TempLog log("kw_lookup.log", content);
+
+    Indexed built = buildIndex(log.path);
+    for (const char* text : {"database", "database timeout|refused", "TIMEOUT", "connection reset",
+                             "cache database", "time", "on", "full|reset peer|disk"}) {
+        KeywordQuery query(text);
+        Offsets expected;
+        for (size_t i = 0; i < messages.size(); ++i) {
+            if (query.matches(messages[i])) {
+                expected.push_back(lineStarts[i]);
+            }
+        }
+        if (built.index.lookup(query) != expected) {
+            Testing::reportFailure(__FILE__, __LINE__, std::string("索引查询与逐行匹配不一致: ") + text);
+        }
+    }
+
+    // 只索引消息内容：级别、来源和无法解析的行都不产生词
+    EXPECT_TRUE(lookup(built.index, "svc").empty());
+    EXPECT_TRUE(lookup(built.index, "error").empty());
+    EXPECT_TRUE(lookup(built.index, "mentioning").empty());
+}
+
+TEST_CASE(reloadedIndexAnswersFromDisk) {
+    const std::string head = errorLine("disk full") + errorLine("network down");
+    TempLog log("kw_reload.log", head);
+    Indexed built = buildIndex(log.path);
+
+    Indexed reloaded = buildIndex(log.path);
+    EXPECT_EQ(reloaded.scannedLines, size_t(0));
+    EXPECT_EQ(reloaded.index.termCount(), built.index.termCount());
+    EXPECT_TRUE(lookup(reloaded.index, "down") == lookup(built.index, "down"));
+
+    // 追加的行带着新偏移并入已有的倒排表
+    Testing::writeFile(log.path, errorLine("disk repaired"), true);
+    Indexed extended = buildIndex(log.path);
+    EXPECT_EQ(extended.scannedLines, size_t(1));
+    EXPECT_TRUE(lookup(extended.index, "disk") == (Offsets{0, head.size()}));
+    EXPECT_TRUE(lookup(extended.index, "disk full|repaired") == (Offsets{0, head.size()}));
+}
+
+TEST_CASE(corruptSidecarIsRebuilt) {
+    const std::string first = errorLine("disk full");
+    TempLog log("kw_corrupt.log", first + errorLine("network down"));
+    const std::string indexPath = KeywordIndex::indexPath(log.path);
+    buildIndex(log.path);
+    const std::string valid = Testing::readFile(indexPath);
+
+    // 词数量、第一个词的长度、第一个倒排表的字节数分别远超文件剩余内容
+    std::string hugeTermCount = valid;
+    patch(hugeTermCount, TERM_COUNT_FIELD, std::uint64_t(1) << 60);
+    std::string hugeTermLength = valid;
+    patch(hugeTermLength, FIRST_TERM_LENGTH_FIELD, std::uint32_t(0xFFFFFFFFu));
+    std::uint32_t firstTermLength = 0;
+    std::memcpy(&firstTermLength, valid.data() + FIRST_TERM_LENGTH_FIELD, sizeof(firstTermLength));
+    const size_t lastField = FIRST_TERM_LENGTH_FIELD + sizeof(std::uint32_t) + firstTermLength;
+    const size_t countField = lastField + sizeof(std::uint64_t);
+    const size_t byteCountField = countField + sizeof(std::uint64_t);
+    std::string hugeByteCount = valid;
+    patch(hugeByteCount, byteCountField, std::uint64_t(1) << 62);
+
+    // 倒排表内容损坏：count 远超编码字节数、全是延续字节、last 与编码不一致
+    std::uint64_t postingBytes = 0;
+    std::memcpy(&postingBytes, valid.data() + byteCountField, sizeof(postingBytes));
+    std::string forgedCount = valid;
+    patch(forgedCount, countField, std::uint64_t(1) << 60);
+    std::string continuationBytes = valid;
+    continuationBytes.replace(byteCountField + sizeof(std::uint64_t), static_cast<size_t>(postingBytes),
+                              static_cast<size_t>(postingBytes), '\xFF');
+    std::string wrongLast = valid;
+    patch(wrongLast, lastField, std::uint64_t(12345));
+
+    for (const std::string& corrupt : {hugeTermCount, hugeTermLength, hugeByteCount, forgedCount,
+                                       continuationBytes, wrongLast,
+                                       valid.substr(0, valid.size() - 3), std::string("garbage")}) {
+        Testing::writeFile(indexPath, corrupt);
+        Indexed rebuilt = buildIndex(log.path);
+        EXPECT_EQ(rebuilt.scannedLines, size_t(2));
+        EXPECT_TRUE(lookup(rebuilt.index, "network") == (Offsets{first.size()}));
+        EXPECT_EQ(buildIndex(log.path).scannedLines, size_t(0));
+    }
+}
+
+int main() {
+    return Testing::runAll();
+}
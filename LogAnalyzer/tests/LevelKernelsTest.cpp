@@ -0,0 +1,124 @@
+/*
+ * LevelKernelsTest.cpp
+ * 级别内核与逐字节参考实现的对照测试
+ * 内核在进程内只选择一次，CMake 以 LOGANALYZER_SIMD=scalar|sse2|avx2 分别再运行本测试
+ */
+
+#include "TestSupport.h"
+#include "LevelKernels.h"
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    std::array<size_t, LOG_LEVEL_COUNT> referenceHistogram(const std::uint8_t* levels, size_t count) {
+        std::array<size_t, LOG_LEVEL_COUNT> counts{};
+        for (size_t i = 0; i < count; ++i) {
+            if (levels[i] < LOG_LEVEL_COUNT) {
+                counts[levels[i]]++;
+            }
+        }
+        return counts;
+    }
+
+    std::vector<std::uint64_t> referenceBitmap(const std::uint8_t* levels, size_t count, LogLevel level) {
+        std::vector<std::uint64_t> bitmap((count + 63) / 64, 0);
+        for (size_t i = 0; i < count; ++i) {
+            if (levels[i] == static_cast<std::uint8_t>(level)) {
+                bitmap[i / 64] |= std::uint64_t(1) << (i % 64);
+            }
+        }
+        return bitmap;
+    }
+
+    // 内核结果与参考实现逐项比较；每个失败只报告一次，避免刷屏
+    void expectMatchesReference(const std::uint8_t* levels, size_t count, const std::string& label) {
+        if (levelHistogram(levels, count) != referenceHistogram(levels, count)) {
+            Testing::reportFailure(__FILE__, __LINE__, "levelHistogram 不一致: " + label);
+        }
+        for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+            const auto value = static_cast<LogLevel>(level);
+            if (levelSelectBitmap(levels, count, value) != referenceBitmap(levels, count, value)) {
+                Testing::reportFailure(__FILE__, __LINE__, "levelSelectBitmap 不一致: " + label +
+                                                           " level=" + std::to_string(level));
+            }
+        }
+    }
+
+    // 长度覆盖空输入、各向量宽度和位图字长的边界两侧，以及超过 255 个 32 字节块的情况
+    std::vector<size_t> interestingLengths() {
+        std::vector<size_t> lengths;
+        for (size_t base : {size_t(0), size_t(16), size_t(32), size_t(64), size_t(128),
+                            size_t(255 * 16), size_t(255 * 32), size_t(255 * 32 * 2), size_t(255 * 32 * 5)}) {
+            for (size_t delta : {size_t(0), size_t(1), size_t(7), size_t(15), size_t(31), size_t(33)}) {
+                lengths.push_back(base + delta);
+                if (base > delta) {
+                    lengths.push_back(base - delta);
+                }
+            }
+        }
+        return lengths;
+    }
+
+} // namespace
+
+TEST_CASE(forcedKernelIsSelected) {
+    const char* forced = std::getenv("LOGANALYZER_SIMD");
+    const std::string name = levelKernelName();
+    if (forced != nullptr && std::string(forced) == "scalar") {
+        EXPECT_EQ(name, std::string("scalar"));
+    } else if (forced != nullptr && std::string(forced) == "sse2") {
+        // 非 x86 平台没有 SSE2，回退到标量实现
+        EXPECT_TRUE(name == "sse2" || name == "scalar");
+    }
+    EXPECT_TRUE(name == "avx2" || name == "sse2" || name == "scalar");
+}
+
+TEST_CASE(randomLevelsMatchReference) {
+    std::mt19937 rng(8);
+    const size_t maxLength = 255 * 32 * 5 + 64;
+    std::vector<std::uint8_t> levels(maxLength + 1);
+
+    // 大部分是有效级别，夹杂超出范围的值（不计入直方图、也不会被选中）
+    for (auto& level : levels) {
+        const unsigned roll = rng() % 100;
+        level = static_cast<std::uint8_t>(roll < 90 ? roll % LOG_LEVEL_COUNT : (roll < 95 ? 5 : 255));
+    }
+
+    for (size_t length : interestingLengths()) {
+        expectMatchesReference(levels.data(), length, "length=" + std::to_string(length));
+        // 起始地址不对齐
+        expectMatchesReference(levels.data() + 1, length, "offset=1 length=" + std::to_string(length));
+    }
+}
+
+TEST_CASE(uniformRunsDoNotOverflowByteCounters) {
+    // 每个向量字节都命中同一级别，字节计数器每轮都累加到上限
+    for (size_t level = 0; level < LOG_LEVEL_COUNT; ++level) {
+        for (size_t length : {size_t(255 * 32 + 1), size_t(255 * 32 * 3 + 17), size_t(100003)}) {
+            std::vector<std::uint8_t> levels(length, static_cast<std::uint8_t>(level));
+            expectMatchesReference(levels.data(), length,
+                                   "uniform level=" + std::to_string(level) + " length=" + std::to_string(length));
+            EXPECT_EQ(levelHistogram(levels.data(), length)[level], length);
+        }
+    }
+}
+
+TEST_CASE(bitmapExpandsToIndices) {
+    std::vector<std::uint8_t> levels(200, static_cast<std::uint8_t>(LogLevel::INFO));
+    std::vector<size_t> expected = {0, 63, 64, 127, 128, 199};
+    for (size_t index : expected) {
+        levels[index] = static_cast<std::uint8_t>(LogLevel::ERROR);
+    }
+    auto bitmap = levelSelectBitmap(levels.data(), levels.size(), LogLevel::ERROR);
+    EXPECT_TRUE(bitmapToIndices(bitmap, levels.size()) == expected);
+    EXPECT_TRUE(bitmapToIndices(levelSelectBitmap(levels.data(), 0, LogLevel::ERROR), 0).empty());
+}
+
+int main() {
+    return Testing::runAll();
+}
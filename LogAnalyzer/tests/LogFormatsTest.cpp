@@ -0,0 +1,198 @@
+/*
+ * LogFormatsTest.cpp
+ * 手写扫描器与原先 LOG_PATTERNS 正则的对照测试：是否匹配以及每个字段都逐字节一致
+ */
+
+#include "TestSupport.h"
+#include "LogFormats.h"
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    // 替换为扫描器之前 LogParser 使用的正则，顺序与 LogFormat 一致
+    const char* const LEGACY_PATTERNS[LOG_FORMAT_COUNT] = {
+        R"((\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2})\s+\[(\w+)\]\s+\[([^\]]+)\]\s+(.+))",
+        R"((\w{3} \d{1,2} \d{2}:\d{2}:\d{2})\s+(\w+)\s+([^:]+):\s+(.+))",
+        R"((\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2},\d{3})\s+(\w+)\s+\[([^\]]+)\]\s+(.+))",
+        R"((\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2})\s+(\w+):\s+(.+))",
+        R"((\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3}Z?)\s+\[(\w+)\]\s+\[([^\]]+)\]\s+(.+))",
+    };
+
+    const std::vector<std::regex>& legacyRegexes() {
+        static const std::vector<std::regex> regexes = [] {
+            std::vector<std::regex> result;
+            for (const char* pattern : LEGACY_PATTERNS) {
+                result.emplace_back(pattern);
+            }
+            return result;
+        }();
+        return regexes;
+    }
+
+    std::string printable(const std::string& line) {
+        std::string result;
+        for (char c : line) {
+            if (c == '\r') result += "\\r";
+            else if (c == '\n') result += "\\n";
+            else if (c == '\t') result += "\\t";
+            else result += c;
+        }
+        return result;
+    }
+
+    /**
+     * 用一种格式分别走扫描器和正则，比较结果
+     * @return 两者是否一致
+     */
+    bool sameAsRegex(LogFormat format, const std::string& line) {
+        const auto index = static_cast<size_t>(format);
+        std::smatch match;
+        const bool expected = std::regex_match(line, match, legacyRegexes()[index]);
+
+        LogFields fields;
+        const bool actual = scanLogLine(format, line, fields);
+        if (actual != expected) {
+            return false;
+        }
+        if (!expected) {
+            return true;
+        }
+
+        if (fields.timestamp != match[1].str() || fields.level != match[2].str()) {
+            return false;
+        }
+        if (format == LogFormat::SIMPLE_COLON) {
+            return !fields.hasSource && fields.message == match[3].str();
+        }
+        return fields.hasSource && fields.source == match[3].str() && fields.message == match[4].str();
+    }
+
+    void expectAllFormatsAgree(const std::string& line) {
+        for (size_t i = 0; i < LOG_FORMAT_COUNT; ++i) {
+            const auto format = static_cast<LogFormat>(i);
+            if (!sameAsRegex(format, line)) {
+                Testing::reportFailure(__FILE__, __LINE__,
+                                       std::string(logFormatName(format)) + " 与正则不一致: \"" +
+                                       printable(line) + "\"");
+            }
+        }
+    }
+
+    // 每种格式的典型行
+    const std::vector<std::string> SEED_LINES = {
+        "2024-01-15 14:30:45 [INFO] [main] Application started",
+        "Jan 15 14:30:45 host sshd[123]: Accepted password for root",
+        "2024-01-15 14:30:45,123 ERROR [worker-1] Connection refused",
+        "2024-01-15 14:30:45 WARN: disk usage at 91%",
+        "2024-01-15T14:30:45.123Z [DEBUG] [scheduler] tick",
+    };
+
+} // namespace
+
+TEST_CASE(typicalLinesMatchTheirOwnFormat) {
+    for (size_t i = 0; i < SEED_LINES.size(); ++i) {
+        LogFields fields;
+        EXPECT_TRUE(scanLogLine(static_cast<LogFormat>(i), SEED_LINES[i], fields));
+        expectAllFormatsAgree(SEED_LINES[i]);
+    }
+}
+
+TEST_CASE(extraWhitespaceMatchesRegex) {
+    const std::vector<std::string> lines = {
+        "2024-01-15 14:30:45    [INFO]\t\t[main]   spaced   message  ",
+        "2024-01-15 14:30:45 [INFO] [main]\v\fmessage",
+        "2024-01-15 14:30:45[INFO] [main] no space before level",
+        "2024-01-15 14:30:45 [INFO][main] no space before source",
+        "Jan  5 14:30:45 host sshd: double space after month",
+        "Jan 5 14:30:45    host    sshd   :   padded",
+        "2024-01-15 14:30:45,123\tINFO\t[main]\tTabs",
+        "2024-01-15 14:30:45   INFO:    spaced",
+        "2024-01-15 14:30:45 INFO : space before colon",
+        "2024-01-15T14:30:45.123  [INFO]  [main]  no zone",
+        "2024-01-15T14:30:45.123ZZ [INFO] [main] two zones",
+    };
+    for (const auto& line : lines) {
+        expectAllFormatsAgree(line);
+    }
+}
+
+TEST_CASE(syslogSourceBacktrackingMatchesRegex) {
+    const std::vector<std::string> lines = {
+        "Jan 15 14:30:45 host kernel: a: b: c",
+        "Jan 15 14:30:45 host a b c: message",
+        "Jan 15 14:30:45 host  : only spaces before colon",
+        "Jan 15 14:30:45 host : single space before colon",
+        "Jan 15 14:30:45 host svc:no space after colon",
+        "Jan 15 14:30:45 host svc:: double colon",
+        "Jan 15 14:30:45 host svc: ",
+        "Jan 15 14:30:45 host svc:  ",
+        "Jan 15 14:30:45 host svc",
+        "Jan 15 14:30:45 host: missing source",
+        "Jan 15 14:30:45 host-1 svc: dash in host",
+        "Jan 123 14:30:45 host svc: three-digit day",
+    };
+    for (const auto& line : lines) {
+        expectAllFormatsAgree(line);
+    }
+}
+
+TEST_CASE(lineTerminatorsMatchRegex) {
+    for (const auto& seed : SEED_LINES) {
+        expectAllFormatsAgree(seed + "\r");
+        expectAllFormatsAgree(seed + " \r");
+        expectAllFormatsAgree(seed + "\r ");
+        expectAllFormatsAgree(seed + "\n");
+        expectAllFormatsAgree(seed.substr(0, seed.size() / 2) + "\r" + seed.substr(seed.size() / 2));
+    }
+}
+
+TEST_CASE(emptyAndWhitespaceMessagesMatchRegex) {
+    const std::vector<std::string> prefixes = {
+        "2024-01-15 14:30:45 [INFO] [main]",
+        "Jan 15 14:30:45 host sshd:",
+        "2024-01-15 14:30:45,123 INFO [main]",
+        "2024-01-15 14:30:45 INFO:",
+        "2024-01-15T14:30:45.123Z [INFO] [main]",
+    };
+    for (const auto& prefix : prefixes) {
+        for (const char* tail : {"", " ", "  ", "\t ", " \t", "   x", " \r", "  \r", " \r ", "\f\v"}) {
+            expectAllFormatsAgree(prefix + tail);
+        }
+    }
+    expectAllFormatsAgree("");
+    expectAllFormatsAgree("2024-01-15 14:30:45 [] [main] empty level");
+    expectAllFormatsAgree("2024-01-15 14:30:45 [INFO] [] empty source");
+    expectAllFormatsAgree("2024-01-15 14:30:45 [INFO] [a]b] bracket in message");
+}
+
+TEST_CASE(randomMutationsMatchRegex) {
+    // 对典型行做随机替换、插入和删除，重点使用各模式里有意义的字符
+    const std::string alphabet = " \t\r\n\v:[]_,.-TZa9";
+    std::mt19937 rng(20240115);
+
+    for (const auto& seed : SEED_LINES) {
+        for (int round = 0; round < 400; ++round) {
+            std::string line = seed;
+            const int edits = 1 + static_cast<int>(rng() % 3);
+            for (int e = 0; e < edits && !line.empty(); ++e) {
+                const size_t position = rng() % line.size();
+                const char c = alphabet[rng() % alphabet.size()];
+                switch (rng() % 3) {
+                    case 0: line[position] = c; break;
+                    case 1: line.insert(line.begin() + static_cast<std::ptrdiff_t>(position), c); break;
+                    default: line.erase(position, 1); break;
+                }
+            }
+            expectAllFormatsAgree(line);
+        }
+    }
+}
+
+int main() {
+    return Testing::runAll();
+}
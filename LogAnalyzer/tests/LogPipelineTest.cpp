@@ -0,0 +1,191 @@
+/*
+ * LogPipelineTest.cpp
+ * LogPipeline 与 FilterStage 的测试：融合过滤的就地压缩、阶段顺序、按文件报告错误与阶段异常的传出
+ */
+
+#include "TestSupport.h"
+#include "LogPipeline.h"
+#include "StringPool.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    using Clock = std::chrono::system_clock;
+
+    LogEntry makeEntry(int second, LogLevel level, std::string_view message) {
+        return LogEntry::fromStored(Clock::time_point(std::chrono::seconds(second)), level,
+                                    SourceTable::intern("svc"), MessageArena::current().store(message));
+    }
+
+    std::vector<LogEntry> sampleBatch() {
+        return {
+            makeEntry(1, LogLevel::INFO, "user alice logged in"),
+            makeEntry(2, LogLevel::ERROR, "database timeout"),
+            makeEntry(3, LogLevel::ERROR, "disk full"),
+            makeEntry(4, LogLevel::WARN, "slow query"),
+            makeEntry(5, LogLevel::ERROR, "database refused"),
+            makeEntry(6, LogLevel::ERROR, "database timeout again"),
+        };
+    }
+
+    std::vector<std::string> messages(const std::vector<LogEntry>& batch) {
+        std::vector<std::string> result;
+        for (const auto& entry : batch) {
+            result.emplace_back(entry.getMessage());
+        }
+        return result;
+    }
+
+    // 写出测试用的日志文件，返回路径（调用方负责删除）
+    std::string writeLog(const std::string& name, const std::vector<std::string>& lines) {
+        const std::string path = Testing::tempPath(name);
+        std::ofstream file(path, std::ios::binary);
+        for (const auto& line : lines) {
+            file << line << "\n";
+        }
+        return path;
+    }
+
+} // namespace
+
+TEST_CASE(filterWithoutStagesKeepsBatch) {
+    LogParser parser;
+    LogPipeline pipeline(parser);
+    auto batch = sampleBatch();
+    EXPECT_EQ(pipeline.filter(batch), size_t(6));
+    EXPECT_TRUE(!pipeline.hasFilters());
+    EXPECT_TRUE(!pipeline.entryFilter());
+}
+
+TEST_CASE(filterCompactsInPlaceAndKeepsOrder) {
+    LogParser parser;
+    LogPipeline pipeline(parser);
+    pipeline.addFilter(FilterStage::keyword(KeywordQuery("database")))
+            .addFilter(FilterStage::level(LogLevel::ERROR));
+
+    auto batch = sampleBatch();
+    const LogEntry* data = batch.data();
+    EXPECT_EQ(pipeline.filter(batch), size_t(3));
+    EXPECT_EQ(batch.size(), size_t(3));
+    EXPECT_TRUE(batch.data() == data);
+    std::vector<std::string> expected = {"database timeout", "database refused", "database timeout again"};
+    EXPECT_TRUE(messages(batch) == expected);
+}
+
+TEST_CASE(filterCompactsLeadingAndTrailingRejects) {
+    LogParser parser;
+    LogPipeline pipeline(parser);
+    pipeline.addFilter(FilterStage::timeRange(Clock::time_point(std::chrono::seconds(2)),
+                                              Clock::time_point(std::chrono::seconds(5))));
+    auto batch = sampleBatch();
+    EXPECT_EQ(pipeline.filter(batch), size_t(3));
+    std::vector<std::string> expected = {"database timeout", "disk full", "slow query"};
+    EXPECT_TRUE(messages(batch) == expected);
+
+    pipeline.addFilter(FilterStage::level(LogLevel::FATAL));
+    EXPECT_EQ(pipeline.filter(batch), size_t(0));
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST_CASE(customStageRunsAfterBuiltInStages) {
+    LogParser parser;
+    LogPipeline pipeline(parser);
+    size_t calls = 0;
+    pipeline.addFilter(FilterStage::custom([&calls](const LogEntry& entry) {
+        ++calls;
+        return entry.getMessage().find("again") == std::string_view::npos;
+    }));
+    pipeline.addFilter(FilterStage::level(LogLevel::ERROR));
+
+    auto batch = sampleBatch();
+    EXPECT_EQ(pipeline.filter(batch), size_t(3));
+    EXPECT_EQ(calls, size_t(4));   // 只对四条 ERROR 调用
+    EXPECT_TRUE(pipeline.entryFilter()(batch[0]));
+}
+
+TEST_CASE(customStageRejectsEmptyPredicate) {
+    EXPECT_THROWS(FilterStage::custom(EntryFilter()), std::invalid_argument);
+}
+
+TEST_CASE(runDeliversFilteredBatches) {
+    std::vector<std::string> lines;
+    for (int i = 0; i < 10; ++i) {
+        lines.push_back("2024-01-01 10:00:0" + std::to_string(i) + (i % 2 ? " [ERROR]" : " [INFO]") +
+                        " [svc] message " + std::to_string(i));
+    }
+    const std::string path = writeLog("pipeline.log", lines);
+
+    LogParser parser;
+    LogPipeline pipeline(parser, 2);
+    pipeline.addFilter(FilterStage::level(LogLevel::ERROR));
+    std::vector<std::string> seen;
+    size_t batches = 0;
+    pipeline.addSink([&](const std::vector<LogEntry>& batch) {
+        ++batches;
+        for (const auto& entry : batch) {
+            seen.emplace_back(entry.getMessage());
+        }
+    });
+    pipeline.run({path});
+    std::remove(path.c_str());
+
+    EXPECT_EQ(pipeline.parsedEntries(), std::uint64_t(10));
+    EXPECT_EQ(pipeline.passedEntries(), std::uint64_t(5));
+    EXPECT_EQ(batches, size_t(5));
+    std::vector<std::string> expected = {"message 1", "message 3", "message 5", "message 7", "message 9"};
+    EXPECT_TRUE(seen == expected);
+}
+
+TEST_CASE(runReportsUnreadableFileAndContinues) {
+    const std::string path = writeLog("pipeline_ok.log", {"2024-01-01 10:00:00 [ERROR] [svc] kept"});
+    const std::string missing = Testing::tempPath("pipeline_missing.log");
+
+    LogParser parser;
+    LogPipeline pipeline(parser);
+    std::uint64_t delivered = 0;
+    pipeline.addSink([&](const std::vector<LogEntry>& batch) { delivered += batch.size(); });
+    pipeline.run({missing, path});
+    std::remove(path.c_str());
+
+    EXPECT_EQ(delivered, std::uint64_t(1));
+    EXPECT_EQ(pipeline.parsedEntries(), std::uint64_t(1));
+}
+
+TEST_CASE(runRethrowsSinkErrors) {
+    const std::string first = writeLog("pipeline_a.log", {"2024-01-01 10:00:00 [ERROR] [svc] a"});
+    const std::string second = writeLog("pipeline_b.log", {"2024-01-01 10:00:01 [ERROR] [svc] b"});
+
+    LogParser parser;
+    LogPipeline pipeline(parser);
+    size_t calls = 0;
+    pipeline.addSink([&](const std::vector<LogEntry>&) {
+        ++calls;
+        throw std::runtime_error("sink failed");
+    });
+    EXPECT_THROWS(pipeline.run({first, second}), std::runtime_error);
+    EXPECT_EQ(calls, size_t(1));   // 阶段错误立即传出，不再处理后面的文件
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+}
+
+TEST_CASE(runRethrowsFilterErrors) {
+    const std::string path = writeLog("pipeline_c.log", {"2024-01-01 10:00:00 [ERROR] [svc] c"});
+
+    LogParser parser;
+    LogPipeline pipeline(parser);
+    pipeline.addFilter(FilterStage::custom([](const LogEntry&) -> bool {
+        throw std::logic_error("filter failed");
+    }));
+    EXPECT_THROWS(pipeline.run({path}), std::logic_error);
+    std::remove(path.c_str());
+}
+
+int main() {
+    return Testing::runAll();
+}
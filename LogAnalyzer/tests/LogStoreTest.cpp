@@ -0,0 +1,167 @@
+/*
+ * LogStoreTest.cpp
+ * LogStore 快照的测试：保存后载入的各列一致、截断或非快照文件被拒绝、损坏的单行不越界
+ */
+
+#include "TestSupport.h"
+#include "LogStore.h"
+#include "StringPool.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    using Clock = std::chrono::system_clock;
+
+    // 快照文件头中消息偏移列位置字段的字节偏移（见 LogStore.cpp 的 SnapshotHeader）
+    constexpr std::streamoff LEVEL_OFFSET_FIELD = 56;
+    constexpr std::streamoff MESSAGE_OFFSET_FIELD = 72;
+
+    LogEntry makeEntry(int second, LogLevel level, std::string_view source, std::string_view message) {
+        return LogEntry::fromStored(Clock::time_point(std::chrono::seconds(second)), level,
+                                    SourceTable::intern(source), MessageArena::current().store(message));
+    }
+
+    LogStore sampleStore(bool sorted) {
+        std::vector<LogEntry> entries = {
+            makeEntry(10, LogLevel::INFO, "api", "user alice logged in"),
+            makeEntry(11, LogLevel::ERROR, "db", "database timeout"),
+            makeEntry(12, LogLevel::DEBUG, "", ""),
+            makeEntry(13, LogLevel::FATAL, "kernel", "disk failure \xE6\x95\xB0\xE6\x8D\xAE"),
+            makeEntry(14, LogLevel::WARN, "api", "slow request"),
+        };
+        if (!sorted) {
+            std::swap(entries[1], entries[3]);
+        }
+        return LogStore::fromEntries(entries);
+    }
+
+    std::uint64_t readField(const std::string& path, std::streamoff position) {
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(position);
+        std::uint64_t value = 0;
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    }
+
+    template <typename T>
+    void patchFile(const std::string& path, std::uint64_t position, const T& value) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(position));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void expectSameRows(const LogStore& actual, const LogStore& expected) {
+        EXPECT_EQ(actual.size(), expected.size());
+        EXPECT_EQ(actual.isSorted(), expected.isSorted());
+        for (size_t i = 0; i < actual.size() && i < expected.size(); ++i) {
+            EXPECT_TRUE(actual.timestampAt(i) == expected.timestampAt(i));
+            EXPECT_TRUE(actual.levelAt(i) == expected.levelAt(i));
+            EXPECT_EQ(SourceTable::name(actual.sourceIdAt(i)), SourceTable::name(expected.sourceIdAt(i)));
+            EXPECT_EQ(actual.messageAt(i), expected.messageAt(i));
+        }
+    }
+
+} // namespace
+
+TEST_CASE(snapshotRoundTripKeepsEveryColumn) {
+    const std::string path = Testing::tempPath("roundtrip.snap");
+    LogStore original = sampleStore(true);
+    original.saveSnapshot(path);
+
+    LogStore loaded = LogStore::loadSnapshot(path);
+    EXPECT_TRUE(loaded.isSnapshot());
+    expectSameRows(loaded, original);
+    EXPECT_EQ(loaded.messageData(), original.messageData());
+
+    // 快照之上的选择与统计和自有数据上的结果一致
+    EXPECT_TRUE(loaded.countByLevel() == original.countByLevel());
+    EXPECT_TRUE(loaded.countBySource() == original.countBySource());
+    expectSameRows(loaded.select(loaded.selectByLevel(LogLevel::INFO)),
+                   original.select(original.selectByLevel(LogLevel::INFO)));
+    std::remove(path.c_str());
+}
+
+TEST_CASE(snapshotRoundTripKeepsUnsortedFlag) {
+    const std::string path = Testing::tempPath("unsorted.snap");
+    LogStore original = sampleStore(false);
+    EXPECT_TRUE(!original.isSorted());
+    original.saveSnapshot(path);
+    expectSameRows(LogStore::loadSnapshot(path), original);
+    std::remove(path.c_str());
+}
+
+TEST_CASE(emptySnapshotRoundTrips) {
+    const std::string path = Testing::tempPath("empty.snap");
+    LogStore().saveSnapshot(path);
+    LogStore loaded = LogStore::loadSnapshot(path);
+    EXPECT_EQ(loaded.size(), size_t(0));
+    EXPECT_EQ(loaded.messageData().size(), size_t(0));
+    std::remove(path.c_str());
+}
+
+TEST_CASE(truncatedSnapshotIsRejected) {
+    const std::string path = Testing::tempPath("truncated.snap");
+    sampleStore(true).saveSnapshot(path);
+    const auto fullSize = std::filesystem::file_size(path);
+    const std::string content = Testing::readFile(path);
+
+    // 文件头内、各列中间和只少最后一个字节
+    for (std::uintmax_t size : {std::uintmax_t(0), std::uintmax_t(40), fullSize / 2, fullSize - 1}) {
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(content.data(), static_cast<std::streamsize>(size));
+        }
+        EXPECT_THROWS(LogStore::loadSnapshot(path), std::runtime_error);
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE(nonSnapshotFileIsRejected) {
+    const std::string path = Testing::tempPath("plain.log");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << std::string(256, 'x');
+    }
+    EXPECT_THROWS(LogStore::loadSnapshot(path), std::runtime_error);
+    EXPECT_THROWS(LogStore::loadSnapshot(Testing::tempPath("missing.snap")), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST_CASE(corruptRowsAreContainedOnAccess) {
+    const std::string path = Testing::tempPath("corrupt.snap");
+    LogStore original = sampleStore(true);
+    original.saveSnapshot(path);
+
+    // 第 1 行的结束偏移越界，第 3 行的级别无效；载入不逐行校验，访问时不越界
+    const std::uint64_t offsetColumn = readField(path, MESSAGE_OFFSET_FIELD);
+    const std::uint64_t levelColumn = readField(path, LEVEL_OFFSET_FIELD);
+    patchFile(path, offsetColumn + 2 * sizeof(std::uint64_t), std::uint64_t(1) << 40);
+    patchFile(path, levelColumn + 3, std::uint8_t(200));
+
+    LogStore loaded = LogStore::loadSnapshot(path);
+    EXPECT_EQ(loaded.size(), original.size());
+    EXPECT_EQ(loaded.messageAt(0), original.messageAt(0));
+    EXPECT_EQ(loaded.messageAt(1), std::string_view());
+    EXPECT_EQ(loaded.messageAt(2), std::string_view());
+    EXPECT_EQ(loaded.messageAt(4), original.messageAt(4));
+
+    auto counts = loaded.countByLevel();
+    size_t counted = 0;
+    for (size_t count : counts) {
+        counted += count;
+    }
+    EXPECT_EQ(counted, original.size() - 1);
+    EXPECT_EQ(loaded.select({0, 1, 2, 3, 4}).size(), original.size());
+    std::remove(path.c_str());
+}
+
+int main() {
+    return Testing::runAll();
+}
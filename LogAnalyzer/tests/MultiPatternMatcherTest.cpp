@@ -0,0 +1,243 @@
+/*
+ * MultiPatternMatcherTest.cpp
+ * 多模式匹配器与逐签名 find 参考实现的对照测试，以及按签名统计命中行和分段读取标准输入的测试
+ * 预过滤实现在进程内只选择一次，CMake 以 LOGANALYZER_SIMD=scalar|sse2|avx2 分别再运行本测试
+ */
+
+#include "TestSupport.h"
+#include "MultiPatternMatcher.h"
+#include "LogParser.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    using Match = std::pair<size_t, size_t>;   // (结束位置, 签名编号)
+
+    // 参考实现：对每个签名逐一 std::string::find
+    std::vector<Match> referenceMatches(const std::vector<std::string>& patterns, const std::string& text) {
+        std::vector<Match> matches;
+        for (size_t id = 0; id < patterns.size(); ++id) {
+            for (size_t at = text.find(patterns[id]); at != std::string::npos; at = text.find(patterns[id], at + 1)) {
+                matches.emplace_back(at + patterns[id].size(), id);
+            }
+        }
+        std::sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+    std::vector<Match> matcherMatches(const MultiPatternMatcher& matcher, const std::string& text) {
+        std::vector<Match> matches;
+        size_t previousEnd = 0;
+        bool ordered = true;
+        matcher.scan(text, [&](size_t pattern, size_t end) {
+            ordered = ordered && end >= previousEnd;
+            previousEnd = end;
+            matches.emplace_back(end, pattern);
+        });
+        if (!ordered) {
+            Testing::reportFailure(__FILE__, __LINE__, "匹配没有按结束位置递增报告");
+        }
+        std::sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+    // 匹配结果与参考实现一致（签名编号按 getPatterns 的顺序）
+    void expectMatchesReference(const MultiPatternMatcher& matcher, const std::string& text, const std::string& label) {
+        const auto expected = referenceMatches(matcher.getPatterns(), text);
+        if (matcherMatches(matcher, text) != expected) {
+            Testing::reportFailure(__FILE__, __LINE__, "scan 与参考实现不一致: " + label);
+        }
+        if (matcher.containsAny(text) != !expected.empty()) {
+            Testing::reportFailure(__FILE__, __LINE__, "containsAny 与参考实现不一致: " + label);
+        }
+    }
+
+    // 在一段填充文本的每个偏移处放置签名，覆盖 16/32 字节向量边界两侧
+    void expectEveryOffset(const MultiPatternMatcher& matcher, const std::string& needle, char filler) {
+        for (size_t offset = 0; offset < 70; ++offset) {
+            std::string text(offset, filler);
+            text += needle;
+            text.append(40, filler);
+            expectMatchesReference(matcher, text, needle + " @" + std::to_string(offset));
+        }
+    }
+
+    std::string logLine(const std::string& message) {
+        return "2024-01-15 10:00:00 [ERROR] [svc] " + message + "\n";
+    }
+
+    // 临时替换 std::cin 的缓冲区
+    class CinRedirect {
+    private:
+        std::istringstream input_;
+        std::streambuf* previous_;
+
+    public:
+        explicit CinRedirect(const std::string& content)
+            : input_(content), previous_(std::cin.rdbuf(input_.rdbuf())) {
+            std::cin.clear();
+        }
+
+        ~CinRedirect() {
+            std::cin.rdbuf(previous_);
+            std::cin.clear();
+        }
+    };
+
+} // namespace
+
+TEST_CASE(forcedPrefilterIsSelected) {
+    const char* forced = std::getenv("LOGANALYZER_SIMD");
+    const std::string name = MultiPatternMatcher::prefilterName();
+    if (forced != nullptr && std::string(forced) == "scalar") {
+        EXPECT_EQ(name, std::string("scalar"));
+    } else if (forced != nullptr && std::string(forced) == "sse2") {
+        EXPECT_TRUE(name == "sse2" || name == "scalar");
+    }
+    EXPECT_TRUE(name == "avx2" || name == "sse2" || name == "scalar");
+}
+
+TEST_CASE(emptyAndDuplicatePatternsAreDropped) {
+    MultiPatternMatcher matcher({"error", "", "timeout", "error"});
+    EXPECT_TRUE(matcher.getPatterns() == (std::vector<std::string>{"error", "timeout"}));
+    EXPECT_TRUE(!MultiPatternMatcher({}).containsAny("anything"));
+    EXPECT_TRUE(!matcher.containsAny(""));
+}
+
+TEST_CASE(overlappingAndSuffixPatterns) {
+    // 经典 Aho-Corasick 用例：后缀（he/she/hers）、彼此重叠以及单字节签名
+    MultiPatternMatcher matcher({"he", "she", "his", "hers", "s", "e", "ushers"});
+    expectMatchesReference(matcher, "ushers", "ushers");
+    expectMatchesReference(matcher, "shehishershe", "shehishershe");
+    expectMatchesReference(matcher, "hhhhssseeee", "runs");
+
+    // 自身重叠的签名：aaa 在 aaaaa 中出现三次
+    MultiPatternMatcher repeated({"aaa", "aa", "ab", "b"});
+    expectMatchesReference(repeated, "aaaaabaaab", "aaaaabaaab");
+
+    // 大小写敏感
+    EXPECT_TRUE(!MultiPatternMatcher({"Error"}).containsAny("error ERROR"));
+}
+
+TEST_CASE(matchesAcrossVectorBoundaries) {
+    // 单个首字节（memchr）、不超过 SSE2 比较上限的首字节、更多首字节（nibble 查表）、非 ASCII 首字节
+    const std::vector<std::vector<std::string>> patternSets = {
+        {"timeout", "tick"},
+        {"timeout", "refused", "denied", "panic"},
+        {"timeout", "refused", "denied", "panic", "oom", "segfault", "Killed", "abort"},
+        {"\xE8\xB6\x85\xE6\x97\xB6", "timeout", "refused"},
+    };
+    for (const auto& patterns : patternSets) {
+        MultiPatternMatcher matcher(patterns);
+        for (const auto& needle : patterns) {
+            expectEveryOffset(matcher, needle, '.');
+            // 填充字节与首字节相同，预过滤每次都命中但自动机需要回退
+            expectEveryOffset(matcher, needle, needle[0]);
+        }
+    }
+}
+
+TEST_CASE(randomTextMatchesReference) {
+    // 小字母表让签名频繁部分匹配、相互重叠
+    std::mt19937 rng(12);
+    const std::string alphabet = "abcd\n\xC3";
+    const std::vector<std::string> patterns = {"ab", "abc", "bca", "cab", "dd", "a\nb", "\xC3" "a", "bcd", "d"};
+    MultiPatternMatcher matcher(patterns);
+
+    for (int round = 0; round < 200; ++round) {
+        std::string text(static_cast<size_t>(rng() % 300), ' ');
+        for (auto& c : text) {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        expectMatchesReference(matcher, text, "round " + std::to_string(round));
+    }
+}
+
+TEST_CASE(hitCountsArePerLineAndPerSignature) {
+    MessageArena arena;
+    MessageArena::Scope scope(arena);
+    const std::vector<std::string> patterns = {"timeout", "refused", "db"};
+    MultiPatternMatcher matcher(patterns);
+
+    const std::string buffer =
+        logLine("db timeout timeout") +          // 同一签名在一行内出现两次只计一次
+        logLine("connection refused by db") +
+        logLine("nothing to see") +
+        "garbage line with timeout\n" +          // 无法解析的行不计入
+        logLine("timeout");                      // 最后一行没有换行
+    const std::string input = buffer.substr(0, buffer.size() - 1);
+
+    LogParser parser;
+    std::vector<size_t> hitCounts;
+    auto entries = parser.parseBufferMatching(input, matcher, hitCounts);
+    EXPECT_EQ(entries.size(), size_t(3));
+    EXPECT_TRUE(hitCounts == (std::vector<size_t>{2, 1, 2}));
+
+    // 过滤器拒绝的行不计入命中
+    std::vector<size_t> filteredCounts;
+    auto filtered = parser.parseBufferMatching(input, matcher, filteredCounts, [](const LogEntry& entry) {
+        return entry.getMessage().find("refused") == std::string_view::npos;
+    });
+    EXPECT_EQ(filtered.size(), size_t(2));
+    EXPECT_TRUE(filteredCounts == (std::vector<size_t>{2, 0, 1}));
+}
+
+TEST_CASE(pipedInputMatchesAcrossChunkBoundaries) {
+    MessageArena arena;
+    MessageArena::Scope scope(arena);
+    MultiPatternMatcher matcher({"needle", "boundary-signature"});
+
+    // 输入按 1 MiB 分段读取：让签名正好跨越段边界，并放入一行比一段还长的日志
+    const size_t chunk = size_t(1) << 20;
+    std::string content;
+    size_t serial = 0;
+    auto addFiller = [&](size_t until) {
+        while (content.size() + 80 < until) {
+            ++serial;
+            content += logLine("filler " + std::to_string(serial) + (serial % 97 == 0 ? " needle" : ""));
+        }
+    };
+    addFiller(chunk - 200);
+    std::string straddling = "2024-01-15 10:00:00 [ERROR] [svc] ";
+    straddling.append(chunk - 8 - content.size() - straddling.size(), 'x');
+    content += straddling + " boundary-signature tail\n";
+    content += logLine("long " + std::string(chunk + chunk / 2, 'y') + " needle at the end");
+    addFiller(3 * chunk + 500);
+    content += logLine("last needle without newline");
+    content.pop_back();
+
+    LogParser parser;
+    std::vector<size_t> expectedCounts;
+    auto expected = parser.parseBufferMatching(content, matcher, expectedCounts);
+
+    std::vector<size_t> pipedCounts;
+    std::vector<LogEntry> piped;
+    {
+        CinRedirect redirect(content);
+        piped = parser.parseFileMatching("-", matcher, pipedCounts);
+    }
+
+    EXPECT_EQ(piped.size(), expected.size());
+    EXPECT_TRUE(pipedCounts == expectedCounts);
+    EXPECT_EQ(expectedCounts[1], size_t(1));
+    for (size_t i = 0; i < piped.size() && i < expected.size(); ++i) {
+        if (piped[i].getMessage() != expected[i].getMessage()) {
+            Testing::reportFailure(__FILE__, __LINE__, "分段读取的第 " + std::to_string(i) + " 条结果不同");
+            break;
+        }
+    }
+}
+
+int main() {
+    return Testing::runAll();
+}
@@ -0,0 +1,105 @@
+/*
+ * ReportWriterTest.cpp
+ * ReportWriter 的转义测试：JSON 的引号、控制字节和无效 UTF-8，CSV 的引号和换行，HTML 的特殊字符
+ */
+
+#include "TestSupport.h"
+#include "ReportWriter.h"
+#include "StringPool.h"
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    // 生成只含一条日志的报告，返回报告全文
+    std::string renderReport(ReportFormat format, std::string_view message, std::string_view source = "svc") {
+        const std::string path = Testing::tempPath("report");
+        {
+            ReportWriter report(format, path, {"test.log"});
+            report.begin();
+            report.writeEntry(0, LogLevel::ERROR, SourceTable::intern(source), message);
+            report.finish(nullptr, 0);
+        }
+        std::string content = Testing::readFile(path);
+        std::remove(path.c_str());
+        return content;
+    }
+
+    bool contains(const std::string& text, std::string_view part) {
+        return text.find(part) != std::string::npos;
+    }
+
+} // namespace
+
+TEST_CASE(jsonEscapesQuotesAndBackslashes) {
+    std::string report = renderReport(ReportFormat::JSON, "say \"hi\" to C:\\tmp");
+    EXPECT_TRUE(contains(report, "\"message\":\"say \\\"hi\\\" to C:\\\\tmp\""));
+}
+
+TEST_CASE(jsonEscapesControlBytes) {
+    std::string report = renderReport(ReportFormat::JSON, std::string_view("a\nb\tc\r\x01\x1f\b\f\x7f", 11));
+    EXPECT_TRUE(contains(report, "\"message\":\"a\\nb\\tc\\r\\u0001\\u001f\\b\\f\x7f\""));
+}
+
+TEST_CASE(jsonKeepsValidUtf8) {
+    std::string report = renderReport(ReportFormat::JSON, "数据库超时 \xF0\x9F\x94\xA5");
+    EXPECT_TRUE(contains(report, "\"message\":\"数据库超时 \xF0\x9F\x94\xA5\""));
+}
+
+TEST_CASE(jsonReplacesInvalidUtf8) {
+    // 孤立的续字节、超长编码、代理项、超出 U+10FFFF 和截断的多字节字符，每个无效字节替换一次
+    std::string report = renderReport(ReportFormat::JSON, "a\x80" "b\xC0\xAF" "c\xED\xA0\x80" "d\xF4\x90\x80\x80" "e\xE4\xB8");
+    EXPECT_TRUE(contains(report,
+        "\"message\":\"a\\ufffdb\\ufffd\\ufffdc\\ufffd\\ufffd\\ufffdd\\ufffd\\ufffd\\ufffd\\ufffde\\ufffd\\ufffd\""));
+}
+
+TEST_CASE(jsonEscapesSourceNames) {
+    std::string report = renderReport(ReportFormat::JSON, "ok", "svc\"x");
+    EXPECT_TRUE(contains(report, "\"source\":\"svc\\\"x\""));
+}
+
+TEST_CASE(csvLeavesPlainFieldsUnquoted) {
+    std::string report = renderReport(ReportFormat::CSV, "plain message");
+    EXPECT_TRUE(contains(report, ",ERROR,svc,plain message\r\n"));
+}
+
+TEST_CASE(csvQuotesCommasAndDoublesQuotes) {
+    std::string report = renderReport(ReportFormat::CSV, "a,\"b\"");
+    EXPECT_TRUE(contains(report, ",ERROR,svc,\"a,\"\"b\"\"\"\r\n"));
+}
+
+TEST_CASE(csvQuotesLineBreaks) {
+    std::string report = renderReport(ReportFormat::CSV, "first\r\nsecond\nthird");
+    EXPECT_TRUE(contains(report, ",ERROR,svc,\"first\r\nsecond\nthird\"\r\n"));
+
+    std::string bareReturn = renderReport(ReportFormat::CSV, "a\rb");
+    EXPECT_TRUE(contains(bareReturn, ",\"a\rb\"\r\n"));
+}
+
+TEST_CASE(csvHasHeaderAndNoSummary) {
+    std::string report = renderReport(ReportFormat::CSV, "x");
+    EXPECT_EQ(report.rfind("timestamp,level,source,message\r\n", 0), size_t(0));
+    EXPECT_TRUE(!contains(report, "summary"));
+}
+
+TEST_CASE(htmlEscapesMarkup) {
+    std::string report = renderReport(ReportFormat::HTML, "<script>alert('x & \"y\"')</script>");
+    EXPECT_TRUE(contains(report, "&lt;script&gt;alert(&#39;x &amp; &quot;y&quot;&#39;)&lt;/script&gt;"));
+    EXPECT_TRUE(!contains(report, "<script>"));
+}
+
+TEST_CASE(parseFormatIgnoresCase) {
+    ReportFormat format = ReportFormat::JSON;
+    EXPECT_TRUE(ReportWriter::parseFormat("CSV", format));
+    EXPECT_TRUE(format == ReportFormat::CSV);
+    EXPECT_TRUE(ReportWriter::parseFormat("html", format));
+    EXPECT_TRUE(format == ReportFormat::HTML);
+    EXPECT_TRUE(!ReportWriter::parseFormat("xml", format));
+}
+
+int main() {
+    return Testing::runAll();
+}
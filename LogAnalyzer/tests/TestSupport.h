@@ -0,0 +1,144 @@
+/*
+ * TestSupport.h
+ * 单元测试的最小框架：登记测试用例、检查断言并汇总结果，不依赖第三方库
+ */
+
+#pragma once
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+namespace LogAnalyzer {
+
+    namespace Testing {
+
+        /**
+         * 一个测试用例
+         */
+        struct TestCase {
+            const char* name;
+            std::function<void()> body;
+        };
+
+        inline std::vector<TestCase>& registry() {
+            static std::vector<TestCase> cases;
+            return cases;
+        }
+
+        inline int& failureCount() {
+            static int failures = 0;
+            return failures;
+        }
+
+        /**
+         * 静态对象构造时把测试用例登记到 registry()
+         */
+        struct Registrar {
+            Registrar(const char* name, std::function<void()> body) {
+                registry().push_back(TestCase{name, std::move(body)});
+            }
+        };
+
+        inline void reportFailure(const char* file, int line, const std::string& message) {
+            std::cerr << file << ":" << line << ": 失败: " << message << "\n";
+            ++failureCount();
+        }
+
+        template <typename Actual, typename Expected>
+        void expectEqual(const Actual& actual, const Expected& expected, const char* text, const char* file, int line) {
+            if (!(actual == expected)) {
+                std::ostringstream oss;
+                oss << text << "\n  实际值: " << actual << "\n  期望值: " << expected;
+                reportFailure(file, line, oss.str());
+            }
+        }
+
+        /**
+         * 临时文件路径（按进程号和名称区分，调用方负责删除）
+         * @param name 文件名
+         */
+        inline std::string tempPath(const std::string& name) {
+            return (std::filesystem::temp_directory_path() /
+                    ("loganalyzer_test_" + std::to_string(::getpid()) + "_" + name)).string();
+        }
+
+        /**
+         * 读取整个文件
+         * @param path 文件路径
+         */
+        inline std::string readFile(const std::string& path) {
+            std::ifstream file(path, std::ios::binary);
+            std::ostringstream oss;
+            oss << file.rdbuf();
+            return oss.str();
+        }
+
+        /**
+         * 写入文件
+         * @param path 文件路径
+         * @param content 文件内容
+         * @param append 是否追加到文件末尾（否则覆盖，保留 inode）
+         */
+        inline void writeFile(const std::string& path, const std::string& content, bool append = false) {
+            std::ofstream file(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+            file << content;
+        }
+
+        /**
+         * 依次运行全部测试用例，用例内未捕获的异常记为失败
+         * @return 进程退出码：全部通过为 0，否则为 1
+         */
+        inline int runAll() {
+            for (const auto& test : registry()) {
+                int before = failureCount();
+                try {
+                    test.body();
+                } catch (const std::exception& e) {
+                    reportFailure(test.name, 0, std::string("未捕获的异常: ") + e.what());
+                }
+                std::cout << (failureCount() == before ? "[通过] " : "[失败] ") << test.name << "\n";
+            }
+            std::cout << registry().size() << " 个用例，" << failureCount() << " 处失败\n";
+            return failureCount() == 0 ? 0 : 1;
+        }
+
+    } // namespace Testing
+
+} // namespace LogAnalyzer
+
+// 定义并登记一个测试用例
+#define TEST_CASE(name) \
+    static void name(); \
+    static const ::LogAnalyzer::Testing::Registrar name##Registrar(#name, name); \
+    static void name()
+
+#define EXPECT_TRUE(condition) \
+    do { \
+        if (!(condition)) { \
+            ::LogAnalyzer::Testing::reportFailure(__FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+#define EXPECT_EQ(actual, expected) \
+    ::LogAnalyzer::Testing::expectEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+#define EXPECT_THROWS(statement, ExceptionType) \
+    do { \
+        bool thrown = false; \
+        try { \
+            statement; \
+        } catch (const ExceptionType&) { \
+            thrown = true; \
+        } \
+        if (!thrown) { \
+            ::LogAnalyzer::Testing::reportFailure(__FILE__, __LINE__, #statement " 没有抛出 " #ExceptionType); \
+        } \
+    } while (0)
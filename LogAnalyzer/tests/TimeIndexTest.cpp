@@ -0,0 +1,196 @@
+/*
+ * TimeIndexTest.cpp
+ * TimeIndex 的测试：时间范围到字节区间的换算、时间倒退时的退化，
+ * 以及旁路索引随日志文件变化的复用、增量扩展和重建
+ */
+
+#include "TestSupport.h"
+#include "TimeIndex.h"
+#include "LogParser.h"
+#include <cstdio>
+#include <limits>
+#include <string>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    // 每行落在不同的 60 秒时间桶
+    std::string minuteLine(int minute) {
+        char line[64];
+        std::snprintf(line, sizeof(line), "2024-01-15 10:%02d:00 [INFO] [svc] request handled\n", minute);
+        return line;
+    }
+
+    std::string minuteLines(int firstMinute, int count) {
+        std::string text;
+        for (int minute = firstMinute; minute < firstMinute + count; ++minute) {
+            text += minuteLine(minute);
+        }
+        return text;
+    }
+
+    // 用同一个解析器换算第 minute 分钟的时间点，与索引使用的时区规则一致
+    TimeIndex::TimePoint minuteTime(int minute) {
+        const std::string line = minuteLine(minute);
+        LogParser parser;
+        LogEntry entry;
+        parser.parseLine(std::string_view(line).substr(0, line.size() - 1), entry);
+        return entry.getTimestamp();
+    }
+
+    /**
+     * 加载或建立索引
+     * @param scannedLines 输出本次扫描的行数（0 表示直接使用了磁盘上的索引）
+     */
+    TimeIndex loadIndex(const std::string& path, size_t& scannedLines) {
+        LogParser parser;
+        TimeIndex index = TimeIndex::loadOrBuild(path, parser);
+        scannedLines = parser.getTotalLines();
+        return index;
+    }
+
+    void removeAll(const std::string& path) {
+        std::remove(path.c_str());
+        std::remove(TimeIndex::indexPath(path).c_str());
+    }
+
+} // namespace
+
+TEST_CASE(byteRangeCoversQueriedBuckets) {
+    const std::string path = Testing::tempPath("time_range.log");
+    Testing::writeFile(path, minuteLines(0, 10));
+    size_t scanned = 0;
+    TimeIndex index = loadIndex(path, scanned);
+    EXPECT_EQ(index.bucketCount(), size_t(10));
+    EXPECT_TRUE(index.isSorted());
+
+    const std::uint64_t toEof = std::numeric_limits<std::uint64_t>::max();
+    auto range = index.byteRange(minuteTime(3), minuteTime(5));
+    EXPECT_EQ(range.first, std::uint64_t(minuteLines(0, 3).size()));
+    EXPECT_EQ(range.second, std::uint64_t(minuteLines(0, 5).size()));
+
+    // 桶内的起点退到桶首行，不足一桶的终点进到下一个桶
+    range = index.byteRange(minuteTime(3) + std::chrono::seconds(30), minuteTime(5) + std::chrono::seconds(1));
+    EXPECT_EQ(range.first, std::uint64_t(minuteLines(0, 3).size()));
+    EXPECT_EQ(range.second, std::uint64_t(minuteLines(0, 6).size()));
+
+    // 早于第一个桶从文件开头开始，晚于最后一个桶读到文件末尾
+    EXPECT_EQ(index.byteRange(minuteTime(0) - std::chrono::hours(1), minuteTime(1)).first, std::uint64_t(0));
+    EXPECT_EQ(index.byteRange(minuteTime(8), minuteTime(40)).second, toEof);
+    range = index.byteRange(minuteTime(20), minuteTime(30));
+    EXPECT_EQ(range.first, std::uint64_t(minuteLines(0, 9).size()));
+    removeAll(path);
+}
+
+TEST_CASE(backwardsTimeFallsBackToFullScan) {
+    const std::string path = Testing::tempPath("time_unsorted.log");
+    Testing::writeFile(path, minuteLines(0, 5) + minuteLine(1) + minuteLines(5, 3));
+    size_t scanned = 0;
+    TimeIndex index = loadIndex(path, scanned);
+    EXPECT_TRUE(!index.isSorted());
+
+    auto range = index.byteRange(minuteTime(1), minuteTime(2));
+    EXPECT_EQ(range.first, std::uint64_t(0));
+    EXPECT_EQ(range.second, std::numeric_limits<std::uint64_t>::max());
+
+    // 无序标记随索引一起保存
+    EXPECT_TRUE(!loadIndex(path, scanned).isSorted());
+    EXPECT_EQ(scanned, size_t(0));
+    removeAll(path);
+}
+
+TEST_CASE(appendExtendsIndex) {
+    const std::string path = Testing::tempPath("time_append.log");
+    Testing::writeFile(path, minuteLines(0, 10));
+    size_t scanned = 0;
+    loadIndex(path, scanned);
+    EXPECT_EQ(scanned, size_t(10));
+
+    TimeIndex reused = loadIndex(path, scanned);
+    EXPECT_EQ(scanned, size_t(0));
+    EXPECT_EQ(reused.bucketCount(), size_t(10));
+
+    Testing::writeFile(path, minuteLines(10, 5), true);
+    TimeIndex extended = loadIndex(path, scanned);
+    EXPECT_EQ(scanned, size_t(5));
+    EXPECT_EQ(extended.bucketCount(), size_t(15));
+    EXPECT_EQ(extended.indexedBytes(), std::uint64_t(minuteLines(0, 15).size()));
+    EXPECT_EQ(extended.byteRange(minuteTime(12), minuteTime(13)).first,
+              std::uint64_t(minuteLines(0, 12).size()));
+    removeAll(path);
+}
+
+TEST_CASE(truncateOrRewriteRebuildsIndex) {
+    const std::string path = Testing::tempPath("time_rewrite.log");
+    Testing::writeFile(path, minuteLines(0, 10));
+    size_t scanned = 0;
+    loadIndex(path, scanned);
+
+    // 截断为更短的内容：旧的偏移全部失效
+    Testing::writeFile(path, minuteLines(0, 4));
+    TimeIndex truncated = loadIndex(path, scanned);
+    EXPECT_EQ(scanned, size_t(4));
+    EXPECT_EQ(truncated.bucketCount(), size_t(4));
+    EXPECT_EQ(truncated.indexedBytes(), std::uint64_t(minuteLines(0, 4).size()));
+
+    // 开头被改写、长度变长：不能当作追加处理
+    Testing::writeFile(path, minuteLines(30, 7));
+    TimeIndex rebuilt = loadIndex(path, scanned);
+    EXPECT_EQ(scanned, size_t(7));
+    EXPECT_EQ(rebuilt.bucketCount(), size_t(7));
+    EXPECT_EQ(rebuilt.byteRange(minuteTime(31), minuteTime(32)).first, std::uint64_t(minuteLine(30).size()));
+    removeAll(path);
+}
+
+TEST_CASE(corruptBucketTableIsRebuilt) {
+    const std::string path = Testing::tempPath("time_corrupt.log");
+    const std::string indexPath = TimeIndex::indexPath(path);
+    Testing::writeFile(path, minuteLines(0, 8));
+    size_t scanned = 0;
+    loadIndex(path, scanned);
+    const std::string valid = Testing::readFile(indexPath);
+
+    // 桶数量字段（偏移 65）远超文件剩余内容
+    std::string hugeCount = valid;
+    const std::uint64_t count = std::uint64_t(1) << 60;
+    hugeCount.replace(65, sizeof(count), reinterpret_cast<const char*>(&count), sizeof(count));
+
+    for (const std::string& corrupt : {hugeCount, valid.substr(0, valid.size() - 5),
+                                       valid.substr(0, 30), std::string("garbage")}) {
+        Testing::writeFile(indexPath, corrupt);
+        TimeIndex rebuilt = loadIndex(path, scanned);
+        EXPECT_EQ(scanned, size_t(8));
+        EXPECT_EQ(rebuilt.bucketCount(), size_t(8));
+
+        // 重建后写回了有效的索引
+        loadIndex(path, scanned);
+        EXPECT_EQ(scanned, size_t(0));
+    }
+    removeAll(path);
+}
+
+TEST_CASE(trailingPartialLineWaitsForNewline) {
+    const std::string path = Testing::tempPath("time_partial.log");
+    const std::string complete = minuteLines(0, 5);
+    const std::string partial = minuteLine(5);
+    Testing::writeFile(path, complete + partial.substr(0, 20));
+
+    size_t scanned = 0;
+    TimeIndex index = loadIndex(path, scanned);
+    EXPECT_EQ(scanned, size_t(5));
+    EXPECT_EQ(index.bucketCount(), size_t(5));
+    EXPECT_EQ(index.indexedBytes(), std::uint64_t(complete.size()));
+
+    // 半行写完后从该行开头继续扫描
+    Testing::writeFile(path, partial.substr(20), true);
+    TimeIndex extended = loadIndex(path, scanned);
+    EXPECT_EQ(scanned, size_t(1));
+    EXPECT_EQ(extended.bucketCount(), size_t(6));
+    EXPECT_EQ(extended.byteRange(minuteTime(5), minuteTime(6)).first, std::uint64_t(complete.size()));
+    removeAll(path);
+}
+
+int main() {
+    return Testing::runAll();
+}
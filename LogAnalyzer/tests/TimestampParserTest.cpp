@@ -0,0 +1,179 @@
+/*
+ * TimestampParserTest.cpp
+ * TimestampParser 的测试：小数秒、同秒缓存的命中与失效、syslog 年份、夏令时切换前后的本地时间
+ */
+
+#include "TestSupport.h"
+#include "TimestampParser.h"
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+
+using namespace LogAnalyzer;
+
+namespace {
+
+    using TimePoint = TimestampParser::TimePoint;
+
+    // 美国东部时区的 POSIX 规则：3 月第二个周日 02:00 进入夏令时，11 月第一个周日 02:00 退出
+    const char* const EASTERN_TZ = "EST5EDT,M3.2.0,M11.1.0";
+
+    void useTimeZone(const char* zone) {
+        ::setenv("TZ", zone, 1);
+        ::tzset();
+    }
+
+    std::int64_t utcSeconds(std::int64_t year, unsigned month, unsigned day,
+                            unsigned hour, unsigned minute, unsigned second) {
+        return TimestampParser::daysFromCivil(year, month, day) * 86400 +
+               hour * 3600 + minute * 60 + second;
+    }
+
+    // 纪元以来的毫秒数，解析失败时返回 -1
+    std::int64_t parseMillis(TimestampParser& parser, const std::string& text) {
+        TimePoint result;
+        if (!parser.parse(text, result)) {
+            return -1;
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(result.time_since_epoch()).count();
+    }
+
+    std::int64_t parseMillis(const std::string& text) {
+        TimestampParser parser;
+        return parseMillis(parser, text);
+    }
+
+} // namespace
+
+TEST_CASE(daysFromCivilMatchesKnownDates) {
+    EXPECT_EQ(TimestampParser::daysFromCivil(1970, 1, 1), std::int64_t(0));
+    EXPECT_EQ(TimestampParser::daysFromCivil(2000, 3, 1), std::int64_t(11017));
+    EXPECT_EQ(TimestampParser::daysFromCivil(2024, 2, 29), std::int64_t(19782));
+    EXPECT_EQ(TimestampParser::daysFromCivil(1900, 1, 1), std::int64_t(-25567));
+}
+
+TEST_CASE(commaAndDotFractionsKeepMilliseconds) {
+    useTimeZone("UTC0");
+    const std::int64_t base = utcSeconds(2024, 1, 15, 14, 30, 45) * 1000;
+
+    EXPECT_EQ(parseMillis("2024-01-15 14:30:45"), base);
+    EXPECT_EQ(parseMillis("2024-01-15 14:30:45,123"), base + 123);
+    EXPECT_EQ(parseMillis("2024-01-15 14:30:45.123"), base + 123);
+    EXPECT_EQ(parseMillis("2024-01-15T14:30:45.123"), base + 123);
+    EXPECT_EQ(parseMillis("2024-01-15T14:30:45.123Z"), base + 123);
+    EXPECT_EQ(parseMillis("2024-01-15T14:30:45Z"), base);
+
+    // 位数不足按小数补齐，超过纳秒精度的位被截断
+    EXPECT_EQ(parseMillis("2024-01-15 14:30:45,5"), base + 500);
+    EXPECT_EQ(parseMillis("2024-01-15 14:30:45.0451"), base + 45);
+    EXPECT_EQ(parseMillis("2024-01-15 14:30:45.999999999999"), base + 999);
+
+    TimestampParser parser;
+    TimePoint result;
+    EXPECT_TRUE(parser.parse("2024-01-15 14:30:45.000000007", result));
+    EXPECT_EQ(result.time_since_epoch().count() % 1000000000, static_cast<TimePoint::rep>(7));
+}
+
+TEST_CASE(invalidFieldsAreRejected) {
+    useTimeZone("UTC0");
+    for (const char* text : {"", "2024-13-15 14:30:45", "2024-01-32 14:30:45", "2024-01-15 24:30:45",
+                             "2024-01-15 14:60:45", "2024-01-15 14:30:61", "Foo 15 14:30:45",
+                             "not a timestamp"}) {
+        EXPECT_EQ(parseMillis(text), std::int64_t(-1));
+    }
+}
+
+TEST_CASE(sameSecondCacheHitsAndMisses) {
+    useTimeZone(EASTERN_TZ);
+    TimestampParser cached;
+
+    // 同一秒内只有小数不同（命中），换秒、换格式、回到旧秒（失效后重新换算）
+    const std::vector<std::string> sequence = {
+        "2024-07-04 12:00:00,100",
+        "2024-07-04 12:00:00,200",
+        "2024-07-04 12:00:00.300",
+        "2024-07-04 12:00:00",
+        "2024-07-04 12:00:01,100",
+        "2024-07-04T12:00:01.100Z",
+        "2024-07-04 12:00:00,900",
+        "2024-01-04 12:00:00,900",
+        "Jul  4 12:00:00",
+        "Jul 4 12:00:00",
+        "Jul 14 12:00:00",
+        "2024-07-04 12:00:00,xyz",
+        "2024-07-04 12:00:00,250",
+    };
+    for (const auto& text : sequence) {
+        EXPECT_EQ(parseMillis(cached, text), parseMillis(text));
+    }
+
+    const std::int64_t first = parseMillis(cached, "2024-07-04 12:00:00,100");
+    EXPECT_EQ(parseMillis(cached, "2024-07-04 12:00:00,600") - first, std::int64_t(500));
+    EXPECT_EQ(parseMillis(cached, "2024-07-04 12:00:01,100") - first, std::int64_t(1000));
+}
+
+TEST_CASE(syslogTimestampsUseYear1900) {
+    useTimeZone("UTC0");
+    const std::int64_t expected = utcSeconds(1900, 1, 5, 8, 9, 10) * 1000;
+    EXPECT_EQ(parseMillis("Jan 5 08:09:10"), expected);
+    EXPECT_EQ(parseMillis("Jan 05 08:09:10"), expected);
+    EXPECT_EQ(parseMillis("Dec 31 23:59:59"), utcSeconds(1900, 12, 31, 23, 59, 59) * 1000);
+
+    // 1900 年不是闰年：2 月 29 日落到 3 月 1 日，与 std::get_time 的结果一致
+    EXPECT_EQ(parseMillis("Feb 29 00:00:00"), utcSeconds(1900, 3, 1, 0, 0, 0) * 1000);
+    EXPECT_EQ(parseMillis("1900-01-05 08:09:10"), expected);
+}
+
+TEST_CASE(localTimeFollowsDaylightSaving) {
+    useTimeZone(EASTERN_TZ);
+    TimestampParser parser;
+
+    // 冬令时 UTC-5，夏令时 UTC-4
+    EXPECT_EQ(parseMillis(parser, "2024-01-15 12:00:00"), utcSeconds(2024, 1, 15, 17, 0, 0) * 1000);
+    EXPECT_EQ(parseMillis(parser, "2024-07-15 12:00:00"), utcSeconds(2024, 7, 15, 16, 0, 0) * 1000);
+
+    // 与 mktime(tm_isdst = -1) 对照
+    for (int month = 1; month <= 12; ++month) {
+        std::tm tm = {};
+        tm.tm_year = 2024 - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = 20;
+        tm.tm_hour = 9;
+        tm.tm_isdst = -1;
+        const std::int64_t expected = static_cast<std::int64_t>(std::mktime(&tm)) * 1000;
+        const std::string text = "2024-" + std::string(month < 10 ? "0" : "") + std::to_string(month) +
+                                 "-20 09:00:00";
+        EXPECT_EQ(parseMillis(parser, text), expected);
+    }
+}
+
+TEST_CASE(dstTransitionHours) {
+    useTimeZone(EASTERN_TZ);
+    TimestampParser parser;
+
+    // 2024-03-10 02:00 EST 跳到 03:00 EDT：切换前后的时间都对，中间不存在的一小时落在两种解释之一
+    EXPECT_EQ(parseMillis(parser, "2024-03-10 01:59:59"), utcSeconds(2024, 3, 10, 6, 59, 59) * 1000);
+    EXPECT_EQ(parseMillis(parser, "2024-03-10 03:00:00"), utcSeconds(2024, 3, 10, 7, 0, 0) * 1000);
+    EXPECT_EQ(parseMillis(parser, "2024-03-10 03:30:00,250"), utcSeconds(2024, 3, 10, 7, 30, 0) * 1000 + 250);
+    const std::int64_t gap = parseMillis(parser, "2024-03-10 02:30:00");
+    EXPECT_TRUE(gap == utcSeconds(2024, 3, 10, 6, 30, 0) * 1000 ||
+                gap == utcSeconds(2024, 3, 10, 7, 30, 0) * 1000);
+
+    // 2024-11-03 02:00 EDT 退回 01:00 EST：01:xx 出现两次，结果是两种解释之一
+    EXPECT_EQ(parseMillis(parser, "2024-11-03 00:59:59"), utcSeconds(2024, 11, 3, 4, 59, 59) * 1000);
+    EXPECT_EQ(parseMillis(parser, "2024-11-03 02:00:00"), utcSeconds(2024, 11, 3, 7, 0, 0) * 1000);
+    const std::int64_t repeated = parseMillis(parser, "2024-11-03 01:30:00");
+    EXPECT_TRUE(repeated == utcSeconds(2024, 11, 3, 5, 30, 0) * 1000 ||
+                repeated == utcSeconds(2024, 11, 3, 6, 30, 0) * 1000);
+
+    // 按小时缓存的偏移不会带到切换后的小时
+    EXPECT_EQ(parseMillis(parser, "2024-03-10 01:00:00"), parseMillis("2024-03-10 01:00:00"));
+    EXPECT_EQ(parseMillis(parser, "2024-03-10 03:00:01"), parseMillis("2024-03-10 03:00:01"));
+    EXPECT_EQ(parseMillis(parser, "2024-11-03 00:30:00"), parseMillis("2024-11-03 00:30:00"));
+    EXPECT_EQ(parseMillis(parser, "2024-11-03 02:30:00"), parseMillis("2024-11-03 02:30:00"));
+}
+
+int main() {
+    return Testing::runAll();
+}